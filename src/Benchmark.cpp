@@ -0,0 +1,386 @@
+#include <pddl_planner/Benchmark.hpp>
+#include <base/logging.h>
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace fs = boost::filesystem;
+
+namespace pddl_planner
+{
+
+namespace
+{
+    const std::string msPddlExtension = ".pddl";
+
+    std::string readFile(const std::string& filename)
+    {
+        std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+        if(!file)
+        {
+            throw PlanGenerationException("Benchmark: failed to read '" + filename + "'");
+        }
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    bool isDomainFile(const std::string& filename)
+    {
+        return filename == "domain" + msPddlExtension
+            || boost::algorithm::ends_with(filename, "-domain" + msPddlExtension)
+            || boost::algorithm::starts_with(filename, "domain_");
+    }
+
+    /**
+     * Records the time of the first plan of a planning call
+     */
+    struct FirstPlanTimer
+    {
+        FirstPlanTimer()
+            : start(boost::chrono::steady_clock::now())
+            , timeToFirstPlan(-1.0)
+        {}
+
+        void received(const PlannerName&, const Plan&)
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            if(timeToFirstPlan < 0)
+            {
+                timeToFirstPlan = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+            }
+        }
+
+        boost::chrono::steady_clock::time_point start;
+        boost::mutex mutex;
+        double timeToFirstPlan;
+    };
+
+    double median(std::vector<double> values)
+    {
+        if(values.empty())
+        {
+            return -1.0;
+        }
+        std::sort(values.begin(), values.end());
+        size_t middle = values.size() / 2;
+        return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+    }
+
+    std::string escapeJSON(const std::string& text)
+    {
+        std::string escaped;
+        std::string::const_iterator it = text.begin();
+        for(; it != text.end(); ++it)
+        {
+            switch(*it)
+            {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                case '\t': escaped += "\\t"; break;
+                default:
+                    if((unsigned char) *it < 0x20)
+                    {
+                        std::stringstream ss;
+                        ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int) *it;
+                        escaped += ss.str();
+                    } else {
+                        escaped += *it;
+                    }
+            }
+        }
+        return escaped;
+    }
+
+    std::string escapeCSV(const std::string& text)
+    {
+        if(text.find_first_of(",\"\n") == std::string::npos)
+        {
+            return text;
+        }
+        return "\"" + boost::algorithm::replace_all_copy(text, "\"", "\"\"") + "\"";
+    }
+}
+
+Benchmark::Benchmark(const std::set<std::string>& planners, double timeout, size_t repetitions)
+    : mPlanners(planners)
+    , mTimeout(timeout)
+    , mRepetitions(std::max(repetitions, (size_t) 1))
+{
+    mModes.push_back(PlanningOptions::SEQUENTIAL);
+    mModes.push_back(PlanningOptions::PARALLEL);
+    mModes.push_back(PlanningOptions::FIRST_WINS);
+}
+
+std::vector<BenchmarkInstance> Benchmark::findInstances(const std::string& directory)
+{
+    std::vector<BenchmarkInstance> instances;
+    fs::path corpus(directory);
+    try {
+        fs::recursive_directory_iterator it(corpus);
+        for(; it != fs::recursive_directory_iterator(); ++it)
+        {
+            fs::path file = it->path();
+            std::string filename = file.filename().string();
+            if(!fs::is_regular_file(file) || file.extension() != msPddlExtension || isDomainFile(filename))
+            {
+                continue;
+            }
+
+            std::string stem = file.stem().string();
+            fs::path domain = file.parent_path() / (stem + "-domain" + msPddlExtension);
+            if(!fs::exists(domain))
+            {
+                domain = file.parent_path() / ("domain_" + filename);
+            }
+            if(!fs::exists(domain))
+            {
+                domain = file.parent_path() / ("domain" + msPddlExtension);
+            }
+            if(!fs::exists(domain))
+            {
+                LOG_WARN("Benchmark: skipping '%s', which has no domain file", file.string().c_str());
+                continue;
+            }
+
+            std::string name = file.string().substr(corpus.string().size());
+            boost::algorithm::trim_left_if(name, boost::algorithm::is_any_of("/"));
+            instances.push_back(BenchmarkInstance(name, domain.string(), file.string()));
+        }
+    } catch(const fs::filesystem_error& e)
+    {
+        throw PlanGenerationException("Benchmark: failed to read corpus '" + directory + "': " + e.what());
+    }
+
+    std::sort(instances.begin(), instances.end(), boost::bind(&BenchmarkInstance::name, _1) < boost::bind(&BenchmarkInstance::name, _2));
+    return instances;
+}
+
+void Benchmark::run(const std::vector<BenchmarkInstance>& instances)
+{
+    std::vector<BenchmarkInstance>::const_iterator it = instances.begin();
+    for(; it != instances.end(); ++it)
+    {
+        run(*it);
+    }
+}
+
+void Benchmark::run(const BenchmarkInstance& instance)
+{
+    std::string domainDescription = readFile(instance.domainFilename);
+    std::string problemDescription = readFile(instance.problemFilename);
+    mPlanning.setDomainDescription("benchmark", domainDescription);
+
+    std::vector<PlanningOptions::Mode>::const_iterator mit = mModes.begin();
+    for(; mit != mModes.end(); ++mit)
+    {
+        for(size_t repetition = 0; repetition < mRepetitions; ++repetition)
+        {
+            mRuns.push_back(runOnce(instance, problemDescription, *mit, repetition));
+            const BenchmarkRun& run = mRuns.back();
+            LOG_INFO("Benchmark: %s %s #%d: %s in %.3f s", instance.name.c_str(), getModeName(*mit).c_str(), (int) repetition, run.solved ? "solved" : "unsolved", run.wallTime);
+        }
+    }
+}
+
+BenchmarkRun Benchmark::runOnce(const BenchmarkInstance& instance, const std::string& problemDescription, PlanningOptions::Mode mode, size_t repetition)
+{
+    BenchmarkRun run;
+    run.instance = instance.name;
+    run.mode = mode;
+    run.repetition = repetition;
+
+    PlanningOptions options;
+    options.mode = mode;
+    options.timeout = mTimeout;
+    FirstPlanTimer timer;
+    options.planCallback = boost::bind(&FirstPlanTimer::received, &timer, _1, _2);
+
+    PlanResultList planResultList;
+    try {
+        planResultList = mPlanning.plan(problemDescription, mPlanners, options);
+    } catch(const std::runtime_error& e)
+    {
+        run.error = e.what();
+    }
+    run.wallTime = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - timer.start).count();
+
+    {
+        boost::unique_lock<boost::mutex> lock(timer.mutex);
+        run.timeToFirstPlan = timer.timeToFirstPlan;
+    }
+
+    PlanResultList::const_iterator it = planResultList.begin();
+    for(; it != planResultList.end(); ++it)
+    {
+        const PlannerStatistics& statistics = it->second.statistics;
+        run.peakMemory = std::max(run.peakMemory, statistics.peakMemory);
+        if(it->second.plans.empty())
+        {
+            continue;
+        }
+        run.solved = true;
+        std::vector<Plan>::const_iterator pit = it->second.plans.begin();
+        for(; pit != it->second.plans.end(); ++pit)
+        {
+            if(run.planLength == 0 || pit->action_sequence.size() < run.planLength)
+            {
+                run.planLength = pit->action_sequence.size();
+            }
+        }
+    }
+
+    // Planners, which do not report plans while searching, provide them at the end of the call
+    if(run.solved && run.timeToFirstPlan < 0)
+    {
+        run.timeToFirstPlan = run.wallTime;
+    }
+    return run;
+}
+
+std::vector<BenchmarkSummary> Benchmark::summarize() const
+{
+    std::vector<BenchmarkSummary> summaries;
+    std::vector< std::vector<double> > solveTimes;
+    std::map<std::pair<std::string, int>, size_t> indices;
+
+    std::vector<BenchmarkRun>::const_iterator it = mRuns.begin();
+    for(; it != mRuns.end(); ++it)
+    {
+        std::pair<std::string, int> configuration(it->instance, it->mode);
+        std::map<std::pair<std::string, int>, size_t>::iterator iit = indices.find(configuration);
+        if(iit == indices.end())
+        {
+            iit = indices.insert(std::make_pair(configuration, summaries.size())).first;
+            summaries.push_back(BenchmarkSummary());
+            summaries.back().instance = it->instance;
+            summaries.back().mode = it->mode;
+            solveTimes.push_back(std::vector<double>());
+        }
+
+        BenchmarkSummary& summary = summaries[iit->second];
+        ++summary.runs;
+        summary.meanWallTime += it->wallTime;
+        summary.peakMemory = std::max(summary.peakMemory, it->peakMemory);
+        if(it->solved)
+        {
+            ++summary.successes;
+            solveTimes[iit->second].push_back(it->timeToFirstPlan);
+            if(summary.bestPlanLength == 0 || it->planLength < summary.bestPlanLength)
+            {
+                summary.bestPlanLength = it->planLength;
+            }
+        }
+    }
+
+    for(size_t i = 0; i < summaries.size(); ++i)
+    {
+        BenchmarkSummary& summary = summaries[i];
+        summary.meanWallTime /= summary.runs;
+        if(!solveTimes[i].empty())
+        {
+            double total = 0.0;
+            std::vector<double>::const_iterator sit = solveTimes[i].begin();
+            for(; sit != solveTimes[i].end(); ++sit)
+            {
+                total += *sit;
+            }
+            summary.meanTimeToFirstPlan = total / solveTimes[i].size();
+            summary.medianTimeToFirstPlan = median(solveTimes[i]);
+        }
+    }
+    return summaries;
+}
+
+void Benchmark::writeCSV(std::ostream& out) const
+{
+    out << "instance,mode,runs,successes,success_rate,mean_time_to_first_plan,median_time_to_first_plan,mean_wall_time,best_plan_length,peak_memory_kb" << std::endl;
+    std::vector<BenchmarkSummary> summaries = summarize();
+    std::vector<BenchmarkSummary>::const_iterator it = summaries.begin();
+    for(; it != summaries.end(); ++it)
+    {
+        out << escapeCSV(it->instance) << ","
+            << getModeName(it->mode) << ","
+            << it->runs << ","
+            << it->successes << ","
+            << it->getSuccessRate() << ","
+            << it->meanTimeToFirstPlan << ","
+            << it->medianTimeToFirstPlan << ","
+            << it->meanWallTime << ","
+            << it->bestPlanLength << ","
+            << it->peakMemory << std::endl;
+    }
+}
+
+void Benchmark::writeJSON(std::ostream& out) const
+{
+    out << "{\n  \"planners\": [";
+    std::set<std::string>::const_iterator pit = mPlanners.begin();
+    for(; pit != mPlanners.end(); ++pit)
+    {
+        out << (pit == mPlanners.begin() ? "" : ", ") << "\"" << escapeJSON(*pit) << "\"";
+    }
+    out << "],\n  \"timeout\": " << mTimeout << ",\n  \"repetitions\": " << mRepetitions << ",\n";
+
+    out << "  \"summaries\": [";
+    std::vector<BenchmarkSummary> summaries = summarize();
+    std::vector<BenchmarkSummary>::const_iterator sit = summaries.begin();
+    for(; sit != summaries.end(); ++sit)
+    {
+        out << (sit == summaries.begin() ? "\n" : ",\n")
+            << "    {\"instance\": \"" << escapeJSON(sit->instance) << "\""
+            << ", \"mode\": \"" << getModeName(sit->mode) << "\""
+            << ", \"runs\": " << sit->runs
+            << ", \"successes\": " << sit->successes
+            << ", \"success_rate\": " << sit->getSuccessRate()
+            << ", \"mean_time_to_first_plan\": " << sit->meanTimeToFirstPlan
+            << ", \"median_time_to_first_plan\": " << sit->medianTimeToFirstPlan
+            << ", \"mean_wall_time\": " << sit->meanWallTime
+            << ", \"best_plan_length\": " << sit->bestPlanLength
+            << ", \"peak_memory_kb\": " << sit->peakMemory << "}";
+    }
+    out << "\n  ],\n";
+
+    out << "  \"runs\": [";
+    std::vector<BenchmarkRun>::const_iterator rit = mRuns.begin();
+    for(; rit != mRuns.end(); ++rit)
+    {
+        out << (rit == mRuns.begin() ? "\n" : ",\n")
+            << "    {\"instance\": \"" << escapeJSON(rit->instance) << "\""
+            << ", \"mode\": \"" << getModeName(rit->mode) << "\""
+            << ", \"repetition\": " << rit->repetition
+            << ", \"solved\": " << (rit->solved ? "true" : "false")
+            << ", \"time_to_first_plan\": " << rit->timeToFirstPlan
+            << ", \"wall_time\": " << rit->wallTime
+            << ", \"plan_length\": " << rit->planLength
+            << ", \"peak_memory_kb\": " << rit->peakMemory;
+        if(!rit->error.empty())
+        {
+            out << ", \"error\": \"" << escapeJSON(rit->error) << "\"";
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}" << std::endl;
+}
+
+std::string Benchmark::getModeName(PlanningOptions::Mode mode)
+{
+    switch(mode)
+    {
+        case PlanningOptions::PARALLEL: return "parallel";
+        case PlanningOptions::SEQUENTIAL: return "sequential";
+        case PlanningOptions::FIRST_WINS: return "first-wins";
+        case PlanningOptions::ADAPTIVE_SEQUENTIAL: return "adaptive-sequential";
+        case PlanningOptions::ADAPTIVE_PARALLEL: return "adaptive-parallel";
+    }
+    return "unknown";
+}
+
+} // end namespace pddl_planner
@@ -0,0 +1,181 @@
+#ifndef PDDL_PLANNER_BENCHMARK_HPP
+#define PDDL_PLANNER_BENCHMARK_HPP
+
+#include <pddl_planner/Planning.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <set>
+
+namespace pddl_planner
+{
+    /**
+     * Pair of domain and problem file of a benchmark corpus
+     */
+    struct BenchmarkInstance
+    {
+        BenchmarkInstance(const std::string& name = "", const std::string& domainFilename = "", const std::string& problemFilename = "")
+            : name(name)
+            , domainFilename(domainFilename)
+            , problemFilename(problemFilename)
+        {}
+
+        // Path of the problem file relative to the corpus directory
+        std::string name;
+        std::string domainFilename;
+        std::string problemFilename;
+    };
+
+    /**
+     * Outcome of a single run of a planner portfolio on an instance
+     */
+    struct BenchmarkRun
+    {
+        BenchmarkRun()
+            : mode(PlanningOptions::PARALLEL)
+            , repetition(0)
+            , solved(false)
+            , timeToFirstPlan(-1.0)
+            , wallTime(0.0)
+            , planLength(0)
+            , peakMemory(0)
+        {}
+
+        std::string instance;
+        PlanningOptions::Mode mode;
+        size_t repetition;
+        bool solved;
+        // Time in seconds from the start of the planning call until the first plan of any
+        // planner was available, -1 if there is none
+        double timeToFirstPlan;
+        // Duration of the planning call in seconds
+        double wallTime;
+        // Number of actions of the shortest plan, 0 if there is none
+        size_t planLength;
+        // Largest peak resident set size in kilobytes of a single planner call
+        long peakMemory;
+        // Error message if the planning call failed
+        std::string error;
+    };
+
+    /**
+     * Aggregated runs of a configuration, i.e. of an instance in one mode
+     */
+    struct BenchmarkSummary
+    {
+        BenchmarkSummary()
+            : mode(PlanningOptions::PARALLEL)
+            , runs(0)
+            , successes(0)
+            , meanTimeToFirstPlan(-1.0)
+            , medianTimeToFirstPlan(-1.0)
+            , meanWallTime(0.0)
+            , bestPlanLength(0)
+            , peakMemory(0)
+        {}
+
+        std::string instance;
+        PlanningOptions::Mode mode;
+        size_t runs;
+        size_t successes;
+        // Mean and median time to the first plan of the successful runs, -1 if there is none
+        double meanTimeToFirstPlan;
+        double medianTimeToFirstPlan;
+        double meanWallTime;
+        // Shortest plan of all runs, 0 if there is none
+        size_t bestPlanLength;
+        // Largest peak memory of all runs in kilobytes
+        long peakMemory;
+
+        double getSuccessRate() const { return runs ? successes / (double) runs : 0.0; }
+    };
+
+    /**
+     * \class Benchmark
+     * \brief Runs a planner portfolio over a corpus of domain and problem files
+     * \details Each instance is planned for repeatedly in each of the given modes, the runs
+     * are summarized per instance and mode. The benchmark uses its own Planning instance
+     * without plan cache, so that every run actually calls the planners
+     */
+    class Benchmark
+    {
+    public:
+        /**
+         * Constructor
+         * \param planners Planners of the portfolio
+         * \param timeout Timeout in seconds of each planner call
+         * \param repetitions Number of runs of each configuration
+         */
+        Benchmark(const std::set<std::string>& planners, double timeout = TIMEOUT, size_t repetitions = 1);
+
+        /**
+         * Collect the instances of a corpus -- each problem file '<name>.pddl' is paired with
+         * '<name>-domain.pddl' or 'domain_<name>.pddl' if one exists, otherwise with
+         * 'domain.pddl' of the same directory. Subdirectories are searched recursively
+         * \param directory Corpus directory
+         * \return instances ordered by name
+         * \throws PlanGenerationException if the directory cannot be read
+         */
+        static std::vector<BenchmarkInstance> findInstances(const std::string& directory);
+
+        /**
+         * Set the modes, which each instance is planned in -- by default SEQUENTIAL,
+         * PARALLEL and FIRST_WINS
+         */
+        void setModes(const std::vector<PlanningOptions::Mode>& modes) { mModes = modes; }
+
+        /**
+         * Get the planning instance, e.g. to set resource limits of the planners
+         */
+        Planning& getPlanning() { return mPlanning; }
+
+        /**
+         * Run all configurations of the given instances -- runs are added to the previous ones
+         * \throws PlanGenerationException if the files of an instance cannot be read
+         */
+        void run(const std::vector<BenchmarkInstance>& instances);
+
+        /**
+         * Run all configurations of a single instance
+         * \throws PlanGenerationException if the files of the instance cannot be read
+         */
+        void run(const BenchmarkInstance& instance);
+
+        /**
+         * Get all runs in the order of execution
+         */
+        const std::vector<BenchmarkRun>& getRuns() const { return mRuns; }
+
+        /**
+         * Summarize the runs per instance and mode
+         * \return summaries in the order of the first run of each configuration
+         */
+        std::vector<BenchmarkSummary> summarize() const;
+
+        /**
+         * Write the summaries as CSV with a header line
+         */
+        void writeCSV(std::ostream& out) const;
+
+        /**
+         * Write the configuration, the summaries and all runs as JSON object
+         */
+        void writeJSON(std::ostream& out) const;
+
+        /**
+         * Get the name of a planning mode, as used in the reports
+         */
+        static std::string getModeName(PlanningOptions::Mode mode);
+
+    private:
+        BenchmarkRun runOnce(const BenchmarkInstance& instance, const std::string& problemDescription, PlanningOptions::Mode mode, size_t repetition);
+
+        Planning mPlanning;
+        std::set<std::string> mPlanners;
+        double mTimeout;
+        size_t mRepetitions;
+        std::vector<PlanningOptions::Mode> mModes;
+        std::vector<BenchmarkRun> mRuns;
+    };
+}
+#endif // PDDL_PLANNER_BENCHMARK_HPP
@@ -0,0 +1,147 @@
+/**
+ *
+ *      Benchmark of planner portfolios over a corpus of domain and problem files
+ *
+ * usage:
+ *
+ *  ./pddl_planner_bench [-p <planner-name>]... [-n <repetitions>] [-t <timeout-seconds(float)>]
+ *                       [-m <sequential|parallel|first-wins>]... [-f <csv|json>] [-o <output-file>] <corpus-directory>
+ *
+ *
+ *          -p,  --planner              planner of the portfolio, LAMA by default
+ *          -n,  --repetitions          number of runs of each configuration
+ *          -t,  --timeout              timeout of each planner call
+ *          -m,  --mode                 planning mode, all three modes by default
+ *          -f,  --format               report format, csv by default
+ *          -o,  --output               write the report to a file instead of the standard output
+ *
+ *      Each problem file '<name>.pddl' of the corpus is paired with '<name>-domain.pddl',
+ *      'domain_<name>.pddl' or 'domain.pddl' of the same directory
+ *
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <pddl_planner/Benchmark.hpp>
+
+void usage(const char* name)
+{
+    std::cout << "usage: " << name << " [-p <planner-name>]... [-n <repetitions>] [-t <timeout-seconds(float)>]" << std::endl;
+    std::cout << "          [-m <sequential|parallel|first-wins>]... [-f <csv|json>] [-o <output-file>] <corpus-directory>" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    using namespace pddl_planner;
+
+    std::set<std::string> planners;
+    std::vector<PlanningOptions::Mode> modes;
+    double timeout = TIMEOUT;
+    int repetitions = 1;
+    std::string format = "csv";
+    std::string outputFilename;
+    std::string corpus;
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if((option == "-p" || option == "--planner") && i + 1 < argc)
+        {
+            planners.insert(argv[++i]);
+        } else if((option == "-n" || option == "--repetitions") && i + 1 < argc)
+        {
+            repetitions = atoi(argv[++i]);
+        } else if((option == "-t" || option == "--timeout") && i + 1 < argc)
+        {
+            timeout = atof(argv[++i]);
+        } else if((option == "-m" || option == "--mode") && i + 1 < argc)
+        {
+            std::string mode = argv[++i];
+            if(mode == Benchmark::getModeName(PlanningOptions::SEQUENTIAL))
+            {
+                modes.push_back(PlanningOptions::SEQUENTIAL);
+            } else if(mode == Benchmark::getModeName(PlanningOptions::PARALLEL))
+            {
+                modes.push_back(PlanningOptions::PARALLEL);
+            } else if(mode == Benchmark::getModeName(PlanningOptions::FIRST_WINS))
+            {
+                modes.push_back(PlanningOptions::FIRST_WINS);
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if((option == "-f" || option == "--format") && i + 1 < argc)
+        {
+            format = argv[++i];
+        } else if((option == "-o" || option == "--output") && i + 1 < argc)
+        {
+            outputFilename = argv[++i];
+        } else if(corpus.empty() && option[0] != '-')
+        {
+            corpus = option;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(corpus.empty() || repetitions < 1 || timeout <= 0 || (format != "csv" && format != "json"))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    if(planners.empty())
+    {
+        planners.insert("LAMA");
+    }
+
+    Benchmark benchmark(planners, timeout, repetitions);
+    if(!modes.empty())
+    {
+        benchmark.setModes(modes);
+    }
+
+    std::set<std::string> availablePlanners = benchmark.getPlanning().getAvailablePlanners();
+    std::set<std::string>::const_iterator it = planners.begin();
+    for(; it != planners.end(); ++it)
+    {
+        if(!availablePlanners.count(*it))
+        {
+            std::cerr << "Planner '" << *it << "' is not available" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        std::vector<BenchmarkInstance> instances = Benchmark::findInstances(corpus);
+        if(instances.empty())
+        {
+            std::cerr << "No instances found in '" << corpus << "'" << std::endl;
+            return 1;
+        }
+        benchmark.run(instances);
+    } catch(const PlanGenerationException& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    if(!outputFilename.empty())
+    {
+        file.open(outputFilename.c_str());
+        if(!file)
+        {
+            std::cerr << "Failed to open '" << outputFilename << "'" << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputFilename.empty() ? std::cout : file;
+    if(format == "json")
+    {
+        benchmark.writeJSON(out);
+    } else {
+        benchmark.writeCSV(out);
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <pddl_planner/BinaryRegistry.hpp>
+#include <base/logging.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdlib.h>
+
+namespace pddl_planner
+{
+
+BinaryRegistry& BinaryRegistry::getInstance()
+{
+    static BinaryRegistry binaryRegistry;
+    return binaryRegistry;
+}
+
+std::string BinaryRegistry::resolve(const std::string& cmd)
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    std::map<std::string, Entry>::iterator it = mEntries.find(cmd);
+    if(it != mEntries.end())
+    {
+        // Executables which could not be found are only searched again on request
+        if(it->second.path.empty() || isUnchanged(it->second))
+        {
+            return it->second.path;
+        }
+        LOG_INFO("BinaryRegistry: executable '%s' has changed, resolving again", it->second.path.c_str());
+    }
+
+    Entry entry = search(cmd);
+    if(entry.path.empty())
+    {
+        LOG_DEBUG("BinaryRegistry: could not find executable '%s'", cmd.c_str());
+    }
+    mEntries[cmd] = entry;
+    return entry.path;
+}
+
+void BinaryRegistry::refresh(const std::string& cmd)
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    if(cmd.empty())
+    {
+        mEntries.clear();
+    } else {
+        mEntries.erase(cmd);
+    }
+}
+
+BinaryRegistry::Entry BinaryRegistry::search(const std::string& cmd)
+{
+    std::vector<std::string> candidates;
+    if(cmd.find('/') != std::string::npos)
+    {
+        candidates.push_back(cmd);
+    } else {
+        const char* path = getenv("PATH");
+        std::vector<std::string> directories;
+        boost::split(directories, path ? path : "", boost::is_any_of(":"));
+        std::vector<std::string>::const_iterator it = directories.begin();
+        for(; it != directories.end(); ++it)
+        {
+            // An empty entry refers to the current directory
+            candidates.push_back((it->empty() ? "." : *it) + "/" + cmd);
+        }
+    }
+
+    Entry entry;
+    std::vector<std::string>::const_iterator cit = candidates.begin();
+    for(; cit != candidates.end(); ++cit)
+    {
+        struct stat info;
+        if(0 == stat(cit->c_str(), &info) && S_ISREG(info.st_mode) && 0 == access(cit->c_str(), X_OK))
+        {
+            // Symlinks are kept as they are, since planner scripts might rely on their location
+            entry.path = boost::filesystem::absolute(*cit).string();
+            entry.device = info.st_dev;
+            entry.inode = info.st_ino;
+            entry.modificationTime = info.st_mtim;
+            break;
+        }
+    }
+    return entry;
+}
+
+bool BinaryRegistry::isUnchanged(const Entry& entry)
+{
+    struct stat info;
+    if(0 != stat(entry.path.c_str(), &info))
+    {
+        return false;
+    }
+    return info.st_dev == entry.device && info.st_ino == entry.inode
+        && info.st_mtim.tv_sec == entry.modificationTime.tv_sec
+        && info.st_mtim.tv_nsec == entry.modificationTime.tv_nsec;
+}
+
+} // end namespace pddl_planner
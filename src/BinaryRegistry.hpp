@@ -0,0 +1,72 @@
+#ifndef PDDL_PLANNER_BINARY_REGISTRY_HPP
+#define PDDL_PLANNER_BINARY_REGISTRY_HPP
+
+#include <string>
+#include <map>
+#include <sys/types.h>
+#include <time.h>
+#include <boost/thread/mutex.hpp>
+
+namespace pddl_planner
+{
+    /**
+     * \class BinaryRegistry
+     * \brief Cache for the absolute paths of planner executables
+     * \details Executables are searched in PATH once, without spawning a shell. Afterwards
+     * a cached path is only revalidated via stat, i.e. it will be resolved again
+     * when the file changes or disappears, or when refresh is called
+     */
+    class BinaryRegistry
+    {
+    public:
+        /**
+         * Get the process-wide registry
+         * \return registry
+         */
+        static BinaryRegistry& getInstance();
+
+        /**
+         * Resolve the absolute path of an executable
+         * \param cmd Name of the executable or path to the executable
+         * \return absolute path of the executable, or an empty string if it could not be found
+         */
+        std::string resolve(const std::string& cmd);
+
+        /**
+         * Check whether an executable can be found
+         * \return true if executable exists, false otherwise
+         */
+        bool isAvailable(const std::string& cmd) { return !resolve(cmd).empty(); }
+
+        /**
+         * Drop the cached result for an executable, so that next resolve
+         * will search again
+         * \param cmd Name of the executable, an empty name drops all cached results
+         */
+        void refresh(const std::string& cmd = "");
+
+    private:
+        struct Entry
+        {
+            std::string path;
+            dev_t device;
+            ino_t inode;
+            struct timespec modificationTime;
+        };
+
+        /**
+         * Search an executable
+         * \return entry where an empty path indicates that the executable has not been found
+         */
+        static Entry search(const std::string& cmd);
+
+        /**
+         * Check whether the cached file is (still) the same
+         */
+        static bool isUnchanged(const Entry& entry);
+
+        boost::mutex mMutex;
+        std::map<std::string, Entry> mEntries;
+    };
+}
+#endif // PDDL_PLANNER_BINARY_REGISTRY_HPP
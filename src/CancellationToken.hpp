@@ -0,0 +1,38 @@
+#ifndef PDDL_PLANNER_CANCELLATION_TOKEN_HPP
+#define PDDL_PLANNER_CANCELLATION_TOKEN_HPP
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <atomic>
+
+namespace pddl_planner
+{
+    /**
+     * \class CancellationToken
+     * \brief Shared flag which allows to request the cancellation of a running planner call
+     * \details Copies of a token share the same state, i.e. cancelling one copy
+     * cancels all of them
+     */
+    class CancellationToken
+    {
+    public:
+        CancellationToken()
+            : mCancelled(boost::make_shared< std::atomic<bool> >(false))
+        {}
+
+        /**
+         * Request cancellation
+         */
+        void cancel() { *mCancelled = true; }
+
+        /**
+         * Check whether cancellation has been requested
+         * \return true if cancelled, false otherwise
+         */
+        bool isCancelled() const { return *mCancelled; }
+
+    private:
+        boost::shared_ptr< std::atomic<bool> > mCancelled;
+    };
+}
+#endif // PDDL_PLANNER_CANCELLATION_TOKEN_HPP
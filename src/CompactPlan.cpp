@@ -0,0 +1,198 @@
+#include <pddl_planner/CompactPlan.hpp>
+#include <boost/functional/hash.hpp>
+#include <stdexcept>
+
+namespace pddl_planner
+{
+
+SymbolTable::SymbolTable()
+{}
+
+SymbolTable::SymbolTable(const representation::Domain& domain)
+{
+    representation::ActionList::const_iterator ait = domain.actions.begin();
+    for(; ait != domain.actions.end(); ++ait)
+    {
+        intern(ait->label);
+    }
+    representation::ConstantList::const_iterator cit = domain.constants.begin();
+    for(; cit != domain.constants.end(); ++cit)
+    {
+        intern(cit->label);
+    }
+}
+
+SymbolId SymbolTable::intern(const std::string& symbol)
+{
+    size_t hash;
+    return intern(symbol, hash);
+}
+
+SymbolId SymbolTable::intern(const std::string& symbol, size_t& hash)
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    boost::unordered_map<std::string, SymbolId>::const_iterator it = mIds.find(symbol);
+    if(it != mIds.end())
+    {
+        hash = mHashes[it->second];
+        return it->second;
+    }
+
+    SymbolId id = mSymbols.size();
+    hash = boost::hash<std::string>()(symbol);
+    mSymbols.push_back(symbol);
+    mHashes.push_back(hash);
+    mIds.insert(std::make_pair(symbol, id));
+    return id;
+}
+
+const std::string& SymbolTable::getSymbol(SymbolId id) const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    if(id >= mSymbols.size())
+    {
+        throw std::out_of_range("SymbolTable: unknown symbol id");
+    }
+    return mSymbols[id];
+}
+
+size_t SymbolTable::getHash(SymbolId id) const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    if(id >= mHashes.size())
+    {
+        throw std::out_of_range("SymbolTable: unknown symbol id");
+    }
+    return mHashes[id];
+}
+
+size_t SymbolTable::size() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mSymbols.size();
+}
+
+CompactPlan::CompactPlan(const SymbolTablePtr& symbols)
+    : mSymbols(symbols)
+    , mHash(0)
+    , mCost(-1.0)
+{}
+
+CompactPlan::CompactPlan(const Plan& plan, const SymbolTablePtr& symbols)
+    : mSymbols(symbols)
+    , mHash(0)
+    , mCost(plan.cost)
+{
+    size_t arguments = 0;
+    std::vector<Action>::const_iterator it = plan.action_sequence.begin();
+    for(; it != plan.action_sequence.end(); ++it)
+    {
+        arguments += it->arguments.size();
+    }
+    mSteps.reserve(plan.action_sequence.size());
+    mArguments.reserve(arguments);
+
+    for(it = plan.action_sequence.begin(); it != plan.action_sequence.end(); ++it)
+    {
+        addAction(*it);
+    }
+}
+
+void CompactPlan::combineHash(size_t symbolHash)
+{
+    boost::hash_combine(mHash, symbolHash);
+}
+
+void CompactPlan::addAction(const Action& action)
+{
+    size_t hash;
+    Step step;
+    step.action = mSymbols->intern(action.name, hash);
+    step.offset = mArguments.size();
+    mSteps.push_back(step);
+    combineHash(hash);
+    // The number of arguments tells apart plans which only differ in the split of arguments
+    combineHash(action.arguments.size());
+
+    std::vector<std::string>::const_iterator it = action.arguments.begin();
+    for(; it != action.arguments.end(); ++it)
+    {
+        mArguments.push_back(mSymbols->intern(*it, hash));
+        combineHash(hash);
+    }
+}
+
+const SymbolId* CompactPlan::getArgumentIds(size_t step, size_t& count) const
+{
+    uint32_t begin = mSteps[step].offset;
+    count = getEnd(step) - begin;
+    return count ? &mArguments[begin] : NULL;
+}
+
+Action CompactPlan::getAction(size_t step) const
+{
+    Action action(mSymbols->getSymbol(mSteps[step].action));
+    uint32_t end = getEnd(step);
+    action.arguments.reserve(end - mSteps[step].offset);
+    for(uint32_t i = mSteps[step].offset; i < end; ++i)
+    {
+        action.arguments.push_back(mSymbols->getSymbol(mArguments[i]));
+    }
+    return action;
+}
+
+Plan CompactPlan::toPlan() const
+{
+    Plan plan;
+    plan.cost = mCost;
+    plan.action_sequence.reserve(mSteps.size());
+    for(size_t i = 0; i < mSteps.size(); ++i)
+    {
+        plan.action_sequence.push_back(getAction(i));
+    }
+    return plan;
+}
+
+bool CompactPlan::operator==(const CompactPlan& other) const
+{
+    if(mHash != other.mHash || mSteps.size() != other.mSteps.size() || mArguments.size() != other.mArguments.size())
+    {
+        return false;
+    }
+
+    if(mSymbols == other.mSymbols)
+    {
+        for(size_t i = 0; i < mSteps.size(); ++i)
+        {
+            if(mSteps[i].action != other.mSteps[i].action || mSteps[i].offset != other.mSteps[i].offset)
+            {
+                return false;
+            }
+        }
+        return mArguments == other.mArguments;
+    }
+
+    // Ids of different tables cannot be compared, so compare the symbols
+    for(size_t i = 0; i < mSteps.size(); ++i)
+    {
+        if(mSteps[i].offset != other.mSteps[i].offset || mSymbols->getSymbol(mSteps[i].action) != other.mSymbols->getSymbol(other.mSteps[i].action))
+        {
+            return false;
+        }
+    }
+    for(size_t i = 0; i < mArguments.size(); ++i)
+    {
+        if(mSymbols->getSymbol(mArguments[i]) != other.mSymbols->getSymbol(other.mArguments[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string CompactPlan::toString() const
+{
+    return toPlan().toString();
+}
+
+} // end namespace pddl_planner
@@ -0,0 +1,180 @@
+#ifndef PDDL_PLANNER_COMPACT_PLAN_HPP
+#define PDDL_PLANNER_COMPACT_PLAN_HPP
+
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <pddl_planner/representation/Domain.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include <deque>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace pddl_planner
+{
+    typedef uint32_t SymbolId;
+
+    /**
+     * \class SymbolTable
+     * \brief Interns the action names and arguments of plans, so that plans can refer to
+     * them by id
+     * \details Ids are dense and never change, symbols are kept for the lifetime of the
+     * table. A table created from a domain already contains its actions and constants, so
+     * that plans of the domain mostly add their objects only. All methods are thread-safe
+     */
+    class SymbolTable
+    {
+    public:
+        SymbolTable();
+
+        /**
+         * Create a table containing the labels of the actions and constants of a domain
+         */
+        SymbolTable(const representation::Domain& domain);
+
+        /**
+         * Get the id of a symbol, which is added if it is not yet known
+         * \return id of the symbol
+         */
+        SymbolId intern(const std::string& symbol);
+
+        /**
+         * Get the id of a symbol together with its hash
+         * \param hash Receives the hash of the symbol
+         * \return id of the symbol
+         */
+        SymbolId intern(const std::string& symbol, size_t& hash);
+
+        /**
+         * Get the symbol of an id
+         * \return symbol, which remains valid for the lifetime of the table
+         * \throws std::out_of_range if the id is unknown
+         */
+        const std::string& getSymbol(SymbolId id) const;
+
+        /**
+         * Get the hash of the symbol of an id, which does not depend on the table
+         * \throws std::out_of_range if the id is unknown
+         */
+        size_t getHash(SymbolId id) const;
+
+        /**
+         * Get the number of symbols
+         */
+        size_t size() const;
+
+    private:
+        SymbolTable(const SymbolTable& other);
+        SymbolTable& operator=(const SymbolTable& other);
+
+        mutable boost::mutex mMutex;
+        // A deque keeps the symbols in place while the table grows
+        std::deque<std::string> mSymbols;
+        std::vector<size_t> mHashes;
+        boost::unordered_map<std::string, SymbolId> mIds;
+    };
+
+    typedef boost::shared_ptr<SymbolTable> SymbolTablePtr;
+
+    /**
+     * \class CompactPlan
+     * \brief Plan with interned action names and arguments
+     * \details Actions are stored as flat array of the action id and the offset of its
+     * arguments in a single argument array, so a plan consists of two arrays regardless
+     * of its length. The hash is computed once from the hashes of the symbols, so it is the same
+     * for equal plans of different symbol tables. Plans of the same table are compared by ids
+     */
+    class CompactPlan
+    {
+    public:
+        /**
+         * Create an empty plan
+         */
+        CompactPlan(const SymbolTablePtr& symbols = SymbolTablePtr(new SymbolTable()));
+
+        /**
+         * Convert a plan, interning its symbols
+         */
+        CompactPlan(const Plan& plan, const SymbolTablePtr& symbols);
+
+        /**
+         * Convert back to a plan
+         */
+        Plan toPlan() const;
+
+        /**
+         * Append an action
+         */
+        void addAction(const Action& action);
+
+        /**
+         * Get the number of actions
+         */
+        size_t size() const { return mSteps.size(); }
+
+        bool empty() const { return mSteps.empty(); }
+
+        /**
+         * Get the action id of a step
+         */
+        SymbolId getActionId(size_t step) const { return mSteps[step].action; }
+
+        /**
+         * Get the argument ids of a step
+         * \param count Receives the number of arguments
+         * \return pointer to the first argument id
+         */
+        const SymbolId* getArgumentIds(size_t step, size_t& count) const;
+
+        /**
+         * Get an action of the plan
+         */
+        Action getAction(size_t step) const;
+
+        const SymbolTablePtr& getSymbolTable() const { return mSymbols; }
+
+        /**
+         * Get the cost reported by the planner, -1 if it is unknown -- the cost is neither part
+         * of the hash nor of the comparison
+         */
+        double getCost() const { return mCost; }
+        void setCost(double cost) { mCost = cost; }
+
+        /**
+         * Get the hash of the plan
+         */
+        size_t getHash() const { return mHash; }
+
+        bool operator==(const CompactPlan& other) const;
+        bool operator!=(const CompactPlan& other) const { return !operator==(other); }
+
+        /**
+         * Create string representation in the format of Plan::toString
+         */
+        std::string toString() const;
+
+    private:
+        struct Step
+        {
+            SymbolId action;
+            // Offset of the first argument in mArguments
+            uint32_t offset;
+        };
+
+        uint32_t getEnd(size_t step) const { return step + 1 < mSteps.size() ? mSteps[step + 1].offset : mArguments.size(); }
+        void combineHash(size_t symbolHash);
+
+        SymbolTablePtr mSymbols;
+        std::vector<Step> mSteps;
+        std::vector<SymbolId> mArguments;
+        size_t mHash;
+        double mCost;
+    };
+
+    /**
+     * Hash of a plan for use with boost::hash, e.g. in a boost::unordered_set
+     */
+    inline size_t hash_value(const CompactPlan& plan) { return plan.getHash(); }
+}
+#endif // PDDL_PLANNER_COMPACT_PLAN_HPP
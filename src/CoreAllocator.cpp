@@ -0,0 +1,91 @@
+#include <pddl_planner/CoreAllocator.hpp>
+#include <base/logging.h>
+#include <sched.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace pddl_planner
+{
+
+CoreAllocator::CoreAllocator(size_t coresPerPlanner)
+    : mCoresPerPlanner(0)
+{
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if(0 == sched_getaffinity(0, sizeof(cpus), &cpus))
+    {
+        for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if(CPU_ISSET(cpu, &cpus))
+            {
+                mCores.push_back(cpu);
+            }
+        }
+    } else {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        for(int cpu = 0; cpu < cores; ++cpu)
+        {
+            mCores.push_back(cpu);
+        }
+    }
+    mUsage.resize(mCores.size(), 0);
+    setCoresPerPlanner(coresPerPlanner);
+}
+
+CoreAllocator& CoreAllocator::getInstance()
+{
+    static CoreAllocator coreAllocator;
+    return coreAllocator;
+}
+
+void CoreAllocator::setCoresPerPlanner(size_t coresPerPlanner)
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mCoresPerPlanner = std::min(coresPerPlanner, mCores.size());
+}
+
+size_t CoreAllocator::getCoresPerPlanner() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mCoresPerPlanner;
+}
+
+std::vector<int> CoreAllocator::acquire()
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    std::vector<int> cores;
+    for(size_t n = 0; n < mCoresPerPlanner; ++n)
+    {
+        // Pick the least used core not yet part of this allocation
+        size_t selected = mCores.size();
+        for(size_t i = 0; i < mCores.size(); ++i)
+        {
+            if(std::find(cores.begin(), cores.end(), mCores[i]) == cores.end()
+                    && (selected == mCores.size() || mUsage[i] < mUsage[selected]))
+            {
+                selected = i;
+            }
+        }
+        ++mUsage[selected];
+        cores.push_back(mCores[selected]);
+    }
+    return cores;
+}
+
+void CoreAllocator::release(const std::vector<int>& cores)
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    std::vector<int>::const_iterator it = cores.begin();
+    for(; it != cores.end(); ++it)
+    {
+        std::vector<int>::iterator core = std::find(mCores.begin(), mCores.end(), *it);
+        if(core == mCores.end() || mUsage[core - mCores.begin()] == 0)
+        {
+            LOG_WARN("CoreAllocator: releasing core %d, which has not been acquired", *it);
+            continue;
+        }
+        --mUsage[core - mCores.begin()];
+    }
+}
+
+} // end namespace pddl_planner
@@ -0,0 +1,100 @@
+#ifndef PDDL_PLANNER_CORE_ALLOCATOR_HPP
+#define PDDL_PLANNER_CORE_ALLOCATOR_HPP
+
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+namespace pddl_planner
+{
+    /**
+     * \class CoreAllocator
+     * \brief Hands out disjoint sets of cores to the planner processes running at the same time
+     * \details Cores are taken from the affinity mask of this process. Each allocation gets the
+     * least used cores, so that allocations are disjoint as long as there are enough cores --
+     * otherwise cores are shared evenly. Allocation is disabled unless the number of cores
+     * per planner is set
+     */
+    class CoreAllocator
+    {
+    public:
+        /**
+         * Constructor
+         * \param coresPerPlanner Number of cores of an allocation, 0 disables the allocation
+         */
+        CoreAllocator(size_t coresPerPlanner = 0);
+
+        /**
+         * Get the process-wide core allocator which is used by the planners
+         * \return core allocator
+         */
+        static CoreAllocator& getInstance();
+
+        /**
+         * Set the number of cores of an allocation -- it is limited to the available cores
+         * \param coresPerPlanner Number of cores, 0 disables the allocation
+         */
+        void setCoresPerPlanner(size_t coresPerPlanner);
+
+        /**
+         * Get the number of cores of an allocation
+         * \return number of cores, 0 if the allocation is disabled
+         */
+        size_t getCoresPerPlanner() const;
+
+        /**
+         * Get the cores which are available for allocations
+         * \return ids of the cores
+         */
+        std::vector<int> getCores() const { return mCores; }
+
+        /**
+         * Allocate the least used cores
+         * \return ids of the allocated cores, empty if the allocation is disabled
+         */
+        std::vector<int> acquire();
+
+        /**
+         * Release cores acquired before
+         */
+        void release(const std::vector<int>& cores);
+
+    private:
+        CoreAllocator(const CoreAllocator& other);
+        CoreAllocator& operator=(const CoreAllocator& other);
+
+        mutable boost::mutex mMutex;
+        size_t mCoresPerPlanner;
+        std::vector<int> mCores;
+        // Number of allocations per core, in the order of mCores
+        std::vector<size_t> mUsage;
+    };
+
+    /**
+     * \class CoreReservation
+     * \brief Holds cores of a CoreAllocator for its lifetime
+     */
+    class CoreReservation
+    {
+    public:
+        CoreReservation(CoreAllocator& allocator = CoreAllocator::getInstance())
+            : mAllocator(allocator)
+            , mCores(allocator.acquire())
+        {}
+
+        ~CoreReservation() { mAllocator.release(mCores); }
+
+        /**
+         * Get the reserved cores
+         * \return ids of the cores, empty if the allocation is disabled
+         */
+        const std::vector<int>& getCores() const { return mCores; }
+
+    private:
+        CoreReservation(const CoreReservation& other);
+        CoreReservation& operator=(const CoreReservation& other);
+
+        CoreAllocator& mAllocator;
+        std::vector<int> mCores;
+    };
+}
+#endif // PDDL_PLANNER_CORE_ALLOCATOR_HPP
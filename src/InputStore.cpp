@@ -0,0 +1,199 @@
+#include <pddl_planner/InputStore.hpp>
+#include <pddl_planner/WorkspaceManager.hpp>
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread.hpp>
+#include <base/logging.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace fs = boost::filesystem;
+
+namespace pddl_planner
+{
+
+namespace
+{
+    /**
+     * Create the key of a content, i.e. its hash and size
+     */
+    std::string createKey(const std::string& content)
+    {
+        std::stringstream ss;
+        ss << std::hex << boost::hash<std::string>()(content) << "-" << std::dec << content.size();
+        return ss.str();
+    }
+
+    /**
+     * Write a file
+     * \throws PlanGenerationException if the file could not be written
+     */
+    void writeFile(const std::string& filename, const std::string& content)
+    {
+        std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(content.data(), content.size());
+        out.close();
+        if(!out)
+        {
+            throw PlanGenerationException("InputStore: could not write '" + filename + "'");
+        }
+    }
+
+    /**
+     * Create a hard link, which replaces an existing file
+     * \return true on success, false otherwise
+     */
+    bool linkFile(const std::string& from, const std::string& to)
+    {
+        boost::system::error_code ec;
+        fs::remove(to, ec);
+        ec.clear();
+        fs::create_hard_link(from, to, ec);
+        return !ec;
+    }
+}
+
+InputStore::InputStore(size_t capacity)
+    : mCapacity(capacity)
+    , mWrites(0)
+    , mLinks(0)
+{}
+
+InputStore::~InputStore()
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    clear();
+}
+
+InputStore& InputStore::getInstance()
+{
+    static InputStore inputStore;
+    return inputStore;
+}
+
+bool InputStore::provide(const std::string& content, const std::string& filename)
+{
+    std::string key = createKey(content);
+
+    std::string directory;
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        directory = getDirectory();
+        std::map<std::string, std::list<Entry>::iterator>::iterator it = mIndex.find(key);
+        if(it != mIndex.end())
+        {
+            if(it->second->second != content)
+            {
+                // Hash collision: the stored file has another content, so write the file
+                LOG_DEBUG("InputStore: key %s is used by another content", key.c_str());
+                directory.clear();
+            } else {
+                mEntries.splice(mEntries.begin(), mEntries, it->second);
+                // Link while holding the lock, so that the entry cannot be evicted meanwhile
+                if(linkFile(directory + "/" + key, filename))
+                {
+                    ++mLinks;
+                    return true;
+                }
+                mEntries.erase(it->second);
+                mIndex.erase(it);
+            }
+        }
+    }
+
+    if(!directory.empty())
+    {
+        // Write outside of the lock to a file of this thread, concurrent writers of the
+        // same content are resolved when the file is added
+        std::stringstream tmp;
+        tmp << directory << "/" << key << ".tmp." << boost::this_thread::get_id();
+        try {
+            writeFile(tmp.str(), content);
+            fs::permissions(tmp.str(), fs::owner_read | fs::group_read | fs::others_read);
+
+            boost::unique_lock<boost::mutex> lock(mMutex);
+            std::string stored = directory + "/" + key;
+            boost::system::error_code ec;
+            std::map<std::string, std::list<Entry>::iterator>::iterator it = mIndex.find(key);
+            if(it == mIndex.end())
+            {
+                fs::rename(tmp.str(), stored, ec);
+                if(!ec)
+                {
+                    ++mWrites;
+                    mEntries.push_front(Entry(key, content));
+                    mIndex[key] = mEntries.begin();
+                    while(mEntries.size() > mCapacity)
+                    {
+                        fs::remove(directory + "/" + mEntries.back().first, ec);
+                        mIndex.erase(mEntries.back().first);
+                        mEntries.pop_back();
+                    }
+                    it = mIndex.find(key);
+                }
+            }
+            fs::remove(tmp.str(), ec);
+
+            if(it != mIndex.end() && it->second->second == content && linkFile(stored, filename))
+            {
+                ++mLinks;
+                return true;
+            }
+        } catch(const std::exception& e)
+        {
+            LOG_WARN("InputStore: failed to store input: %s", e.what());
+            boost::system::error_code ec;
+            fs::remove(tmp.str(), ec);
+        }
+    }
+
+    writeFile(filename, content);
+    return false;
+}
+
+uint64_t InputStore::getWrites() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mWrites;
+}
+
+uint64_t InputStore::getLinks() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mLinks;
+}
+
+std::string InputStore::getDirectory()
+{
+    std::stringstream ss;
+    ss << WorkspaceManager::getInstance().getRoot() << "/pddl_planner_input_" << getpid();
+    if(ss.str() != mDirectory)
+    {
+        clear();
+        boost::system::error_code ec;
+        fs::create_directories(ss.str(), ec);
+        if(ec)
+        {
+            LOG_WARN("InputStore: could not create directory '%s': %s", ss.str().c_str(), ec.message().c_str());
+            return "";
+        }
+        mDirectory = ss.str();
+    }
+    return mDirectory;
+}
+
+void InputStore::clear()
+{
+    if(!mDirectory.empty())
+    {
+        boost::system::error_code ec;
+        fs::remove_all(mDirectory, ec);
+        mDirectory.clear();
+    }
+    mEntries.clear();
+    mIndex.clear();
+}
+
+} // end namespace pddl_planner
@@ -0,0 +1,92 @@
+#ifndef PDDL_PLANNER_INPUT_STORE_HPP
+#define PDDL_PLANNER_INPUT_STORE_HPP
+
+#include <boost/thread/mutex.hpp>
+#include <stdint.h>
+#include <string>
+#include <list>
+#include <map>
+
+namespace pddl_planner
+{
+    /**
+     * \class InputStore
+     * \brief Shares the input files of planner calls, i.e. domain and problem files
+     * \details Each distinct content is written once to a read-only file below the workspace
+     * root and hard-linked into the planners' workspaces, so that a portfolio of planners
+     * working on the same request does not write the same description for every planner.
+     * The most recently used files are kept for subsequent requests. Files are identified by a
+     * hash of their content, and the content of each stored file is kept in memory and compared
+     * before linking, so that a hash collision never links a wrong file. If linking fails,
+     * e.g. since the workspace root has been moved to another file system, the file is
+     * written to the workspace instead
+     */
+    class InputStore
+    {
+    public:
+        /**
+         * Constructor
+         * \param capacity Maximum number of files to keep
+         */
+        InputStore(size_t capacity = 8);
+
+        /**
+         * Deconstructor removes the stored files
+         */
+        ~InputStore();
+
+        /**
+         * Get the process-wide store which is used by the planners
+         * \return input store
+         */
+        static InputStore& getInstance();
+
+        /**
+         * Provide a file with the given content
+         * \param content Content of the file
+         * \param filename Path of the file to create, an existing file is replaced
+         * \return true if the file has been linked to a stored file, false if it has been written
+         * \throws PlanGenerationException if the file could not be written
+         */
+        bool provide(const std::string& content, const std::string& filename);
+
+        /**
+         * Get number of files which have been written to the store
+         */
+        uint64_t getWrites() const;
+
+        /**
+         * Get number of files which have been provided by linking
+         */
+        uint64_t getLinks() const;
+
+    private:
+        InputStore(const InputStore& other);
+        InputStore& operator=(const InputStore& other);
+
+        /**
+         * Get the directory of the store below the current workspace root -- stored files
+         * below a previous root are dropped -- requires mMutex to be locked
+         * \return directory, or an empty string if it cannot be created
+         */
+        std::string getDirectory();
+
+        /**
+         * Remove all stored files -- requires mMutex to be locked
+         */
+        void clear();
+
+        mutable boost::mutex mMutex;
+        size_t mCapacity;
+        std::string mDirectory;
+
+        // Key and content of the stored files, most recently used entries are at the front
+        typedef std::pair<std::string, std::string> Entry;
+        std::list<Entry> mEntries;
+        std::map<std::string, std::list<Entry>::iterator> mIndex;
+
+        uint64_t mWrites;
+        uint64_t mLinks;
+    };
+}
+#endif // PDDL_PLANNER_INPUT_STORE_HPP
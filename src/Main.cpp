@@ -53,7 +53,10 @@
 #include <map>
 #include <set>
 #include <errno.h>
+#include <fstream>
+#include <iterator>
 #include <pddl_planner/Planning.hpp>
+#include <pddl_planner/representation/Parser.hpp>
 #include <cstring>
 #include <cstdlib>
 #include <unistd.h>
@@ -67,6 +70,17 @@ std::set<std::string> planners;
 pddl_planner::Planning planning;
 std::string problemDescription;
 
+bool readFile(const std::string& filename, std::string& content)
+{
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    if(!file)
+    {
+        return false;
+    }
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
 void usage(int argc, char** argv)
 {
     printf("usage: %s [-p <planner-name>] [-t <timeout-seconds(float)>] <domain-description-file> <problem-file>\n",argv[0]);
@@ -236,37 +250,34 @@ int main(int argc, char** argv)
         exit(0);
     }
 
-    FILE* domainFile = fopen(domainFilename.c_str(),"r"); 
-    if(!domainFile)
+    std::string domainDescription;
+    if(!readFile(domainFilename, domainDescription))
     {
         printf("Error opening file: '%s' -- %s", domainFilename.c_str(), strerror(errno));
         exit(-1);
     }
-
-    char buffer[512];
-    std::string domainDescription;
-
-    while(fgets(buffer,512,domainFile) != NULL)
-    {
-        domainDescription += std::string(buffer);
-    }
-    fclose(domainFile);
-
-
     planning.setDomainDescription("test-domain", domainDescription);
 
-    FILE* problemFile = fopen(problemFilename.c_str(), "r");
-    if(!problemFile)
+    if(!readFile(problemFilename, problemDescription))
     {
         printf("Error opening file: '%s' -- %s", problemFilename.c_str(), strerror(errno));
         exit(-1);
     }
 
-    while(fgets(buffer, 512, problemFile) != NULL)
+    // Report syntax errors early -- descriptions are nevertheless passed to the planners as
+    // they are, since these might support PDDL features which the parser does not know
+    try {
+        representation::Domain domain = representation::Parser::parseDomain(domainDescription);
+        try {
+            representation::Parser::parseProblem(problemDescription, domain);
+        } catch(const representation::ParseError& e)
+        {
+            printf("Warning: %s: %s\n", problemFilename.c_str(), e.what());
+        }
+    } catch(const representation::ParseError& e)
     {
-        problemDescription += std::string(buffer);
+        printf("Warning: %s: %s\n", domainFilename.c_str(), e.what());
     }
-    fclose(problemFile);
 
 #ifdef INPUT_VERIFICATION
     printf("Input:\n    planner(s)Name  = ");
@@ -289,6 +300,7 @@ int main(int argc, char** argv)
         {
             PlanResult plan = (*it);
             printf("Planner %s:\n%s\n", plan.first.c_str(), plan.second.toString().c_str());
+            printf("    %s\n", plan.second.statistics.toString().c_str());
         }
     }
     catch(const std::runtime_error& e)
@@ -1,17 +1,25 @@
 #include <pddl_planner/PDDLPlannerInterface.hpp>
+#include <pddl_planner/BinaryRegistry.hpp>
+#include <pddl_planner/Process.hpp>
+#include <pddl_planner/WorkspaceManager.hpp>
+#include <pddl_planner/InputStore.hpp>
+#include <pddl_planner/PlanFileWatcher.hpp>
+#include <pddl_planner/CoreAllocator.hpp>
+#include <pddl_planner/Tracer.hpp>
+#include <sys/wait.h>
+#include <signal.h>
 #include <boost/filesystem.hpp>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string.h>
+#include <stdlib.h>
 #include <base/logging.h>
-#include <base/time.h>
-#include <boost/thread.hpp>
 #include <boost/chrono/chrono.hpp>
-#include <signal.h>
 #include <unistd.h>
-#include <cstdlib>
 #include <list>
+#include <algorithm>
+#include <set>
 
 namespace fs = boost::filesystem;
 
@@ -20,108 +28,183 @@ namespace pddl_planner
 
     const std::string PDDLPlannerInterface::msDomainFileBasename = "domain.pddl";
     const std::string PDDLPlannerInterface::msProblemFileBasename = "problem.pddl";
-    const std::string PDDLPlannerInterface::msTempDirBasename = "/tmp";
+    const int PDDLPlannerInterface::msCancellationPollInterval = 10;
 
     bool PDDLPlannerInterface::isAvailable() const
     {
-        std::string cmd = std::string("which ") + getCmd() + " > /dev/null";
-        return 0 == system(cmd.c_str());
+        return BinaryRegistry::getInstance().isAvailable(getCmd());
     }
 
-    void PDDLPlannerInterface::cleanup(const std::string & dir, const std::list<std::string> & files)
+    std::string PDDLPlannerInterface::getExecutable() const
     {
-        std::list<std::string>::const_iterator it = files.begin();
-        for(; files.end() != it; ++it)
+        std::string executable = BinaryRegistry::getInstance().resolve(getCmd());
+        if(executable.empty())
         {
-            boost::filesystem::remove(boost::filesystem::path(*(it)));
+            std::string msg = "Could not find '" + getCmd() + "' planner executable";
+            LOG_ERROR("%s",msg.c_str());
+            throw PlanGenerationException(msg);
         }
-        boost::filesystem::path path(dir);
-        boost::filesystem::remove_all(path);
+        return executable;
+    }
+
+    void PDDLPlannerInterface::setResourceLimits(const ResourceLimits& limits)
+    {
+        boost::unique_lock<boost::mutex> lock(mLimitsMutex);
+        mLimits = limits;
     }
 
-    void run_planner(const std::string & cmd, const std::string & planner, double timeout)
+    ResourceLimits PDDLPlannerInterface::getResourceLimits() const
     {
-        std::string command = cmd + " > /dev/null";
-        int result = system(command.c_str());
-        if(-1 == result)
+        boost::unique_lock<boost::mutex> lock(mLimitsMutex);
+        return mLimits;
+    }
+
+    namespace
+    {
+        void removeAbsoluteFiles(const std::list<std::string> & files)
         {
-            std::string msg = "Error: planner " + planner + " returned an error during execution";
-            LOG_ERROR("%s",msg.c_str());
-            throw PlanGenerationException(msg);
+            // Relative paths refer to files in the planner's working directory, which will
+            // be cleaned up along with the workspace
+            std::list<std::string>::const_iterator it = files.begin();
+            for(; files.end() != it; ++it)
+            {
+                boost::filesystem::path file(*it);
+                if(file.is_absolute())
+                {
+                    boost::filesystem::remove(file);
+                }
+            }
         }
-        if(result)
+    }
+
+    void PDDLPlannerInterface::cleanup(const std::string & dir, const std::list<std::string> & files)
+    {
+        removeAbsoluteFiles(files);
+        WorkspaceManager::getInstance().release(dir);
+    }
+
+    void PDDLPlannerInterface::cleanup(const PlannerCall& call, const std::list<std::string> & files)
+    {
+        removeAbsoluteFiles(files);
+        if(call.workspace)
         {
-             LOG_WARN("Planner %s returned non-zero exit status", planner.c_str());
+            call.workspace->release();
+        } else {
+            WorkspaceManager::getInstance().release(call.tempDir);
         }
     }
 
-    void PDDLPlannerInterface::prepare(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions)
+    PlannerCall PDDLPlannerInterface::prepare(const std::string& tag, const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout) const
     {
-        mDomainFilename = mTempDir + "/" + msDomainFileBasename;
-        std::ofstream out(mDomainFilename.c_str());
+        PlannerCall call;
+        call.timeout = timeout;
+        TraceSpan workspaceSpan("workspace", tag);
+        call.workspace.reset(new WorkspaceLease(tag));
+        call.tempDir = call.workspace->getPath();
+        workspaceSpan.end();
 
-        out << domainDescriptions;
-        out << "\n";
-        out << actionDescriptions;
+        // Planners of the same request share their input files
+        TraceSpan inputSpan("write inputs", tag);
+        call.domainFilename = call.tempDir + "/" + msDomainFileBasename;
+        InputStore::getInstance().provide(domainDescriptions + "\n" + actionDescriptions, call.domainFilename);
 
-        out.close();
-
-        mProblemFilename = mTempDir + "/" + msProblemFileBasename;
-        std::ofstream problemOut(mProblemFilename.c_str());
+        call.problemFilename = call.tempDir + "/" + msProblemFileBasename;
         LOG_DEBUG("Prepare problem '%s'", problem.c_str());
-        problemOut << problem;
-        problemOut << "\n";
-        problemOut.close();
+        InputStore::getInstance().provide(problem + "\n", call.problemFilename);
 
-        mResultFilename = mTempDir + "/" + msResultFileBasename;
+        call.resultFilename = call.tempDir + "/" + msResultFileBasename;
+        return call;
     }
 
-    PlanCandidates PDDLPlannerInterface::generateCandidates(const std::string & cmd, const std::string & tempDir, const std::string & resultFilename, const std::list<std::string> & patternList, double timeout, const std::string & planner)
+    PlanCandidates PDDLPlannerInterface::generateCandidates(const std::vector<std::string> & arguments, const std::string & tempDir, const std::string & resultFilename, double timeout, const std::string & planner, const CancellationToken& token, const PlanCallback& callback)
     {
-        int res = chdir(tempDir.c_str());
-        if(-1 == res)
+        if(token.isCancelled())
         {
-            LOG_ERROR("Error: failed to change current working directory for planner %s.\n    %s\n", planner.c_str(), strerror(errno));
-            exit(1);
+            LOG_INFO("Planner %s has been cancelled before being started", planner.c_str());
+            PlanCandidates planCandidates;
+            planCandidates.statistics.cancelled = true;
+            return planCandidates;
         }
-        boost::thread run_planner_thread(run_planner, cmd, planner, timeout + 0.001);
-        bool result = run_planner_thread.try_join_for(boost::chrono::milliseconds((int)(1000. * timeout)));
-        if(!result)
+
+        // Watch before starting, so that no plan file can be missed
+        PlanFileWatcher watcher(tempDir, resultFilename);
+        PlanCandidates planCandidates;
+        std::set<std::string> readFiles;
+
+        // Planners running at the same time get disjoint cores, which are held until the
+        // planner process tree has been reaped
+        CoreReservation cores;
+        ResourceLimits limits = getResourceLimits();
+        if(!cores.getCores().empty())
         {
-            LOG_WARN("Planner %s timed out: killing it...", planner.c_str());
-            std::string command = "pkill --signal 9 -f \"" + cmd + "\"";
-            int return_code = system(command.c_str());
-            bool error = false;
-            if(patternList.empty())
+            limits.cpus = cores.getCores();
+        }
+
+        // The planner runs with the temporary directory as working directory, while the
+        // working directory of this process is never changed
+        Process process(arguments, tempDir, limits);
+        TraceSpan startSpan("process start", planner);
+        try {
+            process.start();
+        } catch(const PlanGenerationException& e)
+        {
+            std::string msg = "Error: planner " + planner + " could not be started: " + e.what();
+            LOG_ERROR("%s",msg.c_str());
+            throw PlanGenerationException(msg);
+        }
+        startSpan.end();
+
+        // Wait in slices, so that a cancellation request is served without waiting for
+        // the full timeout, and plans are delivered while the planner is still searching
+        boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+        boost::chrono::steady_clock::time_point deadline = start + boost::chrono::milliseconds((int)(1000. * timeout));
+        PlannerStatistics& statistics = planCandidates.statistics;
+        bool result = false;
+        TraceSpan searchSpan("search", planner);
+        while(!result && !token.isCancelled())
+        {
+            double remaining = boost::chrono::duration<double>(deadline - boost::chrono::steady_clock::now()).count();
+            if(remaining <= 0)
             {
-                LOG_WARN("Planner %s does not provide any patterns in its individual implementation", planner.c_str());
+                break;
             }
-            else
+            result = process.waitFor(std::min(remaining, msCancellationPollInterval / 1000.));
+            collectPlans(watcher.readCompletedFiles(), planner, callback, readFiles, planCandidates);
+            if(statistics.timeToFirstPlan < 0 && !planCandidates.plans.empty())
             {
-                for(std::list<std::string>::const_iterator it = patternList.begin(); !error && it != patternList.end(); ++it)
-                {
-                    std::string command_list = "pkill --signal 9 -f " + (*it); 
-                    if(-1 == system(command_list.c_str()))
-                    {
-                        error = true;
-                    }
-                }
+                statistics.timeToFirstPlan = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
             }
-            if(-1 == return_code || error)
+        }
+        searchSpan.end();
+
+        if(!result)
+        {
+            TraceSpan killSpan("kill", planner);
+            if(token.isCancelled())
             {
-                std::string msg = "Error: planner " + planner + " could not be killed";
-                LOG_ERROR("%s",msg.c_str());
-                throw PlanGenerationException(msg);
+                LOG_INFO("Planner %s has been cancelled: killing it...", planner.c_str());
+                statistics.cancelled = true;
+            } else {
+                LOG_WARN("Planner %s timed out: killing it...", planner.c_str());
+                statistics.timedOut = true;
             }
+            process.kill();
             LOG_WARN("Planner %s has been successfully killed", planner.c_str());
-        }
-        res = chdir("/");
-        if(-1 == res)
+        } else if(WIFSIGNALED(process.getExitStatus()) && WTERMSIG(process.getExitStatus()) == SIGXCPU)
+        {
+            LOG_WARN("Planner %s exceeded its CPU time limit", planner.c_str());
+        } else if(process.getExitStatus())
         {
-            LOG_ERROR("Error: failed to change current working directory for planner %s.\n    %s\n", planner.c_str(), strerror(errno));
-            exit(1);
+            LOG_WARN("Planner %s returned non-zero exit status", planner.c_str());
         }
-        PlanCandidates planCandidates;
+        collectPlans(watcher.readCompletedFiles(), planner, callback, readFiles, planCandidates);
+
+        const struct rusage& usage = process.getResourceUsage();
+        statistics.wallTime = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+        statistics.userTime = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+        statistics.systemTime = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+        statistics.peakMemory = usage.ru_maxrss;
+        statistics.exitStatus = process.getExitStatus();
 
         fs::path directory(tempDir);
 
@@ -133,76 +216,202 @@ namespace pddl_planner
             throw PlanGenerationException(ss.str());
         }
 
+        // A killed planner might have left a partially written file behind, which
+        // can only be told apart from complete plans when the watcher saw all events
+        bool trustWatcher = watcher.isValid() && !watcher.hasOverflown();
+        TraceSpan scanSpan("scan results", planner);
+        std::vector<std::string> files;
         fs::directory_iterator dirIt(directory);
         for(; dirIt != fs::directory_iterator(); dirIt++)
         {
             std::string file = dirIt->path().string();
-            if( boost::algorithm::find_first(file, resultFilename))
+            if( boost::algorithm::find_first(file, resultFilename) && !readFiles.count(file))
             {
-                LOG_DEBUG("Found result file: %s", file.c_str());
-                try {
-                    Plan plan = readPlan(getName(), file);
-                    planCandidates.addPlan(plan);
-                } catch(const PlanGenerationException& e)
+                if(trustWatcher && !result)
                 {
-                    LOG_WARN("Error reading plan: %s", e.what());
+                    LOG_WARN("Planner %s: ignoring incomplete result file %s", planner.c_str(), file.c_str());
+                    continue;
                 }
+                files.push_back(file);
             }
         }
+        std::sort(files.begin(), files.end());
+        scanSpan.end();
+        collectPlans(files, planner, callback, readFiles, planCandidates);
+        if(statistics.timeToFirstPlan < 0 && !planCandidates.plans.empty())
+        {
+            statistics.timeToFirstPlan = statistics.wallTime;
+        }
+        planCandidates.updateStatistics();
+        LOG_DEBUG("Planner %s: %s", planner.c_str(), statistics.toString().c_str());
         return planCandidates;
     }
 
-    Plan PDDLPlannerInterface::readPlan(const std::string& plannerName, const std::string& filename)
+    void PDDLPlannerInterface::collectPlans(const std::vector<std::string>& files, const std::string& planner, const PlanCallback& callback, std::set<std::string>& readFiles, PlanCandidates& planCandidates)
     {
-        Plan plan;
-        FILE* resultFile = fopen(filename.c_str(), "r");
-        if(!resultFile)
+        std::vector<std::string>::const_iterator it = files.begin();
+        for(; it != files.end(); ++it)
         {
-            char buffer[512];
-            snprintf(buffer, 512, "%s: could not open '%s'", plannerName.c_str(), filename.c_str());
-            LOG_ERROR("%s", buffer);
-            throw PlanGenerationException(buffer);
+            // A file might be rewritten, but each plan is only delivered once
+            if(!readFiles.insert(*it).second)
+            {
+                continue;
+            }
+
+            LOG_DEBUG("Planner %s: found result file: %s", planner.c_str(), it->c_str());
+            try {
+                TraceSpan readSpan("read plan", *it);
+                Plan plan = readPlan(getName(), *it);
+                readSpan.end();
+                planCandidates.addPlan(plan);
+                if(callback)
+                {
+                    callback(plan);
+                }
+            } catch(const PlanGenerationException& e)
+            {
+                LOG_WARN("Planner %s: error reading plan: %s", planner.c_str(), e.what());
+            }
         }
+    }
 
-        size_t bufferSize = 2048;
-        char buffer[bufferSize];
-        while( NULL != fgets(buffer, bufferSize, resultFile) )
+    namespace
+    {
+        inline bool isBlank(char c)
         {
-            std::string readline(buffer);
-            // Result file contains
-            // (action <arg1> <arg2> ... <argN>) 
-            size_t pos = readline.find_first_of('(');
-            size_t endpos = readline.find_last_of(')');
-            readline = readline.substr(pos + 1, endpos-1);
+            return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+        }
 
-            // Split on whitespace
-            pos = readline.find_first_of(" ");
-            Action action;
-            if(pos == std::string::npos)
+        /**
+         * Parse a comment of a plan file, which might report the cost of the plan, i.e.
+         * '; cost = <N> (<cost type>)'
+         */
+        void parsePlanComment(const char* pos, const char* end, Plan& plan)
+        {
+            static const char costKey[] = "cost";
+            while(pos != end && (*pos == ';' || isBlank(*pos)))
             {
-                // There is an action without arguments
-                action.name = std::string(readline);
-                plan.addAction(action);
-                continue;
-            } else {
-                action.name = readline.substr(0,pos);
+                ++pos;
+            }
+            if(end - pos < (std::ptrdiff_t) sizeof(costKey) || strncmp(pos, costKey, sizeof(costKey) - 1))
+            {
+                return;
+            }
+            pos += sizeof(costKey) - 1;
+            while(pos != end && isBlank(*pos))
+            {
+                ++pos;
+            }
+            if(pos == end || *pos != '=')
+            {
+                return;
+            }
+
+            // The line is not null-terminated, so copy the number
+            std::string number(pos + 1, end);
+            char* numberEnd = NULL;
+            double cost = strtod(number.c_str(), &numberEnd);
+            if(numberEnd != number.c_str() && cost >= 0)
+            {
+                plan.cost = cost;
+            }
+        }
+
+        /**
+         * Parse a single line of a plan file, i.e. '(action <arg1> <arg2> ... <argN>)' which
+         * might be followed by a comment -- lines without an action are ignored
+         */
+        void parsePlanLine(const char* pos, const char* end, Plan& plan)
+        {
+            const char* comment = static_cast<const char*>(memchr(pos, ';', end - pos));
+            if(comment)
+            {
+                parsePlanComment(comment, end, plan);
+                end = comment;
+            }
+
+            pos = static_cast<const char*>(memchr(pos, '(', end - pos));
+            if(!pos)
+            {
+                return;
+            }
+            ++pos;
+
+            const char* closing = static_cast<const char*>(memchr(pos, ')', end - pos));
+            if(closing)
+            {
+                end = closing;
             }
 
-            while(true)
+            plan.action_sequence.push_back(Action());
+            Action& action = plan.action_sequence.back();
+            while(pos != end)
             {
-                readline = readline.substr(pos+1);
-                pos = readline.find_first_of(" ");
-                if(pos == std::string::npos)
+                while(pos != end && isBlank(*pos))
+                {
+                    ++pos;
+                }
+                const char* token = pos;
+                while(pos != end && !isBlank(*pos))
+                {
+                    ++pos;
+                }
+                if(token == pos)
                 {
-                    std::string argument(readline);
-                    action.addArgument( argument );
                     break;
+                }
+
+                if(action.name.empty())
+                {
+                    action.name.assign(token, pos);
                 } else {
-                    std::string argument = readline.substr(0,pos);
-                    action.addArgument( argument );
+                    action.arguments.push_back(std::string(token, pos));
                 }
             }
-            plan.addAction(action);
+
+            if(action.name.empty())
+            {
+                plan.action_sequence.pop_back();
+            }
+        }
+    }
+
+    Plan PDDLPlannerInterface::readPlan(const std::string& plannerName, const std::string& filename)
+    {
+        std::ifstream resultFile(filename.c_str(), std::ios::in | std::ios::binary);
+        if(!resultFile)
+        {
+            char buffer[512];
+            snprintf(buffer, 512, "%s: could not open '%s'", plannerName.c_str(), filename.c_str());
+            LOG_ERROR("%s", buffer);
+            throw PlanGenerationException(buffer);
+        }
+
+        // Read the file in one go and tokenize it in place
+        std::string content;
+        resultFile.seekg(0, std::ios::end);
+        std::streamoff size = resultFile.tellg();
+        if(size > 0)
+        {
+            content.resize(size);
+            resultFile.seekg(0, std::ios::beg);
+            resultFile.read(&content[0], size);
+            content.resize(resultFile.gcount());
+        }
+
+        Plan plan;
+        const char* pos = content.data();
+        const char* end = pos + content.size();
+        plan.action_sequence.reserve(std::count(pos, end, '\n') + 1);
+        while(pos < end)
+        {
+            const char* lineEnd = static_cast<const char*>(memchr(pos, '\n', end - pos));
+            if(!lineEnd)
+            {
+                lineEnd = end;
+            }
+            parsePlanLine(pos, lineEnd, plan);
+            pos = lineEnd + 1;
         }
 
         return plan;
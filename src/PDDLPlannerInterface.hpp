@@ -2,10 +2,38 @@
 #define PDDL_PLANNER_INTERFACE_H
 
 #include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <pddl_planner/CancellationToken.hpp>
+#include <pddl_planner/Process.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <list>
+#include <set>
+#include <vector>
 
 namespace pddl_planner
 {
+    // Callback receiving each plan as soon as a planner has written it
+    typedef boost::function<void (const Plan& plan)> PlanCallback;
+
+    class WorkspaceLease;
+
+    /**
+     * Files and settings of a single planner call -- they are kept per call,
+     * so that one planner instance can serve concurrent calls
+     */
+    struct PlannerCall
+    {
+        double timeout;
+        // Workspace which serves as the planner's working directory -- it is released
+        // by cleanup(), or when the last copy of the call is destroyed, e.g. after an exception
+        boost::shared_ptr<WorkspaceLease> workspace;
+        std::string tempDir;
+        std::string domainFilename;
+        std::string problemFilename;
+        std::string resultFilename;
+    };
+
     class PDDLPlannerInterface
     {
     public:
@@ -14,27 +42,74 @@ namespace pddl_planner
         /**
          * Check if the given planner is available, i.e. standard implementation
          * uses checks availability via the command returned by getCmd()
+         * The lookup is cached by the BinaryRegistry
          * \return true if planner is callable, false otherwise
          */
         virtual bool isAvailable() const;
 
         /**
-         * removes listed files and additionally completely removes the provided directory
+         * Check if the planner runs on another host, i.e. a call only waits for the
+         * remote worker -- such calls run in ThreadPool::getRemote()
+         * \return true if the planner runs remotely, false otherwise
+         */
+        virtual bool isRemote() const { return false; }
+
+        /**
+         * Get the absolute path of the planner's executable as provided by getCmd()
+         * \return absolute path of the executable
+         * \throws PlanGenerationException if the executable cannot be found
+         */
+        std::string getExecutable() const;
+
+        /**
+         * Set the resource limits of the planner processes started by this planner -- if core
+         * allocation is enabled in the CoreAllocator, the allocated cores replace the cores
+         * given here
+         * In-process planners and planners running on other hosts ignore the limits
+         */
+        void setResourceLimits(const ResourceLimits& limits);
+
+        /**
+         * Get the resource limits of the planner processes
+         * \return resource limits
+         */
+        ResourceLimits getResourceLimits() const;
+
+        /**
+         * removes listed files and hands the provided directory back to the WorkspaceManager,
+         * which removes its content asynchronously
          * \param dir name of dir to be completely removed
-         * \param files the list of file names to be removed
+         * \param files the list of file names to be removed, relative file names refer to files in dir
          */
         void cleanup(const std::string & dir, const std::list<std::string> & files);
 
+        /**
+         * removes listed files and releases the workspace of the given planner call
+         * \param call planner call as returned by prepare()
+         * \param files the list of file names to be removed, relative file names refer to files in
+         * the workspace
+         */
+        void cleanup(const PlannerCall& call, const std::list<std::string> & files);
+
         /**
          * Generate the plan candidates for the given problem
          * There is no priority in the order of candidates
+         * The planner process tree will be killed when the timeout expires or when cancellation
+         * is requested via the given token
+         * The planner runs with the resource limits of this planner and the cores, which the
+         * CoreAllocator hands out for the duration of the call
+         * \param arguments Command line of the planner, starting with the planner's executable
+         * \param callback Callback which gets each plan as soon as the planner has completely
+         * written the corresponding file, i.e. while the planner is still searching for better plans
          * \throws PlanGenerationException
          */
-        PlanCandidates generateCandidates(const std::string & cmd, const std::string & tempDir, const std::string & resultFilename, const std::list<std::string> & patternList, double timeout, const std::string & planner = "");
+        PlanCandidates generateCandidates(const std::vector<std::string> & arguments, const std::string & tempDir, const std::string & resultFilename, double timeout, const std::string & planner = "", const CancellationToken& token = CancellationToken(), const PlanCallback& callback = PlanCallback());
 
 
         /**
-         * Read a plani
+         * Read a plan, i.e. a file with one action '(action <arg1> ... <argN>)' per line
+         * Lines of arbitrary length are supported, comments starting with ';' such as
+         * cost annotations and lines without an action are ignored
          * Note, that an empty plan is a valid plan
          * \throws PlanGenerationException
          */
@@ -63,29 +138,38 @@ namespace pddl_planner
 
         /**
          * Planning method that forwards problem, actions and domain to the underlying planning instance
+         * \param token Token to cancel the planner call prematurely
+         * \param callback Callback which gets each plan as soon as it is available
          * \return Solutions candidates
          * \throws PlanGenerationException if not implemented
          */
-        virtual PlanCandidates plan(const std::string& problem, const std::string& actions, const std::string& domain, double timeout) { throw PlanGenerationException("Plan method not implemented"); }
+        virtual PlanCandidates plan(const std::string& problem, const std::string& actions, const std::string& domain, double timeout, const CancellationToken& token = CancellationToken(), const PlanCallback& callback = PlanCallback()) { throw PlanGenerationException("Plan method not implemented"); }
 
     protected:
         /**
-         *
+         * Acquire a workspace and write the domain and problem files of a planner call into it
+         * \param tag Tag of the workspace, see WorkspaceManager::acquire
+         * \param timeout Timeout in seconds for the planner call
+         * \return files and settings of the planner call
+         * \throws PlanGenerationException if no workspace could be acquired
          */
-        void prepare(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions);
+        PlannerCall prepare(const std::string& tag, const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout) const;
 
-        double      mTimeout;
-        std::string mTempDir;
-        std::string mDomainFilename;
-        std::string mProblemFilename;
-        std::string mResultFilename;
+        /**
+         * Read the plans from the given files, which have not been read yet
+         * \param readFiles Files which have already been read -- will be updated
+         */
+        void collectPlans(const std::vector<std::string>& files, const std::string& planner, const PlanCallback& callback, std::set<std::string>& readFiles, PlanCandidates& planCandidates);
 
         std::string msResultFileBasename;
         const static std::string msProblemFileBasename;
         const static std::string msDomainFileBasename;
-        const static std::string msTempDirBasename;
+        // Interval in milliseconds at which a running planner checks for cancellation
+        const static int msCancellationPollInterval;
 
-        Plan mPlan;
+    private:
+        mutable boost::mutex mLimitsMutex;
+        ResourceLimits mLimits;
     };
 
 }
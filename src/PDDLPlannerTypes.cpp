@@ -1,4 +1,5 @@
 #include "PDDLPlannerTypes.hpp"
+#include <algorithm>
 
 namespace pddl_planner
 {
@@ -42,11 +43,60 @@ std::string Plan::toString() const
 }
 
 
+std::string PlannerStatistics::toString() const
+{
+    std::stringstream ss;
+    ss << "wall time: " << wallTime << " s";
+    ss << ", first plan: " << timeToFirstPlan << " s";
+    ss << ", cpu: " << userTime << " s user / " << systemTime << " s sys";
+    ss << ", peak memory: " << peakMemory << " kB";
+    ss << ", exit status: " << exitStatus;
+    if(timedOut)
+    {
+        ss << ", timed out";
+    }
+    if(cancelled)
+    {
+        ss << ", cancelled";
+    }
+    if(cached)
+    {
+        ss << ", cached";
+    }
+    if(unsolvable)
+    {
+        ss << ", unsolvable";
+    }
+    ss << ", plans: " << planCount;
+    if(planCount > 0)
+    {
+        ss << " with " << shortestPlanLength << "-" << longestPlanLength << " actions";
+    }
+    return ss.str();
+}
+
 void PlanCandidates::addPlan(const Plan& plan)
 {
     plans.push_back(plan);
 }
 
+void PlanCandidates::updateStatistics()
+{
+    statistics.planCount = plans.size();
+    statistics.shortestPlanLength = 0;
+    statistics.longestPlanLength = 0;
+    std::vector<Plan>::const_iterator it = plans.begin();
+    for(; it != plans.end(); ++it)
+    {
+        size_t length = it->action_sequence.size();
+        if(it == plans.begin() || length < statistics.shortestPlanLength)
+        {
+            statistics.shortestPlanLength = length;
+        }
+        statistics.longestPlanLength = std::max(statistics.longestPlanLength, length);
+    }
+}
+
 std::string PlanCandidates::toString() const
 {
     std::string candidates;
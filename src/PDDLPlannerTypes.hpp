@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <utility>
 #include <sstream>
 #include <stdexcept>
 #include <boost/algorithm/string.hpp>
@@ -48,7 +49,19 @@ namespace pddl_planner
     // Plan as a sequence of actions
     struct Plan
     {
+        Plan()
+            : cost(-1.0)
+        {}
+
         std::vector<Action> action_sequence;
+        // Cost as reported by the planner, e.g. via a '; cost = N' line in the plan file,
+        // -1 if the planner does not report it
+        double cost;
+
+        /**
+         * Check if the planner reported the cost of the plan
+         */
+        bool hasCost() const { return cost >= 0; }
 
         /**
          * Add an action to the plan
@@ -63,9 +76,66 @@ namespace pddl_planner
         std::string toString() const;
     };
 
+    /**
+     * Timing and resource usage of a single planner call
+     * \details Resource usage refers to the planner process and those of its descendants
+     * which the planner has waited for -- it is not available for in-process planners
+     * and for results taken from the plan cache
+     */
+    struct PlannerStatistics
+    {
+        PlannerStatistics()
+            : wallTime(0.0)
+            , timeToFirstPlan(-1.0)
+            , userTime(0.0)
+            , systemTime(0.0)
+            , peakMemory(0)
+            , exitStatus(-1)
+            , timedOut(false)
+            , cancelled(false)
+            , cached(false)
+            , unsolvable(false)
+            , planCount(0)
+            , shortestPlanLength(0)
+            , longestPlanLength(0)
+        {}
+
+        // Duration of the planner call in seconds
+        double wallTime;
+        // Time in seconds until the first plan was available, -1 if there is none
+        double timeToFirstPlan;
+        // CPU time in seconds
+        double userTime;
+        double systemTime;
+        // Peak resident set size in kilobytes
+        long peakMemory;
+        // Exit status of the planner process as provided by waitpid, -1 if not available
+        int exitStatus;
+        // Planner has been killed since the timeout expired
+        bool timedOut;
+        // Planner has been killed since the call has been cancelled
+        bool cancelled;
+        // Plans have been taken from the plan cache
+        bool cached;
+        // Problem has been rejected as provably unsolvable without calling the planner,
+        // see Planning::enableReachabilityCheck
+        bool unsolvable;
+        size_t planCount;
+        // Number of actions of the shortest and the longest plan
+        size_t shortestPlanLength;
+        size_t longestPlanLength;
+
+        /**
+         * Create string representation of class
+         * \return string representation
+         */
+        std::string toString() const;
+    };
+
     struct PlanCandidates
     {
         std::vector<Plan> plans;
+        PlannerStatistics statistics;
 
         /**
          * Add a plan to the list of plan candidates
@@ -73,6 +143,11 @@ namespace pddl_planner
          */
         void addPlan(const Plan& plan);
 
+        /**
+         * Update the plan count and plan lengths of the statistics
+         */
+        void updateStatistics();
+
         /**
          * Create string representation of class
          * \return string representation
@@ -80,6 +155,8 @@ namespace pddl_planner
         std::string toString() const;
     };
 
-
+    typedef std::string PlannerName;
+    typedef std::pair<PlannerName, PlanCandidates> PlanResult;
+    typedef std::vector< PlanResult > PlanResultList;
 }
 #endif // PDDL_PLANNER_TYPES
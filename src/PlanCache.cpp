@@ -0,0 +1,349 @@
+#include <pddl_planner/PlanCache.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
+#include <base/logging.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cctype>
+#include <stdio.h>
+
+namespace fs = boost::filesystem;
+
+namespace pddl_planner
+{
+
+namespace
+{
+    const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+    const uint64_t FNV_PRIME = 1099511628211ULL;
+
+    // Marker line separating the plans of a cache file
+    const std::string PLAN_MARKER = "; plan";
+    // Line reporting the cost of the preceding plan, as in plan files
+    const char COST_FORMAT[] = "; cost = %lf";
+
+    // Line announcing the length of the normalized request which follows it
+    const char REQUEST_FORMAT[] = "; request = %lu";
+
+    /**
+     * Append a description while skipping comments and normalizing whitespace,
+     * i.e. sequences of whitespace are reduced to a single blank and whitespace next to
+     * parentheses is dropped
+     */
+    void appendNormalized(std::string& request, const std::string& text)
+    {
+        bool pendingBlank = false;
+        char previous = '(';
+        std::string::const_iterator it = text.begin();
+        for(; it != text.end(); ++it)
+        {
+            char c = *it;
+            if(c == ';')
+            {
+                while(it != text.end() && *it != '\n')
+                {
+                    ++it;
+                }
+                pendingBlank = true;
+                if(it == text.end())
+                {
+                    break;
+                }
+                continue;
+            }
+
+            if(isspace(static_cast<unsigned char>(c)))
+            {
+                pendingBlank = true;
+                continue;
+            }
+
+            if(pendingBlank && previous != '(' && c != ')')
+            {
+                request += ' ';
+            }
+            pendingBlank = false;
+
+            request += c;
+            previous = c;
+        }
+        // Separate the individual descriptions
+        request += '\0';
+    }
+}
+
+PlanCache::PlanCache(size_t capacity, const std::string& directory)
+    : mCapacity(capacity)
+    , mDirectory(directory)
+    , mHits(0)
+    , mMisses(0)
+{
+    if(!mDirectory.empty())
+    {
+        boost::system::error_code ec;
+        fs::create_directories(mDirectory, ec);
+        if(!fs::is_directory(mDirectory))
+        {
+            throw PlanGenerationException("PlanCache: could not create directory '" + mDirectory + "'");
+        }
+    }
+}
+
+std::string PlanCache::createRequest(const std::string& plannerName, const std::string& domainDescriptions, const std::string& actionDescriptions, const std::string& problem)
+{
+    std::string request;
+    request.reserve(plannerName.size() + domainDescriptions.size() + actionDescriptions.size() + problem.size() + 4);
+    appendNormalized(request, plannerName);
+    appendNormalized(request, domainDescriptions);
+    appendNormalized(request, actionDescriptions);
+    appendNormalized(request, problem);
+    return request;
+}
+
+std::string PlanCache::createKey(const std::string& plannerName, const std::string& domainDescriptions, const std::string& actionDescriptions, const std::string& problem)
+{
+    return getKey(createRequest(plannerName, domainDescriptions, actionDescriptions, problem));
+}
+
+std::string PlanCache::getKey(const std::string& request)
+{
+    // FNV-1a
+    uint64_t hash = FNV_OFFSET_BASIS;
+    std::string::const_iterator it = request.begin();
+    for(; it != request.end(); ++it)
+    {
+        hash = (hash ^ static_cast<unsigned char>(*it)) * FNV_PRIME;
+    }
+
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << hash << "-" << std::dec << request.size();
+    return ss.str();
+}
+
+bool PlanCache::lookup(const std::string& request, PlanCandidates& planCandidates)
+{
+    std::string key = getKey(request);
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    std::map<std::string, EntryList::iterator>::iterator it = mIndex.find(key);
+    if(it != mIndex.end() && it->second->request == request)
+    {
+        mEntries.splice(mEntries.begin(), mEntries, it->second);
+        planCandidates = it->second->planCandidates;
+        ++mHits;
+        return true;
+    }
+
+    if(!mDirectory.empty() && load(key, request, planCandidates))
+    {
+        insert(key, request, planCandidates);
+        ++mHits;
+        return true;
+    }
+
+    ++mMisses;
+    return false;
+}
+
+bool PlanCache::contains(const std::string& request)
+{
+    std::string key = getKey(request);
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    std::map<std::string, EntryList::iterator>::const_iterator it = mIndex.find(key);
+    if(it != mIndex.end())
+    {
+        return it->second->request == request;
+    }
+
+    PlanCandidates planCandidates;
+    return !mDirectory.empty() && load(key, request, planCandidates);
+}
+
+void PlanCache::store(const std::string& request, const PlanCandidates& planCandidates)
+{
+    std::string key = getKey(request);
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    insert(key, request, planCandidates);
+    if(!mDirectory.empty())
+    {
+        save(key, request, planCandidates);
+    }
+}
+
+void PlanCache::clear()
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mEntries.clear();
+    mIndex.clear();
+
+    if(!mDirectory.empty())
+    {
+        boost::system::error_code ec;
+        fs::directory_iterator dirIt(mDirectory, ec);
+        for(; !ec && dirIt != fs::directory_iterator(); dirIt.increment(ec))
+        {
+            if(dirIt->path().extension() == ".plans")
+            {
+                boost::system::error_code removeEc;
+                fs::remove(dirIt->path(), removeEc);
+            }
+        }
+    }
+}
+
+uint64_t PlanCache::getHits() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mHits;
+}
+
+uint64_t PlanCache::getMisses() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mMisses;
+}
+
+size_t PlanCache::size() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mEntries.size();
+}
+
+void PlanCache::insert(const std::string& key, const std::string& request, const PlanCandidates& planCandidates)
+{
+    // An entry with the same key is replaced, even if it belongs to a different request
+    std::map<std::string, EntryList::iterator>::iterator it = mIndex.find(key);
+    if(it != mIndex.end())
+    {
+        mEntries.erase(it->second);
+        mIndex.erase(it);
+    }
+
+    if(0 == mCapacity)
+    {
+        return;
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.request = request;
+    entry.planCandidates = planCandidates;
+    mEntries.push_front(entry);
+    mIndex[key] = mEntries.begin();
+
+    while(mEntries.size() > mCapacity)
+    {
+        mIndex.erase(mEntries.back().key);
+        mEntries.pop_back();
+    }
+}
+
+std::string PlanCache::getFilename(const std::string& key) const
+{
+    return (fs::path(mDirectory) / (key + ".plans")).string();
+}
+
+bool PlanCache::load(const std::string& key, const std::string& request, PlanCandidates& planCandidates) const
+{
+    std::ifstream in(getFilename(key).c_str(), std::ios::binary);
+    if(!in.is_open())
+    {
+        return false;
+    }
+
+    // The entry is only valid for the request it has been stored for
+    std::string line;
+    unsigned long requestSize = 0;
+    std::getline(in, line);
+    if(!std::getline(in, line) || 1 != sscanf(line.c_str(), REQUEST_FORMAT, &requestSize) || requestSize != request.size())
+    {
+        return false;
+    }
+    std::string storedRequest(requestSize, '\0');
+    in.read(&storedRequest[0], requestSize);
+    if(!in || storedRequest != request)
+    {
+        LOG_DEBUG("PlanCache: cache file '%s' belongs to another request", getFilename(key).c_str());
+        return false;
+    }
+
+    PlanCandidates candidates;
+    while(std::getline(in, line))
+    {
+        boost::algorithm::trim(line);
+        double cost;
+        if(line == PLAN_MARKER)
+        {
+            candidates.addPlan(Plan());
+        } else if(!candidates.plans.empty() && 1 == sscanf(line.c_str(), COST_FORMAT, &cost))
+        {
+            candidates.plans.back().cost = cost;
+        } else if(!line.empty() && line[0] == '(' && !candidates.plans.empty())
+        {
+            std::vector<std::string> tokens;
+            std::string action = line.substr(1, line.find_last_of(')') - 1);
+            boost::algorithm::trim(action);
+            boost::split(tokens, action, boost::is_space(), boost::token_compress_on);
+
+            Action a(tokens.front());
+            for(size_t i = 1; i < tokens.size(); ++i)
+            {
+                a.addArgument(tokens[i]);
+            }
+            candidates.plans.back().addAction(a);
+        }
+    }
+
+    if(candidates.plans.empty())
+    {
+        LOG_WARN("PlanCache: ignoring invalid cache file '%s'", getFilename(key).c_str());
+        return false;
+    }
+    planCandidates = candidates;
+    return true;
+}
+
+void PlanCache::save(const std::string& key, const std::string& request, const PlanCandidates& planCandidates) const
+{
+    // Write to a temporary file first, so that readers never see partial entries
+    std::string filename = getFilename(key);
+    std::string tmpFilename = filename + ".tmp";
+    {
+        std::ofstream out(tmpFilename.c_str(), std::ios::binary);
+        out << "; pddl_planner plan cache entry" << std::endl;
+        out << "; request = " << request.size() << std::endl;
+        out.write(request.data(), request.size());
+        out << std::endl;
+        std::vector<Plan>::const_iterator pit = planCandidates.plans.begin();
+        for(; pit != planCandidates.plans.end(); ++pit)
+        {
+            out << PLAN_MARKER << std::endl;
+            if(pit->hasCost())
+            {
+                out << "; cost = " << pit->cost << std::endl;
+            }
+            std::vector<Action>::const_iterator ait = pit->action_sequence.begin();
+            for(; ait != pit->action_sequence.end(); ++ait)
+            {
+                out << "(" << ait->toString() << ")" << std::endl;
+            }
+        }
+        if(!out.good())
+        {
+            LOG_WARN("PlanCache: failed to write cache file '%s'", tmpFilename.c_str());
+            return;
+        }
+    }
+
+    boost::system::error_code ec;
+    fs::rename(tmpFilename, filename, ec);
+    if(ec)
+    {
+        LOG_WARN("PlanCache: failed to store cache file '%s': %s", filename.c_str(), ec.message().c_str());
+    }
+}
+
+} // end namespace pddl_planner
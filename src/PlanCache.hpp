@@ -0,0 +1,126 @@
+#ifndef PDDL_PLANNER_PLAN_CACHE_HPP
+#define PDDL_PLANNER_PLAN_CACHE_HPP
+
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <boost/thread/mutex.hpp>
+#include <stdint.h>
+#include <string>
+#include <list>
+#include <map>
+
+namespace pddl_planner
+{
+    /**
+     * \class PlanCache
+     * \brief Cache for plan candidates keyed by a hash of the planner, domain and problem
+     * \details The cache keeps the most recently used entries in memory and optionally
+     * stores all entries in a directory, so that they survive restarts. Each entry keeps
+     * the normalized request it has been stored for, which is compared on lookup, so that
+     * a hash collision is a cache miss
+     */
+    class PlanCache
+    {
+    public:
+        /**
+         * Constructor
+         * \param capacity Maximum number of entries kept in memory
+         * \param directory Directory for persistent storage, an empty string disables
+         * the persistent storage
+         * \throws PlanGenerationException if directory cannot be created
+         */
+        PlanCache(size_t capacity = 128, const std::string& directory = "");
+
+        /**
+         * Create the normalized planning request, i.e. comments and whitespace in the
+         * descriptions are normalized
+         * \return normalized request
+         */
+        static std::string createRequest(const std::string& plannerName, const std::string& domainDescriptions, const std::string& actionDescriptions, const std::string& problem);
+
+        /**
+         * Create the key for a planning request, i.e. a hash of the normalized request
+         * \return key
+         */
+        static std::string createKey(const std::string& plannerName, const std::string& domainDescriptions, const std::string& actionDescriptions, const std::string& problem);
+
+        /**
+         * Get the key of a normalized request, i.e. a hash of the request
+         * \param request Normalized request as returned by createRequest
+         * \return key
+         */
+        static std::string getKey(const std::string& request);
+
+        /**
+         * Lookup plan candidates
+         * \param request Normalized request as returned by createRequest
+         * \param planCandidates Plan candidates that have been found
+         * \return true on cache hit, false otherwise
+         */
+        bool lookup(const std::string& request, PlanCandidates& planCandidates);
+
+        /**
+         * Check whether plan candidates are available for a request -- unlike lookup, this
+         * neither counts as hit or miss nor marks the entry as recently used
+         * \param request Normalized request as returned by createRequest
+         * \return true if the request is cached, false otherwise
+         */
+        bool contains(const std::string& request);
+
+        /**
+         * Store plan candidates
+         * \param request Normalized request as returned by createRequest
+         * \param planCandidates Plan candidates to store
+         */
+        void store(const std::string& request, const PlanCandidates& planCandidates);
+
+        /**
+         * Remove all entries from memory and from the persistent storage
+         */
+        void clear();
+
+        /**
+         * Get number of cache hits
+         */
+        uint64_t getHits() const;
+
+        /**
+         * Get number of cache misses
+         */
+        uint64_t getMisses() const;
+
+        /**
+         * Get number of entries kept in memory
+         */
+        size_t size() const;
+
+    private:
+        struct Entry
+        {
+            std::string key;
+            std::string request;
+            PlanCandidates planCandidates;
+        };
+        typedef std::list<Entry> EntryList;
+
+        /**
+         * Add entry to memory and evict the least recently used entry if needed
+         */
+        void insert(const std::string& key, const std::string& request, const PlanCandidates& planCandidates);
+
+        std::string getFilename(const std::string& key) const;
+        bool load(const std::string& key, const std::string& request, PlanCandidates& planCandidates) const;
+        void save(const std::string& key, const std::string& request, const PlanCandidates& planCandidates) const;
+
+        mutable boost::mutex mMutex;
+        size_t mCapacity;
+        std::string mDirectory;
+
+        // Most recently used entries are at the front
+        EntryList mEntries;
+        std::map<std::string, EntryList::iterator> mIndex;
+
+        uint64_t mHits;
+        uint64_t mMisses;
+    };
+}
+#endif // PDDL_PLANNER_PLAN_CACHE_HPP
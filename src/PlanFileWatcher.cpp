@@ -0,0 +1,90 @@
+#include <pddl_planner/PlanFileWatcher.hpp>
+#include <base/logging.h>
+#include <boost/algorithm/string.hpp>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <limits.h>
+#include <errno.h>
+#include <string.h>
+
+namespace pddl_planner
+{
+
+PlanFileWatcher::PlanFileWatcher(const std::string& directory, const std::string& resultFilename)
+    : mDirectory(directory)
+    , mResultFilename(resultFilename)
+    , mFd(-1)
+    , mOverflown(false)
+{
+    mFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(mFd < 0)
+    {
+        LOG_WARN("PlanFileWatcher: inotify is not available: %s", strerror(errno));
+        return;
+    }
+
+    if(inotify_add_watch(mFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        LOG_WARN("PlanFileWatcher: could not watch '%s': %s", directory.c_str(), strerror(errno));
+        close(mFd);
+        mFd = -1;
+    }
+}
+
+PlanFileWatcher::~PlanFileWatcher()
+{
+    if(mFd >= 0)
+    {
+        close(mFd);
+    }
+}
+
+std::vector<std::string> PlanFileWatcher::readCompletedFiles()
+{
+    std::vector<std::string> files;
+    if(mFd < 0)
+    {
+        return files;
+    }
+
+    // Buffer suitably aligned for struct inotify_event, and large enough for at least one event
+    char buffer[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    while(true)
+    {
+        ssize_t length = read(mFd, buffer, sizeof(buffer));
+        if(length <= 0)
+        {
+            if(length < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        for(char* ptr = buffer; ptr < buffer + length; )
+        {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if(event->mask & IN_Q_OVERFLOW)
+            {
+                LOG_WARN("PlanFileWatcher: events have been lost for '%s'", mDirectory.c_str());
+                mOverflown = true;
+                continue;
+            }
+
+            if(event->len == 0)
+            {
+                continue;
+            }
+            std::string file = mDirectory + "/" + std::string(event->name);
+            if(boost::algorithm::find_first(file, mResultFilename))
+            {
+                files.push_back(file);
+            }
+        }
+    }
+    return files;
+}
+
+} // end namespace pddl_planner
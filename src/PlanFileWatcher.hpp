@@ -0,0 +1,57 @@
+#ifndef PDDL_PLANNER_PLAN_FILE_WATCHER_HPP
+#define PDDL_PLANNER_PLAN_FILE_WATCHER_HPP
+
+#include <string>
+#include <vector>
+
+namespace pddl_planner
+{
+    /**
+     * \class PlanFileWatcher
+     * \brief Reports plan files in a directory as soon as a planner has completely written them
+     * \details Uses inotify to detect files which have been closed after writing or which have
+     * been moved into the directory. When inotify is not available, the watcher is invalid
+     * and callers have to fall back to scanning the directory
+     */
+    class PlanFileWatcher
+    {
+    public:
+        /**
+         * Constructor
+         * \param directory Directory to watch -- watching starts immediately
+         * \param resultFilename Only files whose path contains this string are reported
+         */
+        PlanFileWatcher(const std::string& directory, const std::string& resultFilename);
+
+        ~PlanFileWatcher();
+
+        /**
+         * Check whether the directory is actually watched
+         * \return true if inotify is in use, false otherwise
+         */
+        bool isValid() const { return mFd >= 0; }
+
+        /**
+         * Check whether events have been lost, so that further files
+         * might have been completed without being reported
+         * \return true if events have been lost
+         */
+        bool hasOverflown() const { return mOverflown; }
+
+        /**
+         * Retrieve the files which have been completed since the last call, without blocking
+         * \return paths of completed files
+         */
+        std::vector<std::string> readCompletedFiles();
+
+    private:
+        PlanFileWatcher(const PlanFileWatcher& other);
+        PlanFileWatcher& operator=(const PlanFileWatcher& other);
+
+        std::string mDirectory;
+        std::string mResultFilename;
+        int mFd;
+        bool mOverflown;
+    };
+}
+#endif // PDDL_PLANNER_PLAN_FILE_WATCHER_HPP
@@ -0,0 +1,101 @@
+#include <pddl_planner/PlanRanking.hpp>
+#include <boost/unordered_map.hpp>
+#include <algorithm>
+
+namespace pddl_planner
+{
+
+namespace
+{
+    struct RankedIndex
+    {
+        double cost;
+        size_t length;
+        size_t index;
+    };
+
+    bool compareByCost(const RankedIndex& a, const RankedIndex& b)
+    {
+        if(a.cost != b.cost)
+        {
+            return a.cost < b.cost;
+        }
+        return a.length < b.length;
+    }
+
+    bool compareByLength(const RankedIndex& a, const RankedIndex& b)
+    {
+        if(a.length != b.length)
+        {
+            return a.length < b.length;
+        }
+        return a.cost < b.cost;
+    }
+}
+
+RankedPlanList PlanRanking::rank(const PlanResultList& planResultList, Order order, const SymbolTablePtr& symbols)
+{
+    RankedPlanList plans;
+    boost::unordered_map<CompactPlan, size_t> indices;
+
+    PlanResultList::const_iterator it = planResultList.begin();
+    for(; it != planResultList.end(); ++it)
+    {
+        std::vector<Plan>::const_iterator pit = it->second.plans.begin();
+        for(; pit != it->second.plans.end(); ++pit)
+        {
+            CompactPlan compactPlan(*pit, symbols);
+            std::pair<boost::unordered_map<CompactPlan, size_t>::iterator, bool> inserted = indices.insert(std::make_pair(compactPlan, plans.size()));
+            if(inserted.second)
+            {
+                plans.push_back(RankedPlan());
+                plans.back().plan = *pit;
+                plans.back().planners.push_back(it->first);
+                continue;
+            }
+
+            RankedPlan& rankedPlan = plans[inserted.first->second];
+            if(pit->hasCost() && (!rankedPlan.plan.hasCost() || pit->cost < rankedPlan.plan.cost))
+            {
+                rankedPlan.plan.cost = pit->cost;
+            }
+            // A planner which writes the same plan twice is listed once
+            if(std::find(rankedPlan.planners.begin(), rankedPlan.planners.end(), it->first) == rankedPlan.planners.end())
+            {
+                rankedPlan.planners.push_back(it->first);
+            }
+        }
+    }
+
+    std::vector<RankedIndex> ranking(plans.size());
+    for(size_t i = 0; i < plans.size(); ++i)
+    {
+        ranking[i].cost = plans[i].getCost();
+        ranking[i].length = plans[i].getLength();
+        ranking[i].index = i;
+    }
+    std::stable_sort(ranking.begin(), ranking.end(), order == BY_LENGTH ? compareByLength : compareByCost);
+
+    RankedPlanList rankedPlans;
+    rankedPlans.reserve(plans.size());
+    std::vector<RankedIndex>::const_iterator rit = ranking.begin();
+    for(; rit != ranking.end(); ++rit)
+    {
+        rankedPlans.push_back(plans[rit->index]);
+    }
+    return rankedPlans;
+}
+
+PlanCandidates PlanRanking::toCandidates(const RankedPlanList& rankedPlans)
+{
+    PlanCandidates planCandidates;
+    RankedPlanList::const_iterator it = rankedPlans.begin();
+    for(; it != rankedPlans.end(); ++it)
+    {
+        planCandidates.addPlan(it->plan);
+    }
+    planCandidates.updateStatistics();
+    return planCandidates;
+}
+
+} // end namespace pddl_planner
@@ -0,0 +1,64 @@
+#ifndef PDDL_PLANNER_PLAN_RANKING_HPP
+#define PDDL_PLANNER_PLAN_RANKING_HPP
+
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <pddl_planner/CompactPlan.hpp>
+#include <vector>
+
+namespace pddl_planner
+{
+    /**
+     * Distinct plan of a portfolio run together with the planners which found it
+     */
+    struct RankedPlan
+    {
+        Plan plan;
+        // Planners which found the plan, in the order of the result list
+        std::vector<PlannerName> planners;
+
+        /**
+         * Get the cost used for ranking, i.e. the reported cost or the number of actions
+         * if no planner reported a cost
+         */
+        double getCost() const { return plan.hasCost() ? plan.cost : plan.action_sequence.size(); }
+
+        size_t getLength() const { return plan.action_sequence.size(); }
+    };
+
+    typedef std::vector<RankedPlan> RankedPlanList;
+
+    /**
+     * \class PlanRanking
+     * \brief Merges the plan candidates of all planners of a portfolio run into a single
+     * ordered set of distinct plans
+     * \details Plans are told apart by their actions via CompactPlan, so identical plans
+     * which several planners returned are kept once, together with all planners which found
+     * them. If the planners report different costs for the same plan, the lowest is kept
+     */
+    class PlanRanking
+    {
+    public:
+        enum Order {
+            // Fewest actions first, ties are broken by cost
+            BY_LENGTH,
+            // Lowest cost first, ties are broken by length -- plans without reported cost
+            // are ranked by their length, i.e. as if all actions had unit cost
+            BY_COST
+        };
+
+        /**
+         * Merge and rank the plans of a result list -- plans ranking equally keep the order
+         * in which they appear in the result list
+         * \param symbols Symbol table for the comparison of plans, e.g. of the planning domain
+         * \return distinct plans, the best first
+         */
+        static RankedPlanList rank(const PlanResultList& planResultList, Order order = BY_COST, const SymbolTablePtr& symbols = SymbolTablePtr(new SymbolTable()));
+
+        /**
+         * Get the ranked plans as plan candidates, e.g. for components which expect the
+         * output of a single planner
+         */
+        static PlanCandidates toCandidates(const RankedPlanList& rankedPlans);
+    };
+}
+#endif // PDDL_PLANNER_PLAN_RANKING_HPP
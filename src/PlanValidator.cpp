@@ -0,0 +1,297 @@
+#include <pddl_planner/PlanValidator.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/foreach.hpp>
+
+namespace pddl_planner
+{
+
+namespace
+{
+    using representation::Expression;
+    using representation::ExpressionPtr;
+
+    /**
+     * Get the variable and the body of a quantified expression, which the parser creates
+     * with the variable as typed item
+     */
+    void getQuantified(const Expression& e, representation::TypedItem& variable, const Expression*& body)
+    {
+        if(!e.typedItem.label.empty() && e.parameters.size() == 1)
+        {
+            variable = e.typedItem;
+            body = e.parameters.front().get();
+        } else if(e.parameters.size() == 2 && e.parameters.front()->isAtomic())
+        {
+            variable = representation::TypedItem(e.parameters.front()->label, "");
+            body = e.parameters.back().get();
+        } else {
+            throw PlanGenerationException("PlanValidator: invalid quantified expression " + e.toLISP());
+        }
+    }
+
+    bool isTyped(const representation::Type& type)
+    {
+        return !type.empty() && !boost::iequals(type, "object");
+    }
+}
+
+PlanValidator::PlanValidator(const representation::Problem& problem)
+    : mDomain(problem.domain)
+    , mGoal(problem.goal)
+{
+    if(mGoal.isNull())
+    {
+        throw PlanGenerationException("PlanValidator: problem '" + problem.name + "' has no goal");
+    }
+    if(!mDomain.functions.empty())
+    {
+        throw PlanGenerationException("PlanValidator: numeric functions of domain '" + mDomain.name + "' are not supported");
+    }
+
+    BOOST_FOREACH(const representation::Constant& constant, mDomain.constants)
+    {
+        mObjectTypes[boost::to_lower_copy(constant.label)] = constant.type;
+    }
+    BOOST_FOREACH(const representation::Constant& object, problem.objects)
+    {
+        mObjectTypes[boost::to_lower_copy(object.label)] = object.type;
+    }
+    for(size_t i = 0; i < mDomain.actions.size(); ++i)
+    {
+        mActions.insert(std::make_pair(boost::to_lower_copy(mDomain.actions[i].label), i));
+    }
+
+    Bindings bindings;
+    BOOST_FOREACH(const Expression& e, problem.status)
+    {
+        // Negative facts are implied by the closed world assumption
+        if(e.label != "not")
+        {
+            mInitialState.insert(groundAtom(e, bindings));
+        }
+    }
+}
+
+bool PlanValidator::validate(const Plan& plan) const
+{
+    return simulate(plan, 0);
+}
+
+bool PlanValidator::findValidSuffix(const Plan& plan, size_t firstAction, Plan& suffix) const
+{
+    size_t size = plan.action_sequence.size();
+    for(size_t start = size + 1; start-- > std::min(firstAction, size);)
+    {
+        if(simulate(plan, start))
+        {
+            suffix = Plan();
+            suffix.action_sequence.assign(plan.action_sequence.begin() + start, plan.action_sequence.end());
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string PlanValidator::ground(const std::string& term, const Bindings& bindings) const
+{
+    if(representation::VariableManager::isVariable(term))
+    {
+        Bindings::const_iterator it = bindings.find(term);
+        if(it == bindings.end())
+        {
+            throw PlanGenerationException("PlanValidator: unbound variable " + term);
+        }
+        return it->second;
+    }
+    return boost::to_lower_copy(term);
+}
+
+std::string PlanValidator::groundAtom(const Expression& atom, const Bindings& bindings) const
+{
+    std::string key = boost::to_lower_copy(atom.label);
+    BOOST_FOREACH(const ExpressionPtr& parameter, atom.parameters)
+    {
+        if(!parameter->isAtomic())
+        {
+            throw PlanGenerationException("PlanValidator: unsupported term " + parameter->toLISP() + " in " + atom.toLISP());
+        }
+        key += " " + ground(parameter->label, bindings);
+    }
+    return key;
+}
+
+std::vector<std::string> PlanValidator::getObjects(const representation::Type& type) const
+{
+    std::vector<std::string> objects;
+    boost::unordered_map<std::string, representation::Type>::const_iterator it = mObjectTypes.begin();
+    for(; it != mObjectTypes.end(); ++it)
+    {
+        if(!isTyped(type) || boost::iequals(it->second, type))
+        {
+            objects.push_back(it->first);
+        }
+    }
+    return objects;
+}
+
+bool PlanValidator::holds(const Expression& condition, const Bindings& bindings, const State& state) const
+{
+    const std::string& label = condition.label;
+    if(label == "and")
+    {
+        BOOST_FOREACH(const ExpressionPtr& e, condition.parameters)
+        {
+            if(!holds(*e, bindings, state))
+            {
+                return false;
+            }
+        }
+        return true;
+    } else if(label == "or")
+    {
+        BOOST_FOREACH(const ExpressionPtr& e, condition.parameters)
+        {
+            if(holds(*e, bindings, state))
+            {
+                return true;
+            }
+        }
+        return false;
+    } else if(label == "not" && condition.parameters.size() == 1)
+    {
+        return !holds(*condition.parameters.front(), bindings, state);
+    } else if(label == "imply" && condition.parameters.size() == 2)
+    {
+        return !holds(*condition.parameters[0], bindings, state) || holds(*condition.parameters[1], bindings, state);
+    } else if(label == "=" && condition.parameters.size() == 2 && condition.parameters[0]->isAtomic() && condition.parameters[1]->isAtomic())
+    {
+        return ground(condition.parameters[0]->label, bindings) == ground(condition.parameters[1]->label, bindings);
+    } else if(label == "forall" || label == "exists")
+    {
+        representation::TypedItem variable;
+        const Expression* body = NULL;
+        getQuantified(condition, variable, body);
+
+        bool universal = label == "forall";
+        Bindings scope = bindings;
+        BOOST_FOREACH(const std::string& object, getObjects(variable.type))
+        {
+            scope[variable.label] = object;
+            if(holds(*body, scope, state) != universal)
+            {
+                return !universal;
+            }
+        }
+        return universal;
+    } else if(mDomain.isPredicate(label) || condition.isAtomic())
+    {
+        return state.count(groundAtom(condition, bindings));
+    }
+    throw PlanGenerationException("PlanValidator: unsupported condition " + condition.toLISP());
+}
+
+void PlanValidator::collectEffects(const Expression& effect, const Bindings& bindings, const State& state, std::vector<std::string>& adds, std::vector<std::string>& deletes) const
+{
+    const std::string& label = effect.label;
+    if(label == "and")
+    {
+        BOOST_FOREACH(const ExpressionPtr& e, effect.parameters)
+        {
+            collectEffects(*e, bindings, state, adds, deletes);
+        }
+    } else if(label == "not" && effect.parameters.size() == 1)
+    {
+        deletes.push_back(groundAtom(*effect.parameters.front(), bindings));
+    } else if(label == "when" && effect.parameters.size() == 2)
+    {
+        if(holds(*effect.parameters[0], bindings, state))
+        {
+            collectEffects(*effect.parameters[1], bindings, state, adds, deletes);
+        }
+    } else if(label == "forall")
+    {
+        representation::TypedItem variable;
+        const Expression* body = NULL;
+        getQuantified(effect, variable, body);
+
+        Bindings scope = bindings;
+        BOOST_FOREACH(const std::string& object, getObjects(variable.type))
+        {
+            scope[variable.label] = object;
+            collectEffects(*body, scope, state, adds, deletes);
+        }
+    } else if(mDomain.isPredicate(label) || effect.isAtomic())
+    {
+        adds.push_back(groundAtom(effect, bindings));
+    } else {
+        throw PlanGenerationException("PlanValidator: unsupported effect " + effect.toLISP());
+    }
+}
+
+bool PlanValidator::apply(const Action& action, State& state) const
+{
+    boost::unordered_map<std::string, size_t>::const_iterator it = mActions.find(boost::to_lower_copy(action.name));
+    if(it == mActions.end())
+    {
+        return false;
+    }
+    const representation::Action& definition = mDomain.actions[it->second];
+    if(definition.arguments.size() != action.arguments.size())
+    {
+        return false;
+    }
+
+    Bindings bindings;
+    for(size_t i = 0; i < action.arguments.size(); ++i)
+    {
+        std::string object = boost::to_lower_copy(action.arguments[i]);
+        boost::unordered_map<std::string, representation::Type>::const_iterator oit = mObjectTypes.find(object);
+        if(oit == mObjectTypes.end())
+        {
+            return false;
+        }
+        const representation::Type& type = definition.arguments[i].type;
+        if(isTyped(type) && !boost::iequals(oit->second, type))
+        {
+            return false;
+        }
+        bindings[definition.arguments[i].label] = object;
+    }
+
+    BOOST_FOREACH(const Expression& precondition, definition.preconditions)
+    {
+        if(!holds(precondition, bindings, state))
+        {
+            return false;
+        }
+    }
+
+    // All effects refer to the state before the action, and adds take precedence over deletes
+    std::vector<std::string> adds, deletes;
+    BOOST_FOREACH(const Expression& effect, definition.effects)
+    {
+        collectEffects(effect, bindings, state, adds, deletes);
+    }
+    BOOST_FOREACH(const std::string& atom, deletes)
+    {
+        state.erase(atom);
+    }
+    state.insert(adds.begin(), adds.end());
+    return true;
+}
+
+bool PlanValidator::simulate(const Plan& plan, size_t firstAction) const
+{
+    State state = mInitialState;
+    std::vector<Action>::const_iterator it = plan.action_sequence.begin() + firstAction;
+    for(; it != plan.action_sequence.end(); ++it)
+    {
+        if(!apply(*it, state))
+        {
+            return false;
+        }
+    }
+    return holds(mGoal, Bindings(), state);
+}
+
+} // end namespace pddl_planner
@@ -0,0 +1,99 @@
+#ifndef PDDL_PLANNER_PLAN_VALIDATOR_HPP
+#define PDDL_PLANNER_PLAN_VALIDATOR_HPP
+
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <pddl_planner/representation/Problem.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+#include <map>
+
+namespace pddl_planner
+{
+    /**
+     * \class PlanValidator
+     * \brief Simulates plans on the initial status of a problem using the action definitions
+     * of its domain
+     * \details Supports the STRIPS subset with equality, negative and disjunctive conditions,
+     * quantifiers and conditional effects. The initial status follows the closed world
+     * assumption. Types are matched by name only, since the domain representation does not
+     * keep a type hierarchy -- the type 'object' matches all objects. Symbols are compared
+     * case-insensitively as the planners return them in lower case
+     */
+    class PlanValidator
+    {
+    public:
+        /**
+         * Create a validator for a problem
+         * \throws PlanGenerationException if the problem has no goal or the domain uses
+         * features which are not supported, e.g. numeric functions
+         */
+        PlanValidator(const representation::Problem& problem);
+
+        /**
+         * Check if a plan is applicable in the initial status and reaches the goal
+         * \throws PlanGenerationException if the plan requires unsupported features, e.g. an
+         * action effect on a numeric function
+         */
+        bool validate(const Plan& plan) const;
+
+        /**
+         * Find the shortest suffix of a plan which is applicable in the initial status and
+         * reaches the goal -- suffixes are tried from the end of the plan, so the search
+         * takes quadratic time in the length of the plan
+         * \param firstAction Index of the first action of the longest suffix to consider,
+         * e.g. the number of actions which have already been executed
+         * \param suffix Receives the suffix, which is empty if the goal already holds
+         * \return true if a valid suffix exists, false otherwise
+         * \throws PlanGenerationException if the plan requires unsupported features
+         */
+        bool findValidSuffix(const Plan& plan, size_t firstAction, Plan& suffix) const;
+
+    private:
+        typedef boost::unordered_set<std::string> State;
+        typedef std::map<std::string, std::string> Bindings;
+
+        /**
+         * Get the object a term refers to, i.e. the bound object of a variable or the
+         * constant itself
+         */
+        std::string ground(const std::string& term, const Bindings& bindings) const;
+
+        /**
+         * Get the key of a ground atom in the state
+         */
+        std::string groundAtom(const representation::Expression& atom, const Bindings& bindings) const;
+
+        /**
+         * Get the objects matching the type of a quantified variable
+         */
+        std::vector<std::string> getObjects(const representation::Type& type) const;
+
+        bool holds(const representation::Expression& condition, const Bindings& bindings, const State& state) const;
+
+        /**
+         * Collect the atoms which an effect adds and deletes when applied in state
+         */
+        void collectEffects(const representation::Expression& effect, const Bindings& bindings, const State& state, std::vector<std::string>& adds, std::vector<std::string>& deletes) const;
+
+        /**
+         * Apply an action of a plan
+         * \return false if the action is unknown, its arguments do not match the action
+         * definition or its preconditions do not hold
+         */
+        bool apply(const Action& action, State& state) const;
+
+        /**
+         * Simulate the actions of a plan starting at firstAction
+         */
+        bool simulate(const Plan& plan, size_t firstAction) const;
+
+        representation::Domain mDomain;
+        representation::Expression mGoal;
+        State mInitialState;
+        // Types of all objects and constants, with lower case labels
+        boost::unordered_map<std::string, representation::Type> mObjectTypes;
+        // Positions of the actions of the domain by their lower case label
+        boost::unordered_map<std::string, size_t> mActions;
+    };
+}
+#endif // PDDL_PLANNER_PLAN_VALIDATOR_HPP
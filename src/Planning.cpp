@@ -1,5 +1,12 @@
 #include <pddl_planner/Planning.hpp>
 #include <pddl_planner/PDDLPlannerInterface.hpp>
+#include <pddl_planner/BinaryRegistry.hpp>
+#include <pddl_planner/ThreadPool.hpp>
+#include <pddl_planner/ProcessPool.hpp>
+#include <pddl_planner/CoreAllocator.hpp>
+#include <pddl_planner/Tracer.hpp>
+#include <pddl_planner/PlanValidator.hpp>
+#include <pddl_planner/ReachabilityAnalysis.hpp>
 #include <pddl_planner/planners/Lama.hpp>
 #include <pddl_planner/planners/Bfsf.hpp>
 #include <pddl_planner/planners/Uniform.hpp>
@@ -7,14 +14,23 @@
 #include <pddl_planner/planners/Cedalion.hpp>
 #include <pddl_planner/planners/ArvandHerd.hpp>
 #include <pddl_planner/planners/FastDownward.hpp>
+#include <pddl_planner/planners/Gbfs.hpp>
 #include <boost/assign/list_of.hpp>
 #include <boost/assign.hpp>
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
 #include <base/Logging.hpp>
 
 namespace pddl_planner
 {
 
+// Interval in milliseconds at which waiting planning calls check for cancellation
+static const int CANCELLATION_POLL_INTERVAL = 10;
+
 Planning::Planning()
+    : mPortfolioScheduler(new PortfolioScheduler())
+    , mReachabilityCheck(false)
 {
     mPlanners =
          {
@@ -28,12 +44,37 @@ Planning::Planning()
                     {"FDSS2", new pddl_planner::fast_downward::Planner("sas_plan", "seq-sat-fdss-2")},
                     {"LAMA2011", new pddl_planner::fast_downward::Planner("sas_plan", "seq-sat-lama-2011")},
                     {"FDAUTOTUNE2", new pddl_planner::fast_downward::Planner("sas_plan", "seq-sat-fd-autotune-2")},
-                    {"FDAUTOTUNE1", new pddl_planner::fast_downward::Planner("sas_plan", "seq-sat-fd-autotune-1")}
+                    {"FDAUTOTUNE1", new pddl_planner::fast_downward::Planner("sas_plan", "seq-sat-fd-autotune-1")},
+                    {"GBFS", new pddl_planner::gbfs::Planner()}
         };
+
+    // Resolve the planner executables once at startup
+    PlannerMap::const_iterator it = mPlanners.begin();
+    for(; it != mPlanners.end(); ++it)
+    {
+        std::string cmd = it->second->getCmd();
+        if(!cmd.empty())
+        {
+            BinaryRegistry::getInstance().resolve(cmd);
+        }
+    }
 }
 
 Planning::~Planning()
 {
+    {
+        boost::unique_lock<boost::mutex> lock(mAsyncMutex);
+        std::vector<PlanningHandle>::iterator hit = mAsyncCalls.begin();
+        for(; hit != mAsyncCalls.end(); ++hit)
+        {
+            hit->cancel();
+        }
+        while(!mAsyncCalls.empty())
+        {
+            mAsyncCondition.wait(lock);
+        }
+    }
+
     PlannerMap::iterator it = mPlanners.begin();
     for(; it != mPlanners.end(); ++it)
     {
@@ -42,11 +83,18 @@ Planning::~Planning()
     }
 }
 
+PlannerMap Planning::getPlanners() const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mMutex);
+    return mPlanners;
+}
+
 std::set<std::string> Planning::getAvailablePlanners()
 {
     std::set<std::string> result;
-    PlannerMap::iterator it = mPlanners.begin();
-    for(; it != mPlanners.end(); ++it)
+    PlannerMap planners = getPlanners();
+    PlannerMap::iterator it = planners.begin();
+    for(; it != planners.end(); ++it)
     {
         PDDLPlannerInterface* planner = it->second;
         if(planner->isAvailable())
@@ -66,17 +114,23 @@ void Planning::registerPlanner(PDDLPlannerInterface* planner)
 
     std::string name = planner->getName();
 
-    try {
-        getPlanner(name);
-        throw std::runtime_error("pddl_planner::Planning: planner with name '" + name + "' is already registered");
-    } catch(const std::runtime_error& )
+    boost::unique_lock<boost::shared_mutex> lock(mMutex);
+    if(mPlanners.count(name))
+    {
+        LOG_WARN("pddl_planner::Planning: planner with name '%s' is already registered -- replacing it", name.c_str());
+    }
+    mPlanners[name] = planner;
+
+    fast_downward::Planner* fdPlanner = dynamic_cast<fast_downward::Planner*>(planner);
+    if(fdPlanner && mTranslationCache)
     {
-        mPlanners[name] = planner;
+        fdPlanner->setTranslationCache(mTranslationCache);
     }
 }
 
 PDDLPlannerInterface* Planning::getPlanner(const std::string& name) const
 {
+    boost::shared_lock<boost::shared_mutex> lock(mMutex);
     std::map<std::string, PDDLPlannerInterface*>::const_iterator it = mPlanners.find(name);
     if(it != mPlanners.end())
     {
@@ -85,8 +139,15 @@ PDDLPlannerInterface* Planning::getPlanner(const std::string& name) const
     throw std::runtime_error("pddl_planner::Planning: planner with name '" + name + "' does not exist");
 }
 
+bool Planning::isRegistered(const std::string& name) const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mMutex);
+    return mPlanners.count(name);
+}
+
 PlannerList Planning::getRegisteredPlanners() const
 {
+    boost::shared_lock<boost::shared_mutex> lock(mMutex);
     PlannerList planners;
     PlannerMap::const_iterator cit = mPlanners.begin();
     for(; cit != mPlanners.end(); ++cit)
@@ -99,126 +160,930 @@ PlannerList Planning::getRegisteredPlanners() const
 
 void Planning::setActionDescription(const std::string& action, const std::string& description)
 {
+    boost::unique_lock<boost::shared_mutex> lock(mMutex);
     mActionDescriptions[action] = description;
 }
 
 void Planning::setDomainDescription(const std::string& domain, const std::string& description)
 {
+    boost::unique_lock<boost::shared_mutex> lock(mMutex);
     mDomainDescriptions[domain] = description;
 }
 
-std::string Planning::getActionDescriptions() const
+static std::string concatenate(const std::map<std::string, std::string>& descriptions)
 {
-    std::string actionDescriptions;
-    ActionDescriptions::const_iterator it = mActionDescriptions.begin();
-    for(; it != mActionDescriptions.end(); ++it)
+    std::string result;
+    std::map<std::string, std::string>::const_iterator it = descriptions.begin();
+    for(; it != descriptions.end(); ++it)
     {
-        actionDescriptions += it->second + "\n";
+        result += it->second + "\n";
     }
-    return actionDescriptions;
+    return result;
+}
+
+std::string Planning::getActionDescriptions() const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mMutex);
+    return concatenate(mActionDescriptions);
 }
 
 std::string Planning::getDomainDescriptions() const
 {
-    std::string domainDescriptions;
-    DomainDescriptions::const_iterator it = mDomainDescriptions.begin();
-    for(; it != mDomainDescriptions.end(); ++it)
+    boost::shared_lock<boost::shared_mutex> lock(mMutex);
+    return concatenate(mDomainDescriptions);
+}
+
+void Planning::getDescriptions(std::string& domainDescriptions, std::string& actionDescriptions, const representation::Domain* domain)
+{
+    TraceSpan span("serialize domain");
+    if(domain)
+    {
+        // Update and read the descriptions at once, so that this call
+        // uses its own domain even if other callers update the same domain
+        std::string description = domain->toLISP();
+        boost::unique_lock<boost::shared_mutex> lock(mMutex);
+        mDomainDescriptions[domain->name] = description;
+        domainDescriptions = concatenate(mDomainDescriptions);
+        actionDescriptions = concatenate(mActionDescriptions);
+    } else {
+        boost::shared_lock<boost::shared_mutex> lock(mMutex);
+        domainDescriptions = concatenate(mDomainDescriptions);
+        actionDescriptions = concatenate(mActionDescriptions);
+    }
+}
+
+void Planning::enablePlanCache(size_t capacity, const std::string& directory)
+{
+    boost::shared_ptr<PlanCache> planCache(new PlanCache(capacity, directory));
+    boost::unique_lock<boost::shared_mutex> lock(mMutex);
+    mPlanCache = planCache;
+}
+
+void Planning::disablePlanCache()
+{
+    boost::unique_lock<boost::shared_mutex> lock(mMutex);
+    mPlanCache.reset();
+}
+
+boost::shared_ptr<PlanCache> Planning::getPlanCache() const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mMutex);
+    return mPlanCache;
+}
+
+void Planning::enableTranslationCache(const std::string& directory, size_t capacity)
+{
+    std::string cacheDirectory = directory;
+    if(cacheDirectory.empty())
+    {
+        cacheDirectory = (boost::filesystem::temp_directory_path() / "pddl_planner_translation_cache").string();
+    }
+    setTranslationCache(boost::shared_ptr<TranslationCache>(new TranslationCache(cacheDirectory, capacity)));
+}
+
+void Planning::disableTranslationCache()
+{
+    setTranslationCache(boost::shared_ptr<TranslationCache>());
+}
+
+boost::shared_ptr<TranslationCache> Planning::getTranslationCache() const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mMutex);
+    return mTranslationCache;
+}
+
+void Planning::enableWarmWorkers(size_t workers)
+{
+    if(workers == 0)
+    {
+        PlannerMap planners = getPlanners();
+        PlannerMap::const_iterator it = planners.begin();
+        for(; it != planners.end(); ++it)
+        {
+            // In-process planners do not start a process
+            if(!it->second->getCmd().empty())
+            {
+                ++workers;
+            }
+        }
+    }
+    ProcessPool::getDefault().setSize(workers);
+}
+
+void Planning::disableWarmWorkers()
+{
+    ProcessPool::getDefault().setSize(0);
+}
+
+void Planning::setResourceLimits(const std::string& planner, const ResourceLimits& limits)
+{
+    getPlanner(planner)->setResourceLimits(limits);
+}
+
+void Planning::enableCorePinning(size_t coresPerPlanner)
+{
+    CoreAllocator::getInstance().setCoresPerPlanner(std::max(coresPerPlanner, (size_t) 1));
+}
+
+void Planning::disableCorePinning()
+{
+    CoreAllocator::getInstance().setCoresPerPlanner(0);
+}
+
+void Planning::enableTracing(size_t capacity)
+{
+    Tracer::getInstance().enable(capacity);
+}
+
+void Planning::disableTracing()
+{
+    Tracer::getInstance().disable();
+}
+
+void Planning::enableReachabilityCheck()
+{
+    boost::unique_lock<boost::shared_mutex> lock(mMutex);
+    mReachabilityCheck = true;
+}
+
+void Planning::disableReachabilityCheck()
+{
+    boost::unique_lock<boost::shared_mutex> lock(mMutex);
+    mReachabilityCheck = false;
+}
+
+bool Planning::isUnsolvable(const representation::Domain& domain, const representation::Problem& problem) const
+{
+    {
+        boost::shared_lock<boost::shared_mutex> lock(mMutex);
+        if(!mReachabilityCheck)
+        {
+            return false;
+        }
+    }
+
+    TraceSpan span("reachability check", problem.name);
+    ReachabilityAnalysis analysis(domain, problem);
+    if(analysis.isUnsolvable())
+    {
+        LOG_INFO("Problem %s is unsolvable: %s", problem.name.c_str(), analysis.getReason().c_str());
+    }
+    return analysis.isUnsolvable();
+}
+
+PlanResultList Planning::createUnsolvableResults(const std::set<std::string>& planners) const
+{
+    PlanResultList planResultList;
+    std::set<std::string>::const_iterator it = planners.begin();
+    for(; it != planners.end(); ++it)
+    {
+        // Report unknown planners as if they had been called
+        getPlanner(*it);
+        PlanCandidates planCandidates;
+        planCandidates.statistics.unsolvable = true;
+        planResultList.push_back(PlanResult(*it, planCandidates));
+    }
+    return planResultList;
+}
+
+void Planning::setTranslationCache(const boost::shared_ptr<TranslationCache>& cache)
+{
+    boost::unique_lock<boost::shared_mutex> lock(mMutex);
+    mTranslationCache = cache;
+    PlannerMap::iterator it = mPlanners.begin();
+    for(; it != mPlanners.end(); ++it)
     {
-        domainDescriptions += it->second + "\n";
+        fast_downward::Planner* planner = dynamic_cast<fast_downward::Planner*>(it->second);
+        if(planner)
+        {
+            planner->setTranslationCache(cache);
+        }
     }
-    return domainDescriptions;
 }
 
-void run_planner(const std::string & plannerName, const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, Planning * planning, double timeout)
+/**
+ * Serialize a problem for the planners
+ */
+std::string serialize_problem(const representation::Problem& problem)
+{
+    TraceSpan span("serialize problem", problem.name);
+    return problem.toLISP();
+}
+
+/**
+ * Call a planner and complete the statistics of its result -- the wall time covers the
+ * complete call, including the preparation of the planner's workspace
+ */
+PlanCandidates plan_measured(PDDLPlannerInterface* planner, const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout, const CancellationToken& token, const PlanCallback& callback)
+{
+    TraceSpan span("planner", planner->getName());
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    PlanCandidates planCandidates = planner->plan(problem, actionDescriptions, domainDescriptions, timeout, token, callback);
+    planCandidates.statistics.wallTime = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+    planCandidates.updateStatistics();
+    return planCandidates;
+}
+
+/**
+ * Get the pool to run a planner call in, i.e. remote planners do not occupy the slots
+ * of local planners
+ */
+ThreadPool& getPool(const PDDLPlannerInterface* planner)
+{
+    return planner->isRemote() ? ThreadPool::getRemote() : ThreadPool::getDefault();
+}
+
+/**
+ * Provide the cached plan candidates of a request, i.e. along with the statistics of a cached
+ * result, and report the plans to the callback
+ * \return true on cache hit, false otherwise
+ */
+bool provide_cached(PlanCache& cache, const std::string& request, const std::string& plannerName, const PlanCallback& planCallback, PlanCandidates& planCandidates)
 {
-    PDDLPlannerInterface* planner;
+    TraceSpan lookupSpan("plan cache lookup", plannerName);
+    bool cached = cache.lookup(request, planCandidates);
+    lookupSpan.end();
+    if(!cached)
     {
-        boost::unique_lock<boost::mutex> scoped_lock(planning->mPlannerMutex);
-        planner = planning->getPlanner(plannerName);
+        return false;
     }
-    pddl_planner::PlanCandidates planCandidates = planner->plan(problem, actionDescriptions, domainDescriptions, timeout);
-    boost::unique_lock<boost::mutex> scoped_lock(planning->mResultMutex);
-    planning->mPlanResultList.push_back(std::pair<PlannerName, PlanCandidates> (plannerName, planCandidates));
+
+    LOG_DEBUG("Planner %s: using cached plan candidates", plannerName.c_str());
+    planCandidates.statistics = PlannerStatistics();
+    planCandidates.statistics.cached = true;
+    planCandidates.updateStatistics();
+    std::vector<Plan>::const_iterator it = planCandidates.plans.begin();
+    for(; planCallback && it != planCandidates.plans.end(); ++it)
+    {
+        planCallback(*it);
+    }
+    return true;
+}
+
+/**
+ * Call a planner unless the plan cache already contains a solution
+ * \param cache Plan cache, might be an empty pointer when caching is disabled
+ */
+PlanCandidates plan_cached(const boost::shared_ptr<PlanCache>& cache, PDDLPlannerInterface* planner, const std::string& plannerName, const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout, const CancellationToken& token = CancellationToken(), const PlanResultCallback& callback = PlanResultCallback())
+{
+    PlanCallback planCallback;
+    if(callback)
+    {
+        planCallback = boost::bind(callback, plannerName, _1);
+    }
+
+    if(!cache)
+    {
+        return plan_measured(planner, problem, actionDescriptions, domainDescriptions, timeout, token, planCallback);
+    }
+
+    PlanCandidates planCandidates;
+    std::string request = PlanCache::createRequest(plannerName, domainDescriptions, actionDescriptions, problem);
+    if(provide_cached(*cache, request, plannerName, planCallback, planCandidates))
+    {
+        return planCandidates;
+    }
+
+    planCandidates = plan_measured(planner, problem, actionDescriptions, domainDescriptions, timeout, token, planCallback);
+    // Results of cancelled or unsuccessful runs are incomplete, so keep them out of the cache
+    if(!planCandidates.plans.empty() && !token.isCancelled())
+    {
+        cache->store(request, planCandidates);
+    }
+    return planCandidates;
+}
+
+/**
+ * Result list which is shared by the planners running in parallel for a single call
+ */
+struct ParallelState
+{
+    boost::mutex mutex;
+    PlanResultList planResultList;
+    PlanResultCallback callback;
+};
+
+void run_planner(PDDLPlannerInterface* planner, const std::string& plannerName, const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout, CancellationToken token, boost::shared_ptr<PlanCache> cache, ParallelState* state)
+{
+    PlanCandidates planCandidates = plan_cached(cache, planner, plannerName, problem, actionDescriptions, domainDescriptions, timeout, token, state->callback);
+    boost::unique_lock<boost::mutex> scoped_lock(state->mutex);
+    state->planResultList.push_back(std::pair<PlannerName, PlanCandidates> (plannerName, planCandidates));
 }
 
 PlanResultList Planning::plan(const std::string& problem, const std::set<std::string>& planners, bool sequential, double timeout)
 {
-    std::string actionDescriptions = getActionDescriptions(), domainDescriptions = getDomainDescriptions();
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions);
+    return planWithDescriptions(problem, actionDescriptions, domainDescriptions, planners, sequential, timeout);
+}
+
+PlanResultList Planning::planWithDescriptions(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, bool sequential, double timeout, const CancellationToken& token, const PlanResultCallback& callback)
+{
+    TraceSpan span("request");
     LOG_DEBUG_S << (sequential ? "Sequential " : "") << "Planning requested: " << std::endl
         << "-DOMAIN-" << std::endl << domainDescriptions
         << "-PROBLEM-" << std::endl << problem;
 
+    // Resolve all planners upfront, so that an unknown planner does not leave
+    // any runners behind
+    std::vector<PDDLPlannerInterface*> portfolio;
+    std::set<std::string>::const_iterator it = planners.begin();
+    for(; it != planners.end(); ++it)
+    {
+        portfolio.push_back(getPlanner(*it));
+    }
+    boost::shared_ptr<PlanCache> cache = getPlanCache();
+
+    ParallelState state;
+    state.callback = callback;
+    std::vector<PDDLPlannerInterface*>::const_iterator pit = portfolio.begin();
     if(sequential)
     {
-        long size;
-        char *buf;
-        char *dirname_ptr;
-        size = pathconf(".", _PC_PATH_MAX);
-        if ((buf = (char *)malloc((size_t)size)) == NULL)
+        for(it = planners.begin(); planners.end() != it && !token.isCancelled(); ++it, ++pit)
+        {
+            state.planResultList.push_back(std::pair<PlannerName, PlanCandidates> (*it, plan_cached(cache, *pit, *it, problem, actionDescriptions, domainDescriptions, timeout, token, callback)));
+        }
+    }
+    else
+    {
+        TaskGroup runners;
+        for(it = planners.begin(); it != planners.end(); ++it, ++pit)
         {
-            fprintf(stderr, "Error allocating buffer memory.\n%s\n", strerror(errno));
-            exit(1);
+            runners.run(boost::bind(run_planner, *pit, *it, problem, actionDescriptions, domainDescriptions, timeout, token, cache, &state), getPool(*pit));
         }
-        dirname_ptr = getcwd(buf, (size_t)size);
+        runners.wait();
+    }
+    recordResults(actionDescriptions, domainDescriptions, state.planResultList);
+    return state.planResultList;
+}
+
+/**
+ * Shared state of the planners running in a 'first plan wins' portfolio
+ */
+struct FirstWinsState
+{
+    boost::mutex mutex;
+    boost::condition_variable condition;
+    PlanResultList planResultList;
+    PlanResultCallback callback;
+    size_t pending;
+    bool solved;
+    PlannerName winner;
+};
 
-        for(std::set<std::string>::const_iterator it = planners.begin(); planners.end() != it; ++it)
+/**
+ * Per-plan callback of the planners in a 'first plan wins' portfolio -- the first plan of any
+ * planner decides the winner, so that the grace period starts right away
+ */
+void on_portfolio_plan(FirstWinsState* state, const PlannerName& plannerName, const Plan& plan)
+{
+    {
+        boost::unique_lock<boost::mutex> scoped_lock(state->mutex);
+        if(!state->solved)
         {
-            std::string planner_name = (*it);
-            PDDLPlannerInterface* planner = getPlanner(planner_name);
-            mPlanResultList.push_back(std::pair<PlannerName, PlanCandidates> (planner_name, planner->plan(problem, actionDescriptions, domainDescriptions, timeout)));
+            state->solved = true;
+            state->winner = plannerName;
+            state->condition.notify_all();
         }
-        if(dirname_ptr)free(dirname_ptr);
     }
-    else
+    if(state->callback)
     {
-        std::set<std::string>::const_iterator it = planners.begin();
-        for(; it != planners.end(); ++it)
+        state->callback(plannerName, plan);
+    }
+}
+
+void run_portfolio_planner(PDDLPlannerInterface* planner, const std::string& plannerName, const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout, CancellationToken token, boost::shared_ptr<PlanCache> cache, FirstWinsState* state)
+{
+    PlanCandidates planCandidates;
+    try {
+        // Planners still queued in the pool when a solution has been found need not start at all
+        if(!token.isCancelled())
+        {
+            planCandidates = plan_cached(cache, planner, plannerName, problem, actionDescriptions, domainDescriptions, timeout, token, boost::bind(on_portfolio_plan, state, _1, _2));
+        }
+    } catch(const std::runtime_error& e)
+    {
+        LOG_WARN("Planner %s failed: %s", plannerName.c_str(), e.what());
+    }
+
+    boost::unique_lock<boost::mutex> scoped_lock(state->mutex);
+    if(!planCandidates.plans.empty() && !state->solved)
+    {
+        state->solved = true;
+        state->winner = plannerName;
+    }
+    if(!planCandidates.plans.empty() && state->winner == plannerName)
+    {
+        // The winning planner always makes up the first entry
+        state->planResultList.insert(state->planResultList.begin(), std::pair<PlannerName, PlanCandidates> (plannerName, planCandidates));
+    } else {
+        state->planResultList.push_back(std::pair<PlannerName, PlanCandidates> (plannerName, planCandidates));
+    }
+    --state->pending;
+    state->condition.notify_all();
+}
+
+PlanResultList Planning::planFirstWins(const std::string& problem, const std::set<std::string>& planners, double timeout, double gracePeriod)
+{
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions);
+    return planFirstWinsWithDescriptions(problem, actionDescriptions, domainDescriptions, planners, timeout, gracePeriod);
+}
+
+PlanResultList Planning::planFirstWinsWithDescriptions(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, double timeout, double gracePeriod, const CancellationToken& callerToken, const PlanResultCallback& callback)
+{
+    TraceSpan span("first-wins request");
+    LOG_DEBUG_S << "First-wins planning requested: " << std::endl
+        << "-DOMAIN-" << std::endl << domainDescriptions
+        << "-PROBLEM-" << std::endl << problem;
+
+    FirstWinsState state;
+    state.callback = callback;
+    state.pending = planners.size();
+    state.solved = false;
+
+    // Resolve all planners upfront, so that an unknown planner does not leave
+    // any runners behind
+    std::vector<PDDLPlannerInterface*> portfolio;
+    std::set<std::string>::const_iterator it = planners.begin();
+    for(; it != planners.end(); ++it)
+    {
+        portfolio.push_back(getPlanner(*it));
+    }
+
+    // A cached solution wins right away, so that no planner needs to be started -- the scan
+    // must not count as a miss for the planners without a cached solution
+    boost::shared_ptr<PlanCache> cache = getPlanCache();
+    for(it = planners.begin(); cache && it != planners.end(); ++it)
+    {
+        PlanCandidates planCandidates;
+        std::string request = PlanCache::createRequest(*it, domainDescriptions, actionDescriptions, problem);
+        PlanCallback planCallback;
+        if(callback)
+        {
+            planCallback = boost::bind(callback, *it, _1);
+        }
+        if(cache->contains(request) && provide_cached(*cache, request, *it, planCallback, planCandidates) && !planCandidates.plans.empty())
+        {
+            LOG_INFO("First-wins planning: using cached solution of planner %s", it->c_str());
+            state.planResultList.push_back(std::pair<PlannerName, PlanCandidates> (*it, planCandidates));
+            return state.planResultList;
+        }
+    }
+
+    CancellationToken token;
+    TaskGroup runners;
+    std::vector<PDDLPlannerInterface*>::const_iterator pit = portfolio.begin();
+    for(it = planners.begin(); it != planners.end(); ++it, ++pit)
+    {
+        runners.run(boost::bind(run_portfolio_planner, *pit, *it, problem, actionDescriptions, domainDescriptions, timeout, token, cache, &state), getPool(*pit));
+    }
+
+    {
+        boost::unique_lock<boost::mutex> scoped_lock(state.mutex);
+        // Wake up regularly to serve cancellation requests of the caller
+        boost::chrono::milliseconds pollInterval(CANCELLATION_POLL_INTERVAL);
+        while(!state.solved && state.pending > 0 && !callerToken.isCancelled())
+        {
+            state.condition.wait_for(scoped_lock, pollInterval);
+        }
+
+        if(state.solved && gracePeriod > 0)
+        {
+            boost::chrono::steady_clock::time_point deadline = boost::chrono::steady_clock::now() + boost::chrono::milliseconds((int)(1000. * gracePeriod));
+            while(state.pending > 0 && !callerToken.isCancelled() && boost::chrono::steady_clock::now() < deadline)
+            {
+                state.condition.wait_until(scoped_lock, std::min(deadline, boost::chrono::steady_clock::now() + pollInterval));
+            }
+        }
+    }
+
+    if(state.solved)
+    {
+        LOG_INFO("First-wins planning: solution found by planner %s, cancelling remaining planners", state.winner.c_str());
+    }
+    token.cancel();
+    runners.wait();
+
+    recordResults(actionDescriptions, domainDescriptions, state.planResultList);
+    return state.planResultList;
+}
+
+PlanResultList Planning::planFirstWins(const representation::Problem& problem, const std::set<std::string>& planners, double timeout, double gracePeriod)
+{
+    if(isUnsolvable(problem.domain, problem))
+    {
+        return createUnsolvableResults(planners);
+    }
+
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions, &problem.domain);
+    return planFirstWinsWithDescriptions(serialize_problem(problem), actionDescriptions, domainDescriptions, planners, timeout, gracePeriod);
+}
+
+PlanResultList Planning::plan(const std::string& problem, const std::set<std::string>& planners, const PlanningOptions& options)
+{
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions);
+    return planWithDescriptions(problem, actionDescriptions, domainDescriptions, planners, options, CancellationToken());
+}
+
+PlanResultList Planning::planWithDescriptions(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, const PlanningOptions& options, const CancellationToken& token)
+{
+    switch(options.mode)
+    {
+        case PlanningOptions::SEQUENTIAL:
+            return planWithDescriptions(problem, actionDescriptions, domainDescriptions, planners, true, options.timeout, token, options.planCallback);
+        case PlanningOptions::FIRST_WINS:
+            return planFirstWinsWithDescriptions(problem, actionDescriptions, domainDescriptions, planners, options.timeout, options.gracePeriod, token, options.planCallback);
+        case PlanningOptions::ADAPTIVE_SEQUENTIAL:
+        case PlanningOptions::ADAPTIVE_PARALLEL:
+            return planAdaptiveWithDescriptions(problem, actionDescriptions, domainDescriptions, planners, options, token);
+        case PlanningOptions::PARALLEL:
+        default:
+            return planWithDescriptions(problem, actionDescriptions, domainDescriptions, planners, false, options.timeout, token, options.planCallback);
+    }
+}
+
+PlanResultList Planning::planAdaptiveWithDescriptions(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, const PlanningOptions& options, const CancellationToken& token)
+{
+    std::string domain = PortfolioScheduler::createKey(domainDescriptions, actionDescriptions);
+    if(options.mode == PlanningOptions::ADAPTIVE_PARALLEL)
+    {
+        size_t size = options.portfolioSize ? options.portfolioSize : ThreadPool::getDefault().getConcurrency();
+        PortfolioSchedule schedule = mPortfolioScheduler->scheduleParallel(domain, planners, size, options.timeout);
+        std::set<std::string> selected;
+        PortfolioSchedule::const_iterator it = schedule.begin();
+        for(; it != schedule.end(); ++it)
+        {
+            selected.insert(it->planner);
+        }
+        return planWithDescriptions(problem, actionDescriptions, domainDescriptions, selected, false, options.timeout, token, options.planCallback);
+    }
+
+    // Resolve all planners upfront, so that an unknown planner is reported before any planner ran
+    std::set<std::string>::const_iterator pit = planners.begin();
+    for(; pit != planners.end(); ++pit)
+    {
+        getPlanner(*pit);
+    }
+    boost::shared_ptr<PlanCache> cache = getPlanCache();
+
+    typedef boost::chrono::steady_clock Clock;
+    Clock::time_point deadline = Clock::now() + boost::chrono::milliseconds((int)(1000. * options.timeout));
+    PortfolioSchedule schedule = mPortfolioScheduler->scheduleSequential(domain, planners, options.timeout);
+    PlanResultList planResultList;
+    // Time a planner leaves unused is handed on to the next one
+    double carryOver = 0.0;
+    PortfolioSchedule::const_iterator it = schedule.begin();
+    for(; it != schedule.end() && !token.isCancelled(); ++it)
+    {
+        Clock::time_point start = Clock::now();
+        double timeout = std::min(it->timeout + carryOver, boost::chrono::duration<double>(deadline - start).count());
+        if(timeout <= 0)
+        {
+            break;
+        }
+
+        LOG_DEBUG("Adaptive planning: running planner %s for %f s", it->planner.c_str(), timeout);
+        PlanCandidates planCandidates;
+        try {
+            planCandidates = plan_cached(cache, getPlanner(it->planner), it->planner, problem, actionDescriptions, domainDescriptions, timeout, token, options.planCallback);
+        } catch(const std::runtime_error& e)
+        {
+            // A failing planner is recorded as unsuccessful and the next one gets its remaining time
+            LOG_WARN("Adaptive planning: planner %s failed: %s", it->planner.c_str(), e.what());
+            planCandidates.statistics.wallTime = boost::chrono::duration<double>(Clock::now() - start).count();
+        }
+        mPortfolioScheduler->record(domain, it->planner, planCandidates.statistics);
+        planResultList.push_back(std::pair<PlannerName, PlanCandidates> (it->planner, planCandidates));
+        if(!planCandidates.plans.empty())
+        {
+            break;
+        }
+        carryOver = std::max(0.0, timeout - boost::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return planResultList;
+}
+
+void Planning::recordResults(const std::string& actionDescriptions, const std::string& domainDescriptions, const PlanResultList& planResultList)
+{
+    std::string domain = PortfolioScheduler::createKey(domainDescriptions, actionDescriptions);
+    PlanResultList::const_iterator it = planResultList.begin();
+    for(; it != planResultList.end(); ++it)
+    {
+        mPortfolioScheduler->record(domain, it->first, it->second.statistics);
+    }
+}
+
+/**
+ * Inputs shared by all jobs of a batch planning call
+ */
+struct BatchState
+{
+    const std::vector<std::string>* problems;
+    const std::string* actionDescriptions;
+    const std::string* domainDescriptions;
+    boost::shared_ptr<PlanCache> cache;
+    PlanResultCallback callback;
+    double timeout;
+    boost::chrono::steady_clock::time_point deadline;
+    bool hasDeadline;
+    std::vector<PlanResultList>* results;
+};
+
+void run_batch_job(BatchState* state, PDDLPlannerInterface* planner, size_t problemIndex, size_t plannerIndex)
+{
+    PlanResult& result = (*state->results)[problemIndex][plannerIndex];
+    double timeout = state->timeout;
+    if(state->hasDeadline)
+    {
+        timeout = std::min(timeout, boost::chrono::duration<double>(state->deadline - boost::chrono::steady_clock::now()).count());
+        if(timeout <= 0)
+        {
+            LOG_INFO("Batch planning: deadline expired, skipping planner %s for problem %d", result.first.c_str(), (int) problemIndex);
+            // The planner did not run, which is reported like a cancelled call
+            result.second.statistics.cancelled = true;
+            return;
+        }
+    }
+
+    try {
+        result.second = plan_cached(state->cache, planner, result.first, (*state->problems)[problemIndex], *state->actionDescriptions, *state->domainDescriptions, timeout, CancellationToken(), state->callback);
+    } catch(const std::runtime_error& e)
+    {
+        // A failing instance must not discard the results of the other instances
+        LOG_WARN("Batch planning: planner %s failed for problem %d: %s", result.first.c_str(), (int) problemIndex, e.what());
+    }
+}
+
+std::vector<PlanResultList> Planning::planBatch(const representation::Domain& domain, const std::vector<representation::Problem>& problems, const std::set<std::string>& planners, const PlanningOptions& options, double deadline)
+{
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions, &domain);
+
+    // Only the problems which might be solvable are passed to the planners
+    std::vector<std::string> problemDescriptions;
+    std::vector<size_t> solvable;
+    for(size_t i = 0; i < problems.size(); ++i)
+    {
+        if(!isUnsolvable(domain, problems[i]))
+        {
+            problemDescriptions.push_back(serialize_problem(problems[i]));
+            solvable.push_back(i);
+        }
+    }
+
+    std::vector<PlanResultList> results = planBatchWithDescriptions(problemDescriptions, actionDescriptions, domainDescriptions, planners, options, deadline);
+    if(solvable.size() == problems.size())
+    {
+        return results;
+    }
+
+    std::vector<PlanResultList> allResults(problems.size(), createUnsolvableResults(planners));
+    for(size_t i = 0; i < solvable.size(); ++i)
+    {
+        allResults[solvable[i]] = results[i];
+    }
+    return allResults;
+}
+
+std::vector<PlanResultList> Planning::planBatch(const std::vector<std::string>& problems, const std::set<std::string>& planners, const PlanningOptions& options, double deadline)
+{
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions);
+    return planBatchWithDescriptions(problems, actionDescriptions, domainDescriptions, planners, options, deadline);
+}
+
+std::vector<PlanResultList> Planning::planBatchWithDescriptions(const std::vector<std::string>& problems, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, const PlanningOptions& options, double deadline)
+{
+    TraceSpan span("batch request");
+    LOG_DEBUG_S << "Batch planning requested for " << problems.size() << " problems: " << std::endl
+        << "-DOMAIN-" << std::endl << domainDescriptions;
+
+    // Resolve all planners upfront, so that an unknown planner does not leave
+    // any runners behind
+    std::vector<PDDLPlannerInterface*> portfolio;
+    std::set<std::string>::const_iterator it = planners.begin();
+    for(; it != planners.end(); ++it)
+    {
+        portfolio.push_back(getPlanner(*it));
+    }
+
+    // Results are placed by index, so that they are in input order regardless of the
+    // order of completion
+    std::vector<PlanResultList> results(problems.size());
+    for(size_t p = 0; p < problems.size(); ++p)
+    {
+        for(it = planners.begin(); it != planners.end(); ++it)
         {
-            mPlanRunners.push_back(new boost::thread(run_planner, (*it), problem, actionDescriptions, domainDescriptions, this, timeout));
+            results[p].push_back(PlanResult(*it, PlanCandidates()));
         }
-        std::vector<boost::thread *>::iterator itt = mPlanRunners.begin();
-        for(; itt != mPlanRunners.end(); ++itt)
+    }
+
+    BatchState state;
+    state.problems = &problems;
+    state.actionDescriptions = &actionDescriptions;
+    state.domainDescriptions = &domainDescriptions;
+    state.cache = getPlanCache();
+    state.callback = options.planCallback;
+    state.timeout = options.timeout;
+    state.hasDeadline = deadline > 0;
+    state.deadline = boost::chrono::steady_clock::now() + boost::chrono::milliseconds((int64_t)(1000. * deadline));
+    state.results = &results;
+
+    {
+        TaskGroup runners;
+        for(size_t p = 0; p < problems.size(); ++p)
+        {
+            for(size_t i = 0; i < portfolio.size(); ++i)
+            {
+                runners.run(boost::bind(run_batch_job, &state, portfolio[i], p, i), getPool(portfolio[i]));
+            }
+        }
+        runners.wait();
+    }
+
+    std::vector<PlanResultList>::const_iterator rit = results.begin();
+    for(; rit != results.end(); ++rit)
+    {
+        recordResults(actionDescriptions, domainDescriptions, *rit);
+    }
+    return results;
+}
+
+PlanResultList Planning::replan(const representation::Problem& problem, const Plan& previousPlan, const std::set<std::string>& planners, const PlanningOptions& options, size_t executedActions)
+{
+    TraceSpan span("plan repair", problem.name);
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    try {
+        PlanValidator validator(problem);
+        Plan suffix;
+        if(validator.findValidSuffix(previousPlan, executedActions, suffix))
         {
-            (*itt)->join();
-            delete (*itt);
+            span.end();
+            LOG_DEBUG("Repaired previous plan, %d actions remaining", (int) suffix.action_sequence.size());
+            PlanCandidates planCandidates;
+            planCandidates.addPlan(suffix);
+            planCandidates.statistics.wallTime = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+            planCandidates.statistics.timeToFirstPlan = planCandidates.statistics.wallTime;
+            planCandidates.updateStatistics();
+            if(options.planCallback)
+            {
+                options.planCallback(REPAIRED_PLAN, suffix);
+            }
+            return PlanResultList(1, PlanResult(REPAIRED_PLAN, planCandidates));
         }
+        LOG_DEBUG("Previous plan does not reach the goal anymore, planning from scratch");
+    } catch(const PlanGenerationException& e)
+    {
+        LOG_INFO("Previous plan cannot be repaired, planning from scratch: %s", e.what());
     }
-    return mPlanResultList;
+    span.end();
+
+    if(isUnsolvable(problem.domain, problem))
+    {
+        return createUnsolvableResults(planners);
+    }
+
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions, &problem.domain);
+    return planWithDescriptions(serialize_problem(problem), actionDescriptions, domainDescriptions, planners, options, CancellationToken());
+}
+
+PlanningHandle Planning::planAsync(const std::string& problem, const std::set<std::string>& planners, const PlanningOptions& options)
+{
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions);
+    return planAsyncWithDescriptions(problem, actionDescriptions, domainDescriptions, planners, options);
+}
+
+PlanningHandle Planning::planAsync(const representation::Problem& problem, const std::set<std::string>& planners, const PlanningOptions& options)
+{
+    if(isUnsolvable(problem.domain, problem))
+    {
+        PlanningHandle handle(boost::shared_ptr<PlanningHandle::State>(new PlanningHandle::State()));
+        handle.complete(createUnsolvableResults(planners), std::exception_ptr());
+        return handle;
+    }
+
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions, &problem.domain);
+    return planAsyncWithDescriptions(serialize_problem(problem), actionDescriptions, domainDescriptions, planners, options);
+}
+
+PlanningHandle Planning::planAsyncWithDescriptions(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, const PlanningOptions& options)
+{
+    // Report unknown planners to the caller right away
+    std::set<std::string>::const_iterator it = planners.begin();
+    for(; it != planners.end(); ++it)
+    {
+        getPlanner(*it);
+    }
+
+    PlanningHandle handle(boost::shared_ptr<PlanningHandle::State>(new PlanningHandle::State()));
+    boost::unique_lock<boost::mutex> lock(mAsyncMutex);
+    mAsyncCalls.push_back(handle);
+
+    // The orchestration runs in a thread of its own, since it waits for the planners
+    // which run in the thread pool
+    boost::thread runner(boost::bind(&Planning::runAsync, this, handle, problem, actionDescriptions, domainDescriptions, planners, options));
+    runner.detach();
+    return handle;
+}
+
+void Planning::runAsync(PlanningHandle handle, const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, const PlanningOptions& options)
+{
+    PlanResultList planResultList;
+    std::exception_ptr exception;
+    try {
+        planResultList = planWithDescriptions(problem, actionDescriptions, domainDescriptions, planners, options, handle.getState().token);
+    } catch(...)
+    {
+        exception = std::current_exception();
+    }
+    handle.complete(planResultList, exception);
+
+    boost::unique_lock<boost::mutex> lock(mAsyncMutex);
+    std::vector<PlanningHandle>::iterator hit = mAsyncCalls.begin();
+    for(; hit != mAsyncCalls.end(); ++hit)
+    {
+        if(hit->mState == handle.mState)
+        {
+            mAsyncCalls.erase(hit);
+            break;
+        }
+    }
+    mAsyncCondition.notify_all();
 }
 
 PlanCandidates Planning::plan(const std::string& problem, const std::string& plannerName, double timeout)
 {
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions);
+    return planWithDescriptions(problem, actionDescriptions, domainDescriptions, plannerName, timeout);
+}
+
+PlanCandidates Planning::planWithDescriptions(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::string& plannerName, double timeout)
+{
+    TraceSpan span("request");
     LOG_DEBUG_S << "Planning requested: " << std::endl
-        << "-DOMAIN-" << std::endl << getDomainDescriptions()
+        << "-DOMAIN-" << std::endl << domainDescriptions
         << "-PROBLEM-" << std::endl << problem;
     PDDLPlannerInterface* planner = getPlanner(plannerName);
-    return planner->plan(problem, getActionDescriptions(), getDomainDescriptions(), timeout);
+    PlanCandidates planCandidates = plan_cached(getPlanCache(), planner, plannerName, problem, actionDescriptions, domainDescriptions, timeout);
+    mPortfolioScheduler->record(PortfolioScheduler::createKey(domainDescriptions, actionDescriptions), plannerName, planCandidates.statistics);
+    return planCandidates;
 }
 
 
 PlanResultList Planning::plan(const representation::Problem& problem, const std::set<std::string>& planners, bool sequential, double timeout)
 {
-    setDomainDescription(problem.domain.name, problem.domain.toLISP());
-    return plan(problem.toLISP(), planners, sequential, timeout);
+    if(isUnsolvable(problem.domain, problem))
+    {
+        return createUnsolvableResults(planners);
+    }
+
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions, &problem.domain);
+    return planWithDescriptions(serialize_problem(problem), actionDescriptions, domainDescriptions, planners, sequential, timeout);
 }
 
 PlanResultList Planning::plan(const representation::Domain& domain, const representation::Problem& problem, const std::set<std::string>& planners, bool sequential, double timeout)
 {
-    setDomainDescription(domain.name, domain.toLISP());
-    return plan(problem.toLISP(), planners, sequential, timeout);
+    if(isUnsolvable(domain, problem))
+    {
+        return createUnsolvableResults(planners);
+    }
+
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions, &domain);
+    return planWithDescriptions(serialize_problem(problem), actionDescriptions, domainDescriptions, planners, sequential, timeout);
 }
 
 
 PlanCandidates Planning::plan(const representation::Problem& problem, const std::string& plannerName, double timeout)
 {
-    setDomainDescription(problem.domain.name, problem.domain.toLISP());
-    return plan(problem.toLISP(), plannerName, timeout);
+    if(isUnsolvable(problem.domain, problem))
+    {
+        return createUnsolvableResults(std::set<std::string>(&plannerName, &plannerName + 1)).front().second;
+    }
+
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions, &problem.domain);
+    return planWithDescriptions(serialize_problem(problem), actionDescriptions, domainDescriptions, plannerName, timeout);
 }
 
 PlanCandidates Planning::plan(const representation::Domain& domain, const representation::Problem& problem, const std::string& plannerName, double timeout)
 {
-    setDomainDescription(domain.name, domain.toLISP());
-    return plan(problem.toLISP(), plannerName, timeout);
+    if(isUnsolvable(domain, problem))
+    {
+        return createUnsolvableResults(std::set<std::string>(&plannerName, &plannerName + 1)).front().second;
+    }
+
+    std::string actionDescriptions, domainDescriptions;
+    getDescriptions(domainDescriptions, actionDescriptions, &domain);
+    return planWithDescriptions(serialize_problem(problem), actionDescriptions, domainDescriptions, plannerName, timeout);
 }
 
 }
@@ -9,10 +9,21 @@
 #include <string>
 #include <pddl_planner/representation/Problem.hpp>
 #include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <pddl_planner/PlanCache.hpp>
+#include <pddl_planner/TranslationCache.hpp>
+#include <pddl_planner/PortfolioScheduler.hpp>
+#include <pddl_planner/PlanningHandle.hpp>
+#include <pddl_planner/CancellationToken.hpp>
+#include <pddl_planner/Process.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
 #include <boost/thread.hpp>
 
 #define TIMEOUT 7.
+// Name of the result of Planning::replan holding the repaired previous plan
+#define REPAIRED_PLAN "REPAIRED"
 
 /**
  * \mainpage PDDL based planning
@@ -150,21 +161,64 @@
 namespace pddl_planner
 {
     class PDDLPlannerInterface;
-    typedef std::string PlannerName;
     typedef std::map<std::string, std::string> ActionDescriptions;
     typedef std::map<std::string, std::string> DomainDescriptions;
     typedef std::map<std::string, PDDLPlannerInterface*> PlannerMap;
     typedef std::vector<PDDLPlannerInterface*> PlannerList;
-    typedef std::pair<PlannerName, PlanCandidates> PlanResult;
-    typedef std::vector< PlanResult > PlanResultList;
+    // Callback receiving each plan of a planner as soon as it is available
+    typedef boost::function<void (const PlannerName& planner, const Plan& plan)> PlanResultCallback;
+
+    /**
+     * Options of a planning call
+     */
+    struct PlanningOptions
+    {
+        enum Mode {
+            // Run all planners in parallel and collect all results
+            PARALLEL,
+            // Run the planners one after another
+            SEQUENTIAL,
+            // Run all planners in parallel until the first solution is found, see Planning::planFirstWins
+            FIRST_WINS,
+            // Run the planners one after another in the order of their history on the domain
+            // until the first solution is found -- the timeout is shared by all planners, see
+            // PortfolioScheduler::scheduleSequential
+            ADAPTIVE_SEQUENTIAL,
+            // Run the portfolioSize planners with the best history on the domain in parallel
+            ADAPTIVE_PARALLEL
+        };
+
+        PlanningOptions()
+            : mode(PARALLEL)
+            , timeout(TIMEOUT)
+            , gracePeriod(0.0)
+            , portfolioSize(0)
+        {}
+
+        Mode mode;
+        // Timeout in seconds -- applies to each planner call individually, except for
+        // ADAPTIVE_SEQUENTIAL mode where it is the total timeout
+        double timeout;
+        // Grace period in seconds for FIRST_WINS mode
+        double gracePeriod;
+        // Number of planners to run in ADAPTIVE_PARALLEL mode, 0 will use the number of available cores
+        size_t portfolioSize;
+        // Optional callback, which gets every plan as soon as a planner has written it
+        // -- it is called from the planner's thread
+        PlanResultCallback planCallback;
+    };
 
     /**
      * \class Planning
      * \brief Planning provides the main infrastructure to perform planning with different
      * planner implementations
+     * \details All methods are thread-safe -- a single instance can serve concurrent
+     * planning calls, where each call returns its own results
      */
     class Planning
     {
+        // The server runs requests with the descriptions it has received
+        friend class PlanningServer;
 
     public:
         /**
@@ -174,7 +228,8 @@ namespace pddl_planner
         Planning();
 
         /**
-         * Deconstructor deleting all internal instances of associated planners
+         * Deconstructor deleting all internal instances of associated planners -- pending
+         * asynchronous planning calls are cancelled and waited for
          */
         ~Planning();
 
@@ -183,7 +238,7 @@ namespace pddl_planner
          * Retrieve the map of all registered planners 
          * \return map of registered planners
          */
-        PlannerMap getPlanners() { return mPlanners; }
+        PlannerMap getPlanners() const;
         
         /**
          * Retrieves available planners
@@ -205,7 +260,7 @@ namespace pddl_planner
         /**
          * Check if there is a planner of the given name
          */
-        bool isRegistered(const std::string& name) const { return mPlanners.count(name); }
+        bool isRegistered(const std::string& name) const;
 
         /**
          * Retrieve planner by name
@@ -258,7 +313,9 @@ namespace pddl_planner
          * \param problem Planning problem
          * \param planners List of planners that will be used for planning
          * \param sequential Set to true if planners should be called one after
-         * another, false will execute all planners in parallel
+         * another, false will execute all planners in parallel -- parallel planners
+         * run in ThreadPool::getDefault(), which limits the number of planners running
+         * at the same time across all Planning instances
          * \param timeout Timeout in seconds -- will apply to each planner call
          * individually when using with sequential
          * \throws PlanGenerationException on failure
@@ -290,15 +347,266 @@ namespace pddl_planner
          */
         PlanCandidates plan(const representation::Domain& domain, const representation::Problem& problem, const std::string& plannerName = "LAMA", double timeout = TIMEOUT);
 
+        /**
+         * Plan with a portfolio of planners running in parallel and return as soon as the
+         * first planner provides a plan -- all other planners are cancelled then
+         * \param problem Planning problem
+         * \param planners List of planners that will be used for planning
+         * \param timeout Timeout in seconds -- will apply to each planner call
+         * \param gracePeriod Time in seconds to keep the remaining planners running after the first
+         * solution has been found, e.g. to collect better plans
+         * \return List of solutions in order of completion, where the first entry is the one of the winning planner
+         * \throws PlanGenerationException on failure
+         */
+        PlanResultList planFirstWins(const std::string& problem, const std::set<std::string>& planners, double timeout = TIMEOUT, double gracePeriod = 0.0);
+
+        /**
+         * Plan with a portfolio of planners running in parallel and return as soon as the
+         * first planner provides a solution -- the problem definition here already contains
+         * the domain description
+         * \see planFirstWins(const std::string&, const std::set<std::string>&, double, double)
+         * \throws PlanGenerationException on failure
+         */
+        PlanResultList planFirstWins(const representation::Problem& problem, const std::set<std::string>& planners, double timeout = TIMEOUT, double gracePeriod = 0.0);
+
+        /**
+         * Plan with the given options
+         * \param problem Planning problem
+         * \param planners List of planners that will be used for planning
+         * \param options Planning mode, timeouts and the callback for streaming plans
+         * \return List of solutions
+         * \throws PlanGenerationException on failure
+         */
+        PlanResultList plan(const std::string& problem, const std::set<std::string>& planners, const PlanningOptions& options);
+
+        /**
+         * Replan after the problem has changed, e.g. since execution monitoring reported
+         * changed facts -- the remaining actions of the previous plan are simulated on the
+         * new initial status first, see PlanValidator, and the planners are only called if
+         * no suffix of the previous plan reaches the goal anymore
+         * \param problem Planning problem with the current initial status
+         * \param previousPlan Plan which has been executed up to executedActions
+         * \param planners List of planners that will be used if the previous plan cannot
+         * be repaired
+         * \param options Planning mode and timeouts for the planners -- the callback also
+         * receives a repaired plan
+         * \param executedActions Number of actions of the previous plan which have already
+         * been executed
+         * \return a single result of REPAIRED_PLAN holding the shortest valid suffix of the
+         * previous plan, or the results of the planners
+         * \throws PlanGenerationException on failure
+         */
+        PlanResultList replan(const representation::Problem& problem, const Plan& previousPlan, const std::set<std::string>& planners, const PlanningOptions& options = PlanningOptions(), size_t executedActions = 0);
+
+        /**
+         * Plan asynchronously, i.e. return immediately while the planners are running in the background
+         * \param problem Planning problem
+         * \param planners List of planners that will be used for planning
+         * \param options Planning mode and timeouts
+         * \return Handle to poll or wait for the results, or to cancel the planning call
+         * \throws std::runtime_error if a planner does not exist
+         */
+        PlanningHandle planAsync(const std::string& problem, const std::set<std::string>& planners, const PlanningOptions& options = PlanningOptions());
+
+        /**
+         * Plan asynchronously -- the problem definition here already contains
+         * the domain description
+         * \see planAsync(const std::string&, const std::set<std::string>&, const PlanningOptions&)
+         */
+        PlanningHandle planAsync(const representation::Problem& problem, const std::set<std::string>& planners, const PlanningOptions& options = PlanningOptions());
+
+        /**
+         * Solve many independent problems of one domain -- the domain is serialized once and
+         * all (problem, planner) pairs run as individual jobs in ThreadPool::getDefault()
+         * \param domain Planning domain of all problems, which overrides the problems' domain
+         * \param problems Planning problems
+         * \param planners List of planners that will be used for each problem
+         * \param options Timeout of each job and the callback for streaming plans -- the
+         * planners of a problem always run as in PARALLEL mode
+         * \param deadline Time in seconds for the complete batch, 0 for no limit -- jobs
+         * which have not started before the deadline are skipped
+         * \return Results in the order of the problems, the results of a problem are in
+         * the order of the planners
+         * \throws std::runtime_error if a planner does not exist
+         */
+        std::vector<PlanResultList> planBatch(const representation::Domain& domain, const std::vector<representation::Problem>& problems, const std::set<std::string>& planners, const PlanningOptions& options = PlanningOptions(), double deadline = 0.0);
+
+        /**
+         * Solve many independent problems with the current domain and action descriptions
+         * \see planBatch(const representation::Domain&, const std::vector<representation::Problem>&, const std::set<std::string>&, const PlanningOptions&, double)
+         */
+        std::vector<PlanResultList> planBatch(const std::vector<std::string>& problems, const std::set<std::string>& planners, const PlanningOptions& options = PlanningOptions(), double deadline = 0.0);
+
+        /**
+         * Enable caching of planning results -- a planner will not be called again
+         * for a domain and problem it has already solved
+         * \param capacity Maximum number of entries kept in memory
+         * \param directory Directory to store the entries persistently, an empty string
+         * keeps the entries in memory only
+         * \throws PlanGenerationException if directory cannot be created
+         */
+        void enablePlanCache(size_t capacity = 128, const std::string& directory = "");
+
+        /**
+         * Disable caching of planning results
+         */
+        void disablePlanCache();
+
+        /**
+         * Retrieve the plan cache
+         * \return plan cache, or an empty pointer if caching is disabled
+         */
+        boost::shared_ptr<PlanCache> getPlanCache() const;
+
+        /**
+         * Enable caching of translated tasks for the Fast Downward based planners -- the
+         * translation of a domain and problem is then shared by all these planners and
+         * by subsequent calls, so that only the search is run per planner
+         * \param directory Directory to store the translated tasks in, an empty string
+         * selects a directory in the system's temporary directory
+         * \param capacity Maximum number of stored tasks
+         * \throws PlanGenerationException if directory cannot be created
+         */
+        void enableTranslationCache(const std::string& directory = "", size_t capacity = 16);
+
+        /**
+         * Disable caching of translated tasks
+         */
+        void disableTranslationCache();
+
+        /**
+         * Retrieve the translation cache
+         * \return translation cache, or an empty pointer if caching is disabled
+         */
+        boost::shared_ptr<TranslationCache> getTranslationCache() const;
+
+        /**
+         * Retrieve the portfolio scheduler, which records the outcome of all planner calls
+         * -- e.g. to save the records or to load the records of previous runs
+         * \return portfolio scheduler
+         */
+        boost::shared_ptr<PortfolioScheduler> getPortfolioScheduler() const { return mPortfolioScheduler; }
+
+        /**
+         * Keep pre-forked worker processes, which start the planners without forking
+         * this process on the request path -- the workers are shared by all Planning
+         * instances, see ProcessPool
+         * \param workers Number of idle workers, 0 will keep one worker per registered planner
+         */
+        void enableWarmWorkers(size_t workers = 0);
+
+        /**
+         * Stop keeping pre-forked worker processes, planners are forked on demand again
+         */
+        void disableWarmWorkers();
+
+        /**
+         * Set the resource limits of the processes of a planner, e.g. to cap the memory of
+         * memory-hungry Fast Downward aliases
+         * \param planner Name of the planner
+         * \param limits Resource limits, see PDDLPlannerInterface::setResourceLimits
+         * \throws std::runtime_error if the planner does not exist
+         */
+        void setResourceLimits(const std::string& planner, const ResourceLimits& limits);
+
+        /**
+         * Pin planner processes to cores, so that planners running in parallel get disjoint
+         * sets of cores -- the cores are shared by all Planning instances, see CoreAllocator
+         * \param coresPerPlanner Number of cores of each planner process
+         */
+        void enableCorePinning(size_t coresPerPlanner = 1);
+
+        /**
+         * Stop pinning planner processes to cores
+         */
+        void disableCorePinning();
+
+        /**
+         * Record tracing spans of the stages of all planning calls, e.g. serialization,
+         * workspace setup, planner start, search and reading of plans -- the spans are shared
+         * by all Planning instances and can be saved as Chrome trace, see Tracer
+         * \param capacity Maximum number of spans kept in memory
+         */
+        void enableTracing(size_t capacity = 1000000);
+
+        /**
+         * Stop recording tracing spans
+         */
+        void disableTracing();
+
+        /**
+         * Check problems given as representation::Problem with a relaxed reachability
+         * analysis before calling any planner, see ReachabilityAnalysis -- a provably
+         * unsolvable problem immediately returns an empty result per planner, where the
+         * statistics are marked as unsolvable
+         */
+        void enableReachabilityCheck();
+
+        /**
+         * Stop checking problems before calling the planners
+         */
+        void disableReachabilityCheck();
+
     private:
+        /**
+         * Check if a problem is provably unsolvable, given that the reachability check is enabled
+         */
+        bool isUnsolvable(const representation::Domain& domain, const representation::Problem& problem) const;
+
+        /**
+         * Create the result of a provably unsolvable problem, i.e. an empty result per planner
+         * \throws std::runtime_error if a planner does not exist
+         */
+        PlanResultList createUnsolvableResults(const std::set<std::string>& planners) const;
+
+        /**
+         * Hand the translation cache to all registered planners supporting it
+         */
+        void setTranslationCache(const boost::shared_ptr<TranslationCache>& cache);
+
+        /**
+         * Read the domain and action descriptions at once
+         * \param domain If given, this domain's description will be set before reading the
+         * descriptions
+         */
+        void getDescriptions(std::string& domainDescriptions, std::string& actionDescriptions, const representation::Domain* domain = NULL);
+
+        PlanResultList planWithDescriptions(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, bool sequential, double timeout, const CancellationToken& token = CancellationToken(), const PlanResultCallback& callback = PlanResultCallback());
+        PlanResultList planWithDescriptions(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, const PlanningOptions& options, const CancellationToken& token);
+        PlanCandidates planWithDescriptions(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::string& plannerName, double timeout);
+        PlanResultList planFirstWinsWithDescriptions(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, double timeout, double gracePeriod, const CancellationToken& token = CancellationToken(), const PlanResultCallback& callback = PlanResultCallback());
+
+        PlanResultList planAdaptiveWithDescriptions(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, const PlanningOptions& options, const CancellationToken& token);
+
+        /**
+         * Record the outcome of the planner calls in the portfolio scheduler
+         */
+        void recordResults(const std::string& actionDescriptions, const std::string& domainDescriptions, const PlanResultList& planResultList);
+
+        std::vector<PlanResultList> planBatchWithDescriptions(const std::vector<std::string>& problems, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, const PlanningOptions& options, double deadline);
+
+        PlanningHandle planAsyncWithDescriptions(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, const PlanningOptions& options);
+
+        /**
+         * Body of the thread running an asynchronous planning call
+         */
+        void runAsync(PlanningHandle handle, const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, const std::set<std::string>& planners, const PlanningOptions& options);
+
+        // Guards planners, descriptions and cache -- planning calls only hold it
+        // while reading their inputs, so that concurrent calls do not block each other
+        mutable boost::shared_mutex mMutex;
         PlannerMap mPlanners;
         ActionDescriptions mActionDescriptions;
         DomainDescriptions mDomainDescriptions;
-        std::vector<boost::thread *> mPlanRunners;
-    public:
-        PlanResultList     mPlanResultList;
-        boost::mutex  mResultMutex;
-        boost::mutex mPlannerMutex;
+        boost::shared_ptr<PlanCache> mPlanCache;
+        boost::shared_ptr<TranslationCache> mTranslationCache;
+        boost::shared_ptr<PortfolioScheduler> mPortfolioScheduler;
+        bool mReachabilityCheck;
+
+        // Asynchronous planning calls which are still running
+        boost::mutex mAsyncMutex;
+        boost::condition_variable mAsyncCondition;
+        std::vector<PlanningHandle> mAsyncCalls;
     };
 
 
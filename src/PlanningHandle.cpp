@@ -0,0 +1,111 @@
+#include <pddl_planner/PlanningHandle.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <base/logging.h>
+
+namespace pddl_planner
+{
+
+bool PlanningHandle::isDone() const
+{
+    State& state = getState();
+    boost::unique_lock<boost::mutex> lock(state.mutex);
+    return state.done;
+}
+
+bool PlanningHandle::waitFor(double timeout) const
+{
+    State& state = getState();
+    boost::chrono::steady_clock::time_point deadline = boost::chrono::steady_clock::now() + boost::chrono::microseconds((int64_t)(1000000. * timeout));
+    boost::unique_lock<boost::mutex> lock(state.mutex);
+    while(!state.done)
+    {
+        if(boost::cv_status::timeout == state.condition.wait_until(lock, deadline))
+        {
+            return state.done;
+        }
+    }
+    return true;
+}
+
+void PlanningHandle::wait() const
+{
+    State& state = getState();
+    boost::unique_lock<boost::mutex> lock(state.mutex);
+    while(!state.done)
+    {
+        state.condition.wait(lock);
+    }
+}
+
+PlanResultList PlanningHandle::get() const
+{
+    wait();
+
+    State& state = getState();
+    boost::unique_lock<boost::mutex> lock(state.mutex);
+    if(state.exception)
+    {
+        std::rethrow_exception(state.exception);
+    }
+    return state.planResultList;
+}
+
+void PlanningHandle::cancel()
+{
+    getState().token.cancel();
+}
+
+bool PlanningHandle::isCancelled() const
+{
+    return getState().token.isCancelled();
+}
+
+void PlanningHandle::setCallback(const Callback& callback)
+{
+    State& state = getState();
+    {
+        boost::unique_lock<boost::mutex> lock(state.mutex);
+        if(!state.done)
+        {
+            state.callback = callback;
+            return;
+        }
+    }
+    callback(*this);
+}
+
+void PlanningHandle::complete(const PlanResultList& planResultList, std::exception_ptr exception)
+{
+    State& state = getState();
+    Callback callback;
+    {
+        boost::unique_lock<boost::mutex> lock(state.mutex);
+        state.planResultList = planResultList;
+        state.exception = exception;
+        state.done = true;
+        callback = state.callback;
+        state.callback = Callback();
+        state.condition.notify_all();
+    }
+
+    if(callback)
+    {
+        try {
+            callback(*this);
+        } catch(const std::exception& e)
+        {
+            LOG_ERROR("PlanningHandle: completion callback failed: %s", e.what());
+        }
+    }
+}
+
+PlanningHandle::State& PlanningHandle::getState() const
+{
+    if(!mState)
+    {
+        throw PlanGenerationException("PlanningHandle: handle does not refer to a planning call");
+    }
+    return *mState;
+}
+
+} // end namespace pddl_planner
@@ -0,0 +1,114 @@
+#ifndef PDDL_PLANNER_PLANNING_HANDLE_HPP
+#define PDDL_PLANNER_PLANNING_HANDLE_HPP
+
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <pddl_planner/CancellationToken.hpp>
+#include <exception>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace pddl_planner
+{
+    class Planning;
+
+    /**
+     * \class PlanningHandle
+     * \brief Handle of an asynchronous planning call as returned by Planning::planAsync
+     * \details Copies of a handle refer to the same planning call
+     */
+    class PlanningHandle
+    {
+    public:
+        typedef boost::function<void (const PlanningHandle& handle)> Callback;
+
+        /**
+         * Create an invalid handle, i.e. one which does not refer to any planning call
+         */
+        PlanningHandle() {}
+
+        /**
+         * Check whether this handle refers to a planning call
+         * \return true if handle is valid, false otherwise
+         */
+        bool isValid() const { return mState.get() != NULL; }
+
+        /**
+         * Check whether the planning call has completed
+         * \return true if results are available, false otherwise
+         */
+        bool isDone() const;
+
+        /**
+         * Wait for the planning call to complete
+         * \param timeout Maximum time to wait in seconds
+         * \return true if the call has completed, false if the timeout expired
+         */
+        bool waitFor(double timeout) const;
+
+        /**
+         * Wait for the planning call to complete
+         */
+        void wait() const;
+
+        /**
+         * Wait for the planning call to complete and retrieve the results
+         * \return List of solutions as the corresponding synchronous planning call provides it
+         * \throws exception of the planning call on failure
+         */
+        PlanResultList get() const;
+
+        /**
+         * Cancel the planning call -- running planners will be killed and planners which
+         * have not been started yet will be skipped, the call completes with the results
+         * collected so far
+         */
+        void cancel();
+
+        /**
+         * Check whether cancellation has been requested
+         * \return true if cancelled, false otherwise
+         */
+        bool isCancelled() const;
+
+        /**
+         * Set the callback which will be called once the planning call completes -- it is called
+         * from the planning thread, or immediately from the calling thread when the call
+         * has already completed
+         * \param callback Callback, which gets this handle to retrieve the results
+         */
+        void setCallback(const Callback& callback);
+
+    private:
+        friend class Planning;
+
+        struct State
+        {
+            State() : done(false) {}
+
+            boost::mutex mutex;
+            boost::condition_variable condition;
+            bool done;
+            PlanResultList planResultList;
+            std::exception_ptr exception;
+            CancellationToken token;
+            Callback callback;
+        };
+
+        PlanningHandle(const boost::shared_ptr<State>& state) : mState(state) {}
+
+        /**
+         * Complete the planning call and run the callback
+         */
+        void complete(const PlanResultList& planResultList, std::exception_ptr exception);
+
+        /**
+         * Get the state or throw if the handle is invalid
+         */
+        State& getState() const;
+
+        boost::shared_ptr<State> mState;
+    };
+}
+#endif // PDDL_PLANNER_PLANNING_HANDLE_HPP
@@ -0,0 +1,276 @@
+#include <pddl_planner/PlanningServer.hpp>
+#include <pddl_planner/RemoteConnection.hpp>
+#include <pddl_planner/Planning.hpp>
+#include <boost/bind.hpp>
+#include <base/logging.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+#include <sstream>
+
+namespace pddl_planner
+{
+
+namespace
+{
+    // Time in seconds a client may take to send its request
+    const double REQUEST_TIMEOUT = 30.0;
+    // Interval in seconds at which running requests check for cancellation
+    const double POLL_INTERVAL = 0.01;
+    // Interval in milliseconds at which the accepting thread checks for shutdown
+    const int ACCEPT_POLL_INTERVAL = 100;
+
+    /**
+     * Stream a plan to the client -- called from the planner's thread
+     */
+    void sendPlan(RemoteConnection* connection, boost::mutex* mutex, const Plan& plan)
+    {
+        std::stringstream ss;
+        ss << "PLAN " << plan.action_sequence.size() << " " << plan.cost << "\n";
+        std::vector<Action>::const_iterator it = plan.action_sequence.begin();
+        for(; it != plan.action_sequence.end(); ++it)
+        {
+            ss << it->toString() << "\n";
+        }
+
+        boost::unique_lock<boost::mutex> lock(*mutex);
+        try {
+            connection->send(ss.str());
+        } catch(const PlanGenerationException& e)
+        {
+            // The client has gone, which cancels the request
+            LOG_DEBUG("PlanningServer: %s", e.what());
+        }
+    }
+}
+
+PlanningServer::PlanningServer(Planning& planning, unsigned short port, const std::string& address)
+    : mPlanning(planning)
+    , mAddress(address)
+    , mPort(port)
+    , mListenFd(-1)
+    , mShutdown(false)
+    , mConnections(0)
+    , mQueueDepth(0)
+{}
+
+PlanningServer::~PlanningServer()
+{
+    stop();
+}
+
+void PlanningServer::start()
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    if(mListenFd != -1)
+    {
+        return;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(fd == -1)
+    {
+        throw PlanGenerationException("PlanningServer: failed to create socket: " + std::string(strerror(errno)));
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(mPort);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    if(!mAddress.empty() && 1 != inet_pton(AF_INET, mAddress.c_str(), &address.sin_addr))
+    {
+        close(fd);
+        throw PlanGenerationException("PlanningServer: invalid address '" + mAddress + "'");
+    }
+
+    if(-1 == bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) || -1 == listen(fd, SOMAXCONN))
+    {
+        std::string error = strerror(errno);
+        close(fd);
+        throw PlanGenerationException("PlanningServer: failed to listen: " + error);
+    }
+
+    socklen_t length = sizeof(address);
+    getsockname(fd, reinterpret_cast<struct sockaddr*>(&address), &length);
+    mPort = ntohs(address.sin_port);
+    mListenFd = fd;
+    mShutdown = false;
+    mAcceptThread = boost::thread(boost::bind(&PlanningServer::acceptLoop, this));
+    LOG_INFO("PlanningServer: listening on port %d", (int) mPort);
+}
+
+void PlanningServer::stop()
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        if(mListenFd == -1)
+        {
+            return;
+        }
+        mShutdown = true;
+    }
+    mAcceptThread.join();
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    while(mConnections > 0)
+    {
+        mCondition.wait(lock);
+    }
+    close(mListenFd);
+    mListenFd = -1;
+}
+
+unsigned short PlanningServer::getPort() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mPort;
+}
+
+size_t PlanningServer::getQueueDepth() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mQueueDepth;
+}
+
+bool PlanningServer::isShutdown() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mShutdown;
+}
+
+void PlanningServer::acceptLoop()
+{
+    while(!isShutdown())
+    {
+        struct pollfd pfd;
+        pfd.fd = mListenFd;
+        pfd.events = POLLIN;
+        if(poll(&pfd, 1, ACCEPT_POLL_INTERVAL) <= 0)
+        {
+            continue;
+        }
+
+        int fd = accept4(mListenFd, NULL, NULL, SOCK_CLOEXEC);
+        if(fd == -1)
+        {
+            continue;
+        }
+
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        ++mConnections;
+        boost::thread handler(boost::bind(&PlanningServer::serve, this, fd));
+        handler.detach();
+    }
+}
+
+void PlanningServer::serve(int fd)
+{
+    {
+        RemoteConnection connection(fd);
+        try {
+            std::string header;
+            if(connection.readLine(header, REQUEST_TIMEOUT))
+            {
+                if(header == "STATUS")
+                {
+                    std::stringstream ss;
+                    ss << "STATUS " << getQueueDepth() << "\n";
+                    connection.send(ss.str());
+                } else if(header.compare(0, 5, "PLAN ") == 0)
+                {
+                    servePlanRequest(connection, header);
+                } else {
+                    LOG_WARN("PlanningServer: invalid request '%s'", header.c_str());
+                }
+            }
+        } catch(const PlanGenerationException& e)
+        {
+            LOG_DEBUG("PlanningServer: %s", e.what());
+        }
+    }
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    --mConnections;
+    mCondition.notify_all();
+}
+
+void PlanningServer::servePlanRequest(RemoteConnection& connection, const std::string& header)
+{
+    std::istringstream ss(header.substr(5));
+    std::string planner;
+    double timeout;
+    size_t domainSize, actionSize, problemSize;
+    std::string domainDescriptions, actionDescriptions, problem;
+    if(!(ss >> planner >> timeout >> domainSize >> actionSize >> problemSize)
+            || !connection.readBytes(domainSize, domainDescriptions, REQUEST_TIMEOUT)
+            || !connection.readBytes(actionSize, actionDescriptions, REQUEST_TIMEOUT)
+            || !connection.readBytes(problemSize, problem, REQUEST_TIMEOUT))
+    {
+        LOG_WARN("PlanningServer: invalid request '%s'", header.c_str());
+        return;
+    }
+
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        ++mQueueDepth;
+    }
+
+    boost::mutex sendMutex;
+    std::string response;
+    try {
+        PlanningOptions options;
+        options.timeout = timeout;
+        options.planCallback = boost::bind(sendPlan, &connection, &sendMutex, _2);
+        std::set<std::string> planners;
+        planners.insert(planner);
+        PlanningHandle handle = mPlanning.planAsyncWithDescriptions(problem, actionDescriptions, domainDescriptions, planners, options);
+
+        while(!handle.waitFor(POLL_INTERVAL))
+        {
+            std::string line;
+            bool cancel = isShutdown();
+            try {
+                cancel = cancel || (connection.readLine(line, 0) && line == "CANCEL");
+            } catch(const PlanGenerationException& e)
+            {
+                // Connection has been closed by the client
+                cancel = true;
+            }
+            if(cancel && !handle.isCancelled())
+            {
+                LOG_INFO("PlanningServer: cancelling request for planner %s", planner.c_str());
+                handle.cancel();
+            }
+        }
+
+        PlanResultList planResultList = handle.get();
+        PlannerStatistics statistics;
+        if(!planResultList.empty())
+        {
+            statistics = planResultList.front().second.statistics;
+        }
+        response = "DONE " + RemoteConnection::encodeStatistics(statistics) + "\n";
+    } catch(const std::runtime_error& e)
+    {
+        std::stringstream error;
+        error << "ERROR " << strlen(e.what()) << "\n" << e.what();
+        response = error.str();
+    }
+
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        --mQueueDepth;
+    }
+
+    boost::unique_lock<boost::mutex> lock(sendMutex);
+    connection.send(response);
+}
+
+} // end namespace pddl_planner
@@ -0,0 +1,96 @@
+#ifndef PDDL_PLANNER_PLANNING_SERVER_HPP
+#define PDDL_PLANNER_PLANNING_SERVER_HPP
+
+#include <string>
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace pddl_planner
+{
+    class Planning;
+    class RemoteConnection;
+
+    /**
+     * \class PlanningServer
+     * \brief Worker daemon, which serves planning requests of remote planners via TCP
+     * \details Each connection carries a single request, which runs in the embedded Planning
+     * instance. Plans are streamed back as soon as they are available and a request is
+     * cancelled when the client asks for it or closes the connection. The protocol is
+     * described in RemoteConnection
+     */
+    class PlanningServer
+    {
+    public:
+        /**
+         * Constructor
+         * \param planning Planning instance which runs the requests, it has to outlive the server
+         * \param port TCP port to listen on, 0 selects a free port
+         * \param address Address to listen on, an empty string listens on all interfaces
+         */
+        PlanningServer(Planning& planning, unsigned short port = 0, const std::string& address = "");
+
+        /**
+         * Deconstructor stops the server
+         */
+        ~PlanningServer();
+
+        /**
+         * Start accepting connections
+         * \throws PlanGenerationException if the server cannot listen on the given port
+         */
+        void start();
+
+        /**
+         * Stop accepting connections, cancel the running requests and wait for them
+         */
+        void stop();
+
+        /**
+         * Get the port the server listens on, which is known after start
+         * \return TCP port
+         */
+        unsigned short getPort() const;
+
+        /**
+         * Get the number of planning requests which are currently running
+         * \return queue depth
+         */
+        size_t getQueueDepth() const;
+
+    private:
+        PlanningServer(const PlanningServer& other);
+        PlanningServer& operator=(const PlanningServer& other);
+
+        /**
+         * Loop of the thread accepting connections
+         */
+        void acceptLoop();
+
+        /**
+         * Serve the request of a connection
+         */
+        void serve(int fd);
+
+        /**
+         * Run a planning request and stream its results
+         * \param header Request line
+         */
+        void servePlanRequest(RemoteConnection& connection, const std::string& header);
+
+        bool isShutdown() const;
+
+        Planning& mPlanning;
+        std::string mAddress;
+        unsigned short mPort;
+        int mListenFd;
+
+        mutable boost::mutex mMutex;
+        boost::condition_variable mCondition;
+        boost::thread mAcceptThread;
+        bool mShutdown;
+        size_t mConnections;
+        size_t mQueueDepth;
+    };
+}
+#endif // PDDL_PLANNER_PLANNING_SERVER_HPP
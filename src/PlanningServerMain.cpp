@@ -0,0 +1,85 @@
+/**
+ *
+ *      Worker daemon serving the requests of remote planners
+ *
+ * usage:
+ *
+ *  ./pddl_planner_server [-a <address>] [-w <# of warm workers>] <port>
+ *
+ *
+ *          -a,  --address              listen on the given address only
+ *          -w,  --warm-workers         start planners from pre-forked worker processes
+ *
+ *      Clients use pddl_planner::remote::Planner with the endpoint '<host>:<port>'
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <signal.h>
+#include <pddl_planner/Planning.hpp>
+#include <pddl_planner/PlanningServer.hpp>
+
+void usage(const char* name)
+{
+    std::cout << "usage: " << name << " [-a <address>] [-w <# of warm workers>] <port>" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    std::string address;
+    int warmWorkers = -1;
+    int port = -1;
+    for(int i = 1; i < argc; ++i)
+    {
+        if((!strcmp(argv[i], "-a") || !strcmp(argv[i], "--address")) && i + 1 < argc)
+        {
+            address = argv[++i];
+        } else if((!strcmp(argv[i], "-w") || !strcmp(argv[i], "--warm-workers")) && i + 1 < argc)
+        {
+            warmWorkers = atoi(argv[++i]);
+        } else if(port == -1)
+        {
+            port = atoi(argv[i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(port < 0 || port > 65535)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Block the termination signals, so that they can be awaited below
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+    pddl_planner::Planning planning;
+    if(warmWorkers >= 0)
+    {
+        planning.enableWarmWorkers(warmWorkers);
+    }
+
+    pddl_planner::PlanningServer server(planning, port, address);
+    try {
+        server.start();
+    } catch(const pddl_planner::PlanGenerationException& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "Listening on port " << server.getPort() << std::endl;
+
+    int signal;
+    sigwait(&signals, &signal);
+    std::cout << "Shutting down" << std::endl;
+    server.stop();
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <pddl_planner/PortfolioScheduler.hpp>
+#include <pddl_planner/PlanCache.hpp>
+#include <base/logging.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace pddl_planner
+{
+
+namespace
+{
+    struct RankedPlanner
+    {
+        PlannerName planner;
+        double successRate;
+        double solveTime;
+
+        bool operator<(const RankedPlanner& other) const
+        {
+            if(successRate != other.successRate)
+            {
+                return successRate > other.successRate;
+            }
+            // Planners without solution come last
+            if(solveTime != other.solveTime)
+            {
+                return solveTime >= 0 && (other.solveTime < 0 || solveTime < other.solveTime);
+            }
+            return planner < other.planner;
+        }
+    };
+}
+
+PortfolioScheduler::PortfolioScheduler(double minimumSlice)
+    : mMinimumSlice(minimumSlice)
+{}
+
+std::string PortfolioScheduler::createKey(const std::string& domainDescriptions, const std::string& actionDescriptions)
+{
+    return PlanCache::createKey("portfolio", domainDescriptions, actionDescriptions, "");
+}
+
+void PortfolioScheduler::record(const std::string& domain, const PlannerName& planner, const PlannerStatistics& statistics)
+{
+    if(statistics.cancelled || statistics.cached || statistics.unsolvable)
+    {
+        return;
+    }
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    PlannerRecord& record = mRecords[domain][planner];
+    ++record.runs;
+    if(statistics.planCount > 0)
+    {
+        ++record.successes;
+        record.solveTime += statistics.timeToFirstPlan >= 0 ? statistics.timeToFirstPlan : statistics.wallTime;
+    }
+}
+
+PlannerRecord PortfolioScheduler::getRecord(const std::string& domain, const PlannerName& planner) const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    std::map<std::string, PlannerRecords>::const_iterator it = mRecords.find(domain);
+    if(it != mRecords.end())
+    {
+        PlannerRecords::const_iterator rit = it->second.find(planner);
+        if(rit != it->second.end())
+        {
+            return rit->second;
+        }
+    }
+    return PlannerRecord();
+}
+
+std::vector<PlannerName> PortfolioScheduler::rank(const std::string& domain, const std::set<PlannerName>& planners) const
+{
+    std::vector<RankedPlanner> ranking;
+    std::set<PlannerName>::const_iterator it = planners.begin();
+    for(; it != planners.end(); ++it)
+    {
+        PlannerRecord record = getRecord(domain, *it);
+        RankedPlanner rankedPlanner;
+        rankedPlanner.planner = *it;
+        rankedPlanner.successRate = record.getSuccessRate();
+        rankedPlanner.solveTime = record.getMeanSolveTime();
+        ranking.push_back(rankedPlanner);
+    }
+    std::sort(ranking.begin(), ranking.end());
+
+    std::vector<PlannerName> ranked;
+    std::vector<RankedPlanner>::const_iterator rit = ranking.begin();
+    for(; rit != ranking.end(); ++rit)
+    {
+        ranked.push_back(rit->planner);
+    }
+    return ranked;
+}
+
+PortfolioSchedule PortfolioScheduler::scheduleSequential(const std::string& domain, const std::set<PlannerName>& planners, double totalTimeout) const
+{
+    std::vector<PlannerName> ranked = rank(domain, planners);
+    std::vector<double> weights;
+    for(size_t i = 0; i < ranked.size(); ++i)
+    {
+        weights.push_back(getRecord(domain, ranked[i]).getSuccessRate());
+    }
+
+    // Drop the lowest ranked planners until every slice is large enough to be useful
+    while(ranked.size() > 1)
+    {
+        double sum = 0;
+        for(size_t i = 0; i < weights.size(); ++i)
+        {
+            sum += weights[i];
+        }
+        if(totalTimeout * *std::min_element(weights.begin(), weights.end()) / sum >= mMinimumSlice)
+        {
+            break;
+        }
+        ranked.pop_back();
+        weights.pop_back();
+    }
+
+    double sum = 0;
+    for(size_t i = 0; i < weights.size(); ++i)
+    {
+        sum += weights[i];
+    }
+
+    PortfolioSchedule schedule;
+    for(size_t i = 0; i < ranked.size(); ++i)
+    {
+        schedule.push_back(PlannerSlice(ranked[i], totalTimeout * weights[i] / sum));
+    }
+    return schedule;
+}
+
+PortfolioSchedule PortfolioScheduler::scheduleParallel(const std::string& domain, const std::set<PlannerName>& planners, size_t size, double timeout) const
+{
+    std::vector<PlannerName> ranked = rank(domain, planners);
+    PortfolioSchedule schedule;
+    for(size_t i = 0; i < ranked.size() && i < size; ++i)
+    {
+        schedule.push_back(PlannerSlice(ranked[i], timeout));
+    }
+    return schedule;
+}
+
+void PortfolioScheduler::clear()
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mRecords.clear();
+}
+
+void PortfolioScheduler::save(const std::string& filename) const
+{
+    std::ofstream out(filename.c_str());
+    if(!out.is_open())
+    {
+        throw PlanGenerationException("PortfolioScheduler: could not write '" + filename + "'");
+    }
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    // One record per line: domain planner runs successes solveTime
+    std::map<std::string, PlannerRecords>::const_iterator it = mRecords.begin();
+    for(; it != mRecords.end(); ++it)
+    {
+        PlannerRecords::const_iterator rit = it->second.begin();
+        for(; rit != it->second.end(); ++rit)
+        {
+            out << it->first << " " << rit->first << " " << rit->second.runs << " " << rit->second.successes << " " << rit->second.solveTime << "\n";
+        }
+    }
+}
+
+void PortfolioScheduler::load(const std::string& filename)
+{
+    std::ifstream in(filename.c_str());
+    if(!in.is_open())
+    {
+        throw PlanGenerationException("PortfolioScheduler: could not read '" + filename + "'");
+    }
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    std::string line;
+    while(std::getline(in, line))
+    {
+        std::istringstream ss(line);
+        std::string domain;
+        PlannerName planner;
+        PlannerRecord loaded;
+        if(!(ss >> domain >> planner >> loaded.runs >> loaded.successes >> loaded.solveTime))
+        {
+            LOG_WARN("PortfolioScheduler: ignoring invalid record '%s' in '%s'", line.c_str(), filename.c_str());
+            continue;
+        }
+
+        PlannerRecord& record = mRecords[domain][planner];
+        record.runs += loaded.runs;
+        record.successes += loaded.successes;
+        record.solveTime += loaded.solveTime;
+    }
+}
+
+} // end namespace pddl_planner
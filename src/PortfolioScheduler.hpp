@@ -0,0 +1,152 @@
+#ifndef PDDL_PLANNER_PORTFOLIO_SCHEDULER_HPP
+#define PDDL_PLANNER_PORTFOLIO_SCHEDULER_HPP
+
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <boost/thread/mutex.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+namespace pddl_planner
+{
+    /**
+     * Time slice of a planner in a portfolio schedule
+     */
+    struct PlannerSlice
+    {
+        PlannerSlice(const PlannerName& planner = "", double timeout = 0.0)
+            : planner(planner)
+            , timeout(timeout)
+        {}
+
+        PlannerName planner;
+        // Timeout in seconds
+        double timeout;
+    };
+
+    // Planners in order of execution
+    typedef std::vector<PlannerSlice> PortfolioSchedule;
+
+    /**
+     * Historical performance of a planner on a domain
+     */
+    struct PlannerRecord
+    {
+        PlannerRecord()
+            : runs(0)
+            , successes(0)
+            , solveTime(0.0)
+        {}
+
+        uint64_t runs;
+        uint64_t successes;
+        // Accumulated time in seconds until the first plan of the successful runs
+        double solveTime;
+
+        /**
+         * Estimate the probability to solve a problem of the domain, which is 0.5 for
+         * planners without record
+         * \return success rate with Laplace smoothing
+         */
+        double getSuccessRate() const { return (successes + 1.0) / (runs + 2.0); }
+
+        /**
+         * Get the mean time to the first plan of the successful runs
+         * \return mean time to solution in seconds, or -1 if there is no successful run
+         */
+        double getMeanSolveTime() const { return successes ? solveTime / successes : -1.0; }
+    };
+
+    /**
+     * \class PortfolioScheduler
+     * \brief Scheduler which orders the planners of a portfolio by their history on a domain
+     * \details The success rate and the time to solution of each planner is recorded per
+     * domain. Planners are ranked by their success rate, ties are broken by the mean time
+     * to solution. A sequential schedule assigns time slices proportional to the success
+     * rates within a total timeout, a parallel schedule selects the top-k planners.
+     * Planners without record are ranked by the prior success rate of 0.5, so that they
+     * are tried until their record tells otherwise
+     */
+    class PortfolioScheduler
+    {
+    public:
+        /**
+         * Constructor
+         * \param minimumSlice Minimum time slice in seconds, planners which would receive
+         * less are dropped from a sequential schedule
+         */
+        PortfolioScheduler(double minimumSlice = 0.5);
+
+        /**
+         * Create the key identifying a domain
+         * \return domain key
+         */
+        static std::string createKey(const std::string& domainDescriptions, const std::string& actionDescriptions);
+
+        /**
+         * Record the outcome of a planner call -- cancelled calls and results taken from
+         * the plan cache do not tell anything about the planner, so they are ignored
+         * \param domain Domain key
+         */
+        void record(const std::string& domain, const PlannerName& planner, const PlannerStatistics& statistics);
+
+        /**
+         * Get the record of a planner
+         * \param domain Domain key
+         * \return record, which is empty if the planner has never run on this domain
+         */
+        PlannerRecord getRecord(const std::string& domain, const PlannerName& planner) const;
+
+        /**
+         * Rank the given planners for a domain
+         * \param domain Domain key
+         * \return planners, the most promising first
+         */
+        std::vector<PlannerName> rank(const std::string& domain, const std::set<PlannerName>& planners) const;
+
+        /**
+         * Create a sequential schedule, i.e. distribute the total timeout among the ranked
+         * planners proportionally to their success rate
+         * \param domain Domain key
+         * \param totalTimeout Timeout in seconds for the complete schedule
+         * \return schedule, where the slice timeouts sum up to the total timeout
+         */
+        PortfolioSchedule scheduleSequential(const std::string& domain, const std::set<PlannerName>& planners, double totalTimeout) const;
+
+        /**
+         * Create a parallel schedule, i.e. select the top ranked planners
+         * \param domain Domain key
+         * \param size Number of planners to select
+         * \param timeout Timeout in seconds of each planner
+         * \return schedule
+         */
+        PortfolioSchedule scheduleParallel(const std::string& domain, const std::set<PlannerName>& planners, size_t size, double timeout) const;
+
+        /**
+         * Remove all records
+         */
+        void clear();
+
+        /**
+         * Save all records to a file
+         * \throws PlanGenerationException if the file cannot be written
+         */
+        void save(const std::string& filename) const;
+
+        /**
+         * Load records from a file, which are added to the existing records
+         * \throws PlanGenerationException if the file cannot be read
+         */
+        void load(const std::string& filename);
+
+    private:
+        typedef std::map<PlannerName, PlannerRecord> PlannerRecords;
+
+        mutable boost::mutex mMutex;
+        double mMinimumSlice;
+        std::map<std::string, PlannerRecords> mRecords;
+    };
+}
+#endif // PDDL_PLANNER_PORTFOLIO_SCHEDULER_HPP
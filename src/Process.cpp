@@ -0,0 +1,247 @@
+#include <pddl_planner/Process.hpp>
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <pddl_planner/ProcessPool.hpp>
+#include <base/logging.h>
+#include <boost/chrono/chrono.hpp>
+#include <boost/thread.hpp>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+
+namespace pddl_planner
+{
+
+Process::Process(const std::vector<std::string>& arguments, const std::string& workingDirectory, const ResourceLimits& limits)
+    : mArguments(arguments)
+    , mWorkingDirectory(workingDirectory)
+    , mLimits(limits)
+    , mPid(-1)
+    , mPidFd(-1)
+    , mExitStatus(-1)
+{
+    memset(&mResourceUsage, 0, sizeof(mResourceUsage));
+    if(mArguments.empty())
+    {
+        throw PlanGenerationException("Process: no executable given");
+    }
+}
+
+Process::~Process()
+{
+    if(isRunning())
+    {
+        kill();
+    }
+}
+
+std::string Process::toString() const
+{
+    std::string cmd;
+    std::vector<std::string>::const_iterator it = mArguments.begin();
+    for(; it != mArguments.end(); ++it)
+    {
+        cmd += (cmd.empty() ? "" : " ") + *it;
+    }
+    return cmd;
+}
+
+void Process::start()
+{
+    if(isRunning())
+    {
+        throw PlanGenerationException("Process: '" + toString() + "' is already running");
+    }
+
+    // A pre-forked worker saves forking this process on the request path
+    int errorFd = -1;
+    pid_t pid = ProcessPool::getDefault().launch(mArguments, mWorkingDirectory, mLimits, errorFd);
+    if(-1 == pid)
+    {
+        pid = forkAndExec(errorFd);
+    }
+
+    mPid = pid;
+    mExitStatus = -1;
+    memset(&mResourceUsage, 0, sizeof(mResourceUsage));
+
+    int error[2] = { 0, 0 };
+    ssize_t bytes;
+    do {
+        bytes = read(errorFd, error, sizeof(error));
+    } while(-1 == bytes && EINTR == errno);
+    close(errorFd);
+
+    if(bytes > 0)
+    {
+        reap();
+        if(CHILD_CHDIR == error[0])
+        {
+            throw PlanGenerationException("Process: failed to change working directory to '" + mWorkingDirectory + "' for '" + toString() + "': " + std::string(strerror(error[1])));
+        }
+        if(CHILD_LIMITS == error[0])
+        {
+            throw PlanGenerationException("Process: failed to apply resource limits for '" + toString() + "': " + std::string(strerror(error[1])));
+        }
+        throw PlanGenerationException("Process: failed to execute '" + toString() + "': " + std::string(strerror(error[1])));
+    }
+
+#ifdef SYS_pidfd_open
+    mPidFd = syscall(SYS_pidfd_open, mPid, 0);
+#endif
+    LOG_DEBUG("Process: started '%s' with pid %d", toString().c_str(), mPid);
+}
+
+pid_t Process::forkAndExec(int& errorFd)
+{
+    // Prepare everything that requires memory allocation before forking
+    std::vector<char*> argv;
+    std::vector<std::string>::iterator it = mArguments.begin();
+    for(; it != mArguments.end(); ++it)
+    {
+        argv.push_back(const_cast<char*>(it->c_str()));
+    }
+    argv.push_back(NULL);
+
+    const char* workingDirectory = mWorkingDirectory.empty() ? NULL : mWorkingDirectory.c_str();
+    ChildLimits limits = ChildLimits::create(mLimits);
+
+    // Pipe to report a failing chdir, limit or exec to the parent, it will be closed on a successful exec
+    int errorPipe[2];
+    if(-1 == pipe2(errorPipe, O_CLOEXEC))
+    {
+        throw PlanGenerationException("Process: failed to create pipe: " + std::string(strerror(errno)));
+    }
+
+    pid_t pid = fork();
+    if(-1 == pid)
+    {
+        close(errorPipe[0]);
+        close(errorPipe[1]);
+        throw PlanGenerationException("Process: failed to fork for '" + toString() + "': " + std::string(strerror(errno)));
+    }
+
+    if(0 == pid)
+    {
+        // Child: only async-signal-safe calls from here on
+        close(errorPipe[0]);
+        setpgid(0, 0);
+
+        int devNull = open("/dev/null", O_WRONLY);
+        if(-1 != devNull)
+        {
+            dup2(devNull, STDOUT_FILENO);
+            close(devNull);
+        }
+
+        int error[2] = { CHILD_EXEC, 0 };
+        if(workingDirectory && -1 == chdir(workingDirectory))
+        {
+            error[0] = CHILD_CHDIR;
+        } else if(!limits.apply())
+        {
+            error[0] = CHILD_LIMITS;
+        } else {
+            execvp(argv[0], &argv[0]);
+        }
+
+        error[1] = errno;
+        ssize_t written = write(errorPipe[1], error, sizeof(error));
+        (void) written;
+        _exit(127);
+    }
+
+    // Set process group in the parent as well to avoid a race with kill()
+    setpgid(pid, pid);
+    close(errorPipe[1]);
+    errorFd = errorPipe[0];
+    return pid;
+}
+
+bool Process::hasTerminated() const
+{
+    siginfo_t info;
+    info.si_pid = 0;
+    int result;
+    do {
+        result = waitid(P_PID, mPid, &info, WEXITED | WNOHANG | WNOWAIT);
+    } while(-1 == result && EINTR == errno);
+
+    return -1 == result || info.si_pid == mPid;
+}
+
+bool Process::waitFor(double timeout)
+{
+    if(!isRunning())
+    {
+        return true;
+    }
+
+    boost::chrono::steady_clock::time_point deadline = boost::chrono::steady_clock::now() + boost::chrono::microseconds((int64_t)(1000000. * timeout));
+    while(!hasTerminated())
+    {
+        boost::chrono::steady_clock::time_point now = boost::chrono::steady_clock::now();
+        if(now >= deadline)
+        {
+            return false;
+        }
+
+        int remaining = boost::chrono::duration_cast<boost::chrono::milliseconds>(deadline - now).count() + 1;
+        if(mPidFd >= 0)
+        {
+            // The pidfd becomes readable once the process terminated
+            struct pollfd pfd;
+            pfd.fd = mPidFd;
+            pfd.events = POLLIN;
+            poll(&pfd, 1, remaining);
+        } else {
+            boost::this_thread::sleep_for(boost::chrono::milliseconds(std::min(remaining, 5)));
+        }
+    }
+
+    reap();
+    return true;
+}
+
+void Process::kill()
+{
+    if(!isRunning())
+    {
+        return;
+    }
+
+    if(-1 == ::kill(-mPid, SIGKILL) && ESRCH != errno)
+    {
+        LOG_WARN("Process: failed to kill process group %d: %s", mPid, strerror(errno));
+    }
+    reap();
+}
+
+void Process::reap()
+{
+    // As long as the process has not been reaped, its pid (and thus the process group id)
+    // cannot be reused -- so this kills only the remaining members of our own process tree
+    ::kill(-mPid, SIGKILL);
+
+    int status = 0;
+    pid_t result;
+    do {
+        result = wait4(mPid, &status, 0, &mResourceUsage);
+    } while(-1 == result && EINTR == errno);
+
+    mExitStatus = (result == mPid) ? status : -1;
+    mPid = -1;
+
+    if(mPidFd >= 0)
+    {
+        close(mPidFd);
+        mPidFd = -1;
+    }
+}
+
+} // end namespace pddl_planner
@@ -0,0 +1,137 @@
+#ifndef PDDL_PLANNER_PROCESS_HPP
+#define PDDL_PLANNER_PROCESS_HPP
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <sys/resource.h>
+
+namespace pddl_planner
+{
+    /**
+     * Limits, which are applied to a process before it is executed -- they are inherited
+     * by all processes the process starts
+     */
+    struct ResourceLimits
+    {
+        ResourceLimits()
+            : memory(0)
+            , cpuTime(0.0)
+        {}
+
+        /**
+         * Check if no limit is set
+         * \return true if the process runs without limits, false otherwise
+         */
+        bool empty() const { return memory == 0 && cpuTime <= 0 && cpus.empty(); }
+
+        // Maximum size of the address space in bytes (RLIMIT_AS), 0 for no limit
+        size_t memory;
+        // Maximum CPU time in seconds (RLIMIT_CPU), which is rounded up to full seconds
+        // and applies to each process of the tree individually, 0 for no limit
+        double cpuTime;
+        // Cores the process may run on, empty for all cores
+        std::vector<int> cpus;
+    };
+
+    /**
+     * \class Process
+     * \brief Supervisor for an external planner process
+     * \details The process is started via fork/exec in a process group of its own, so that
+     * the complete process tree of a planner -- and only this process tree -- can be killed
+     * without affecting other planner instances running on the same host
+     */
+    class Process
+    {
+    public:
+        /**
+         * Constructor
+         * \param arguments Command line of the process, where the first argument is the
+         * executable which will be searched for in PATH if it is not an absolute path
+         * \param workingDirectory Working directory of the process, which is set in the child
+         * only -- the working directory of the calling process remains untouched
+         * \param limits Resource limits of the process, which are set in the child as well
+         */
+        Process(const std::vector<std::string>& arguments, const std::string& workingDirectory = "", const ResourceLimits& limits = ResourceLimits());
+
+        /**
+         * Deconstructor kills the process tree if it is still running
+         */
+        ~Process();
+
+        /**
+         * Start the process, the standard output of the process is discarded
+         * \throws PlanGenerationException if the process could not be started
+         */
+        void start();
+
+        /**
+         * Wait for the process to terminate
+         * \param timeout Maximum time to wait in seconds
+         * \return true if the process terminated, false if the timeout expired
+         */
+        bool waitFor(double timeout);
+
+        /**
+         * Kill the process and all processes in its process group and
+         * wait for the process to terminate
+         */
+        void kill();
+
+        /**
+         * Check if process has been started and has not yet been waited for
+         * \return true if process is running, false otherwise
+         */
+        bool isRunning() const { return mPid > 0; }
+
+        /**
+         * Get exit status of the process as provided by waitpid
+         * \return exit status, -1 if the process has not terminated yet
+         */
+        int getExitStatus() const { return mExitStatus; }
+
+        /**
+         * Get resource usage of the terminated process as provided by wait4, i.e. including
+         * the descendants the process has waited for
+         * \return resource usage, which is zero if the process has not terminated yet
+         */
+        const struct rusage& getResourceUsage() const { return mResourceUsage; }
+
+        /**
+         * Get the command line of this process as string, e.g. for logging
+         * \return command line
+         */
+        std::string toString() const;
+
+    private:
+        Process(const Process& other);
+        Process& operator=(const Process& other);
+
+        /**
+         * Fork and execute the process in the child
+         * \param errorFd Receives the read end of the pipe which reports a failing chdir, limit or exec
+         * \return pid of the child
+         * \throws PlanGenerationException if forking fails
+         */
+        pid_t forkAndExec(int& errorFd);
+
+        /**
+         * Test (without reaping the process) whether the process has terminated
+         */
+        bool hasTerminated() const;
+
+        /**
+         * Kill remaining processes of the process group and reap the process
+         */
+        void reap();
+
+        std::vector<std::string> mArguments;
+        std::string mWorkingDirectory;
+        ResourceLimits mLimits;
+        pid_t mPid;
+        int mPidFd;
+        int mExitStatus;
+        struct rusage mResourceUsage;
+    };
+}
+#endif // PDDL_PLANNER_PROCESS_HPP
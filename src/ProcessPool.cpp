@@ -0,0 +1,398 @@
+#include <pddl_planner/ProcessPool.hpp>
+#include <base/logging.h>
+#include <boost/bind.hpp>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+
+namespace pddl_planner
+{
+
+namespace
+{
+    // Limits of a request, larger requests are executed without the pool
+    const size_t MAX_REQUEST_SIZE = 64 * 1024;
+    const size_t MAX_ARGUMENTS = 1024;
+    // Upper bound of file descriptors to close, if close_range is not available
+    const long MAX_CLOSED_FD = 64 * 1024;
+
+    /**
+     * Close all file descriptors in [first, last] -- async-signal-safe
+     */
+    void closeRange(int first, int last)
+    {
+        if(first > last)
+        {
+            return;
+        }
+#ifdef SYS_close_range
+        if(0 == syscall(SYS_close_range, first, last, 0))
+        {
+            return;
+        }
+#endif
+        for(int fd = first; fd <= last; ++fd)
+        {
+            close(fd);
+        }
+    }
+
+    /**
+     * Read exactly the given number of bytes -- async-signal-safe
+     * \return true on success, false on end of file or error
+     */
+    bool readAll(int fd, char* buffer, size_t size)
+    {
+        while(size > 0)
+        {
+            ssize_t bytes = read(fd, buffer, size);
+            if(bytes > 0)
+            {
+                buffer += bytes;
+                size -= bytes;
+            } else if(bytes == 0 || errno != EINTR)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Body of a worker: wait for the request and execute it
+     * Only async-signal-safe calls are allowed, since the parent is multi-threaded
+     */
+    void runWorker(int requestFd, int errorFd, long maxFd, char* buffer, char** argv)
+    {
+        setpgid(0, 0);
+
+        int devNull = open("/dev/null", O_WRONLY);
+        if(-1 != devNull)
+        {
+            dup2(devNull, STDOUT_FILENO);
+            close(devNull);
+        }
+
+        // Do not keep file descriptors of the parent open, e.g. the error pipes of
+        // other processes, whose readers would otherwise wait until this worker exits
+        int low = std::min(requestFd, errorFd);
+        int high = std::max(requestFd, errorFd);
+        closeRange(STDERR_FILENO + 1, low - 1);
+        closeRange(low + 1, high - 1);
+        closeRange(high + 1, maxFd);
+
+        uint32_t size = 0;
+        if(!readAll(requestFd, reinterpret_cast<char*>(&size), sizeof(size)) || size == 0 || size > MAX_REQUEST_SIZE
+                || !readAll(requestFd, buffer, size))
+        {
+            // The pool has been shut down
+            _exit(0);
+        }
+
+        // Request consists of the limits followed by null-terminated strings: working
+        // directory followed by the arguments
+        if(size <= sizeof(ChildLimits))
+        {
+            _exit(0);
+        }
+        ChildLimits limits;
+        memcpy(&limits, buffer, sizeof(limits));
+        buffer += sizeof(limits);
+        size -= sizeof(limits);
+
+        const char* workingDirectory = buffer;
+        size_t argc = 0;
+        for(size_t i = strlen(buffer) + 1; i < size && argc < MAX_ARGUMENTS; i += strlen(buffer + i) + 1)
+        {
+            argv[argc++] = buffer + i;
+        }
+        argv[argc] = NULL;
+
+        int error[2] = { CHILD_EXEC, 0 };
+        if(workingDirectory[0] && -1 == chdir(workingDirectory))
+        {
+            error[0] = CHILD_CHDIR;
+        } else if(!limits.apply())
+        {
+            error[0] = CHILD_LIMITS;
+        } else if(argc > 0)
+        {
+            execvp(argv[0], argv);
+        }
+
+        error[1] = errno;
+        ssize_t written = write(errorFd, error, sizeof(error));
+        (void) written;
+        _exit(127);
+    }
+}
+
+ChildLimits ChildLimits::create(const ResourceLimits& limits)
+{
+    ChildLimits childLimits;
+    childLimits.memory = limits.memory;
+    childLimits.cpuTime = limits.cpuTime > 0 ? (uint64_t) ceil(limits.cpuTime) : 0;
+    childLimits.hasAffinity = !limits.cpus.empty();
+    CPU_ZERO(&childLimits.cpus);
+    std::vector<int>::const_iterator it = limits.cpus.begin();
+    for(; it != limits.cpus.end(); ++it)
+    {
+        if(*it >= 0 && *it < CPU_SETSIZE)
+        {
+            CPU_SET(*it, &childLimits.cpus);
+        }
+    }
+    return childLimits;
+}
+
+bool ChildLimits::apply() const
+{
+    if(memory > 0)
+    {
+        struct rlimit limit;
+        limit.rlim_cur = memory;
+        limit.rlim_max = memory;
+        if(-1 == setrlimit(RLIMIT_AS, &limit))
+        {
+            return false;
+        }
+    }
+
+    if(cpuTime > 0)
+    {
+        // The soft limit sends SIGXCPU, the hard limit a second later SIGKILL
+        struct rlimit limit;
+        limit.rlim_cur = cpuTime;
+        limit.rlim_max = cpuTime + 1;
+        if(-1 == setrlimit(RLIMIT_CPU, &limit))
+        {
+            return false;
+        }
+    }
+
+    return !hasAffinity || 0 == sched_setaffinity(0, sizeof(cpus), &cpus);
+}
+
+ProcessPool::ProcessPool(size_t size)
+    : mSize(0)
+    , mShutdown(false)
+    , mRequestBuffer(MAX_REQUEST_SIZE + 1)
+    , mArgv(MAX_ARGUMENTS + 1)
+{
+    setSize(size);
+}
+
+ProcessPool::~ProcessPool()
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        mShutdown = true;
+        mCondition.notify_all();
+    }
+    if(mForkThread.joinable())
+    {
+        mForkThread.join();
+    }
+
+    std::vector<Worker>::const_iterator it = mWorkers.begin();
+    for(; it != mWorkers.end(); ++it)
+    {
+        terminate(*it);
+    }
+}
+
+ProcessPool& ProcessPool::getDefault()
+{
+    static ProcessPool processPool;
+    return processPool;
+}
+
+void ProcessPool::setSize(size_t size)
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mSize = size;
+    if(mSize > 0 && !mForkThread.joinable())
+    {
+        mForkThread = boost::thread(boost::bind(&ProcessPool::forkLoop, this));
+    }
+    mCondition.notify_all();
+}
+
+size_t ProcessPool::getSize() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mSize;
+}
+
+size_t ProcessPool::getIdleWorkers() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mWorkers.size();
+}
+
+pid_t ProcessPool::launch(const std::vector<std::string>& arguments, const std::string& workingDirectory, const ResourceLimits& limits, int& errorFd)
+{
+    ChildLimits childLimits = ChildLimits::create(limits);
+    std::string request(reinterpret_cast<const char*>(&childLimits), sizeof(childLimits));
+    request += workingDirectory + '\0';
+    std::vector<std::string>::const_iterator it = arguments.begin();
+    for(; it != arguments.end(); ++it)
+    {
+        request += *it + '\0';
+    }
+    if(arguments.empty() || arguments.size() > MAX_ARGUMENTS || request.size() > MAX_REQUEST_SIZE)
+    {
+        return -1;
+    }
+
+    uint32_t size = request.size();
+    request.insert(0, reinterpret_cast<const char*>(&size), sizeof(size));
+
+    while(true)
+    {
+        Worker worker;
+        {
+            boost::unique_lock<boost::mutex> lock(mMutex);
+            if(mWorkers.empty())
+            {
+                return -1;
+            }
+            worker = mWorkers.back();
+            mWorkers.pop_back();
+            mCondition.notify_all();
+        }
+
+        // Sending to a socket allows to suppress SIGPIPE if the worker died meanwhile
+        const char* data = request.data();
+        size_t remaining = request.size();
+        while(remaining > 0)
+        {
+            ssize_t bytes = send(worker.requestFd, data, remaining, MSG_NOSIGNAL);
+            if(bytes > 0)
+            {
+                data += bytes;
+                remaining -= bytes;
+            } else if(errno != EINTR)
+            {
+                break;
+            }
+        }
+
+        if(remaining == 0)
+        {
+            close(worker.requestFd);
+            errorFd = worker.errorFd;
+            return worker.pid;
+        }
+
+        LOG_WARN("ProcessPool: worker %d is not responding: %s", worker.pid, strerror(errno));
+        terminate(worker);
+    }
+}
+
+void ProcessPool::forkLoop()
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    while(!mShutdown)
+    {
+        while(mWorkers.size() > mSize)
+        {
+            terminate(mWorkers.back());
+            mWorkers.pop_back();
+        }
+
+        if(mWorkers.size() < mSize)
+        {
+            Worker worker;
+            lock.unlock();
+            bool forked = forkWorker(worker);
+            lock.lock();
+
+            if(forked)
+            {
+                mWorkers.push_back(worker);
+            } else {
+                // Retry later, e.g. when the process limit has been reached
+                mCondition.wait_for(lock, boost::chrono::seconds(1));
+            }
+            continue;
+        }
+
+        mCondition.wait(lock);
+    }
+}
+
+bool ProcessPool::forkWorker(Worker& worker)
+{
+    // Prepare everything before forking, the request buffers belong to this
+    // thread and are only used by the child
+    long maxFd = std::min(sysconf(_SC_OPEN_MAX), MAX_CLOSED_FD);
+    char* buffer = &mRequestBuffer[0];
+    char** argv = &mArgv[0];
+
+    int requestSockets[2];
+    if(-1 == socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, requestSockets))
+    {
+        LOG_WARN("ProcessPool: failed to create socket: %s", strerror(errno));
+        return false;
+    }
+
+    int errorPipe[2];
+    if(-1 == pipe2(errorPipe, O_CLOEXEC))
+    {
+        LOG_WARN("ProcessPool: failed to create pipe: %s", strerror(errno));
+        close(requestSockets[0]);
+        close(requestSockets[1]);
+        return false;
+    }
+
+    pid_t pid = fork();
+    if(-1 == pid)
+    {
+        LOG_WARN("ProcessPool: failed to fork: %s", strerror(errno));
+        close(requestSockets[0]);
+        close(requestSockets[1]);
+        close(errorPipe[0]);
+        close(errorPipe[1]);
+        return false;
+    }
+
+    if(0 == pid)
+    {
+        runWorker(requestSockets[1], errorPipe[1], maxFd, buffer, argv);
+    }
+
+    // Set process group in the parent as well to avoid a race with kill()
+    setpgid(pid, pid);
+    close(requestSockets[1]);
+    close(errorPipe[1]);
+
+    worker.pid = pid;
+    worker.requestFd = requestSockets[0];
+    worker.errorFd = errorPipe[0];
+    LOG_DEBUG("ProcessPool: forked worker %d", pid);
+    return true;
+}
+
+void ProcessPool::terminate(const Worker& worker)
+{
+    close(worker.requestFd);
+    close(worker.errorFd);
+    ::kill(worker.pid, SIGKILL);
+
+    pid_t result;
+    do {
+        result = waitpid(worker.pid, NULL, 0);
+    } while(-1 == result && EINTR == errno);
+}
+
+} // end namespace pddl_planner
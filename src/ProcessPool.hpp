@@ -0,0 +1,148 @@
+#ifndef PDDL_PLANNER_PROCESS_POOL_HPP
+#define PDDL_PLANNER_PROCESS_POOL_HPP
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <sched.h>
+#include <stdint.h>
+#include <pddl_planner/Process.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace pddl_planner
+{
+    // Stage at which a child failed before executing the process -- the child reports
+    // it together with errno via the error pipe
+    enum ChildError { CHILD_CHDIR = 1, CHILD_LIMITS, CHILD_EXEC };
+
+    /**
+     * Resource limits in a form, which a child can apply without allocating memory
+     */
+    struct ChildLimits
+    {
+        /**
+         * Convert resource limits -- cores beyond CPU_SETSIZE are ignored
+         */
+        static ChildLimits create(const ResourceLimits& limits);
+
+        /**
+         * Apply the limits to the calling process -- async-signal-safe
+         * \return true on success, false otherwise with errno being set
+         */
+        bool apply() const;
+
+        uint64_t memory;
+        uint64_t cpuTime;
+        int32_t hasAffinity;
+        cpu_set_t cpus;
+    };
+
+    /**
+     * \class ProcessPool
+     * \brief Pool of pre-forked worker processes, which are ready to execute a planner
+     * \details Forking a large, multi-threaded process is expensive, so workers are forked
+     * ahead of time by a background thread and wait for a request on a Unix socket. A
+     * request carries the command line, the working directory and the resource limits, the
+     * worker then changes its directory, applies the limits and executes the planner, i.e. it becomes the planner process.
+     * Workers are forked with the environment of the time of forking and close all
+     * inherited file descriptors except the standard streams.
+     * The pool is disabled, i.e. has no workers, unless a size is set
+     */
+    class ProcessPool
+    {
+    public:
+        /**
+         * Constructor
+         * \param size Number of idle workers to keep, 0 disables the pool
+         */
+        ProcessPool(size_t size = 0);
+
+        /**
+         * Deconstructor kills all idle workers
+         */
+        ~ProcessPool();
+
+        /**
+         * Get the process-wide pool which is used by Process
+         * \return process pool
+         */
+        static ProcessPool& getDefault();
+
+        /**
+         * Set the number of idle workers to keep -- additional workers are forked in the
+         * background, surplus workers are killed
+         * \param size Number of idle workers, 0 disables the pool
+         */
+        void setSize(size_t size);
+
+        /**
+         * Get the number of idle workers to keep
+         * \return size of the pool
+         */
+        size_t getSize() const;
+
+        /**
+         * Get the number of workers which are currently waiting for a request
+         * \return number of idle workers
+         */
+        size_t getIdleWorkers() const;
+
+        /**
+         * Let an idle worker execute a process
+         * \param arguments Command line, where the first argument is the executable
+         * \param workingDirectory Working directory of the process, empty for the working
+         * directory of the calling process
+         * \param limits Resource limits of the process
+         * \param errorFd Receives the read end of the worker's error pipe, which reports a
+         * ChildError and errno if the execution fails and is closed on success -- the
+         * caller is responsible for closing it
+         * \return pid of the process, which is the leader of its own process group, or -1 if
+         * no worker is available
+         */
+        pid_t launch(const std::vector<std::string>& arguments, const std::string& workingDirectory, const ResourceLimits& limits, int& errorFd);
+
+    private:
+        ProcessPool(const ProcessPool& other);
+        ProcessPool& operator=(const ProcessPool& other);
+
+        struct Worker
+        {
+            pid_t pid;
+            // Socket to send the request to the worker
+            int requestFd;
+            // Read end of the pipe which reports execution failures
+            int errorFd;
+        };
+
+        /**
+         * Loop of the thread which forks the workers
+         */
+        void forkLoop();
+
+        /**
+         * Fork a single worker
+         * \return true on success, false otherwise
+         */
+        bool forkWorker(Worker& worker);
+
+        /**
+         * Kill a worker and release its resources
+         */
+        static void terminate(const Worker& worker);
+
+        mutable boost::mutex mMutex;
+        boost::condition_variable mCondition;
+        boost::thread mForkThread;
+        size_t mSize;
+        bool mShutdown;
+        std::vector<Worker> mWorkers;
+
+        // Memory for parsing the request in a worker, it is allocated before forking,
+        // since a child of a multi-threaded process must not allocate memory
+        std::vector<char> mRequestBuffer;
+        std::vector<char*> mArgv;
+    };
+}
+#endif // PDDL_PLANNER_PROCESS_POOL_HPP
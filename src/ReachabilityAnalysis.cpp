@@ -0,0 +1,252 @@
+#include <pddl_planner/ReachabilityAnalysis.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/foreach.hpp>
+
+namespace pddl_planner
+{
+
+namespace
+{
+    using representation::Expression;
+    using representation::ExpressionPtr;
+
+    /**
+     * Check if a label denotes a logical connective, quantifier, comparison or numeric
+     * effect rather than a predicate
+     */
+    bool isOperator(const std::string& label)
+    {
+        static const char* operators[] = { "and", "or", "not", "imply", "forall", "exists", "when",
+            "=", "<", ">", "<=", ">=", "increase", "decrease", "assign", "scale-up", "scale-down" };
+        for(size_t i = 0; i < sizeof(operators) / sizeof(operators[0]); ++i)
+        {
+            if(label == operators[i])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Get the key of an atom if all its arguments are objects
+     * \return true if the atom is ground
+     */
+    bool getGroundAtom(const Expression& atom, std::string& key)
+    {
+        key = boost::to_lower_copy(atom.label);
+        BOOST_FOREACH(const ExpressionPtr& parameter, atom.parameters)
+        {
+            if(!parameter->isAtomic() || representation::VariableManager::isVariable(parameter->label))
+            {
+                return false;
+            }
+            key += " " + boost::to_lower_copy(parameter->label);
+        }
+        return true;
+    }
+
+    /**
+     * Collect the predicates which a condition necessarily requires, i.e. the positive
+     * atoms of its conjunctions
+     */
+    void collectRequired(const Expression& condition, std::vector<std::string>& required)
+    {
+        if(condition.label == "and")
+        {
+            BOOST_FOREACH(const ExpressionPtr& e, condition.parameters)
+            {
+                collectRequired(*e, required);
+            }
+        } else if(!isOperator(condition.label))
+        {
+            required.push_back(boost::to_lower_copy(condition.label));
+        }
+    }
+
+    /**
+     * Get the body of a quantified expression
+     */
+    const Expression* getQuantifiedBody(const Expression& e)
+    {
+        return e.parameters.empty() ? NULL : e.parameters.back().get();
+    }
+}
+
+ReachabilityAnalysis::ReachabilityAnalysis(const representation::Problem& problem)
+{
+    analyse(problem.domain, problem);
+}
+
+ReachabilityAnalysis::ReachabilityAnalysis(const representation::Domain& domain, const representation::Problem& problem)
+{
+    analyse(domain, problem);
+}
+
+std::set<std::string> ReachabilityAnalysis::getReachablePredicates() const
+{
+    return std::set<std::string>(mReachable.begin(), mReachable.end());
+}
+
+void ReachabilityAnalysis::analyse(const representation::Domain& domain, const representation::Problem& problem)
+{
+    if(problem.goal.isNull())
+    {
+        mReason = "problem '" + problem.name + "' has no goal";
+        return;
+    }
+
+    boost::unordered_set<std::string> status;
+    BOOST_FOREACH(const Expression& e, problem.status)
+    {
+        std::string key;
+        if(!isOperator(e.label) && getGroundAtom(e, key))
+        {
+            status.insert(key);
+            mReachable.insert(boost::to_lower_copy(e.label));
+        }
+    }
+
+    boost::unordered_set<std::string> objects;
+    BOOST_FOREACH(const representation::Constant& constant, domain.constants)
+    {
+        objects.insert(boost::to_lower_copy(constant.label));
+    }
+    BOOST_FOREACH(const representation::Constant& object, problem.objects)
+    {
+        objects.insert(boost::to_lower_copy(object.label));
+    }
+
+    std::vector<Rule> rules;
+    BOOST_FOREACH(const representation::Action& action, domain.actions)
+    {
+        Rule rule;
+        BOOST_FOREACH(const Expression& precondition, action.preconditions)
+        {
+            collectRequired(precondition, rule.required);
+        }
+        BOOST_FOREACH(const Expression& effect, action.effects)
+        {
+            collectEffects(effect, rule, rules);
+        }
+    }
+
+    // Apply the rules until no further predicate becomes reachable
+    bool changed = true;
+    while(changed)
+    {
+        changed = false;
+        std::vector<Rule>::iterator it = rules.begin();
+        while(it != rules.end())
+        {
+            bool applicable = true;
+            std::vector<std::string>::const_iterator rit = it->required.begin();
+            for(; applicable && rit != it->required.end(); ++rit)
+            {
+                applicable = mReachable.count(*rit);
+            }
+            if(!applicable)
+            {
+                ++it;
+                continue;
+            }
+
+            mReachable.insert(it->added.begin(), it->added.end());
+            it = rules.erase(it);
+            changed = true;
+        }
+    }
+
+    checkGoal(problem.goal, status, objects);
+}
+
+void ReachabilityAnalysis::collectEffects(const Expression& effect, const Rule& rule, std::vector<Rule>& rules)
+{
+    const std::string& label = effect.label;
+    if(label == "and")
+    {
+        BOOST_FOREACH(const ExpressionPtr& e, effect.parameters)
+        {
+            collectEffects(*e, rule, rules);
+        }
+    } else if(label == "not" && effect.parameters.size() == 1)
+    {
+        mChanged.insert(boost::to_lower_copy(effect.parameters.front()->label));
+    } else if(label == "forall")
+    {
+        const Expression* body = getQuantifiedBody(effect);
+        if(body)
+        {
+            collectEffects(*body, rule, rules);
+        }
+    } else if(label == "when" && effect.parameters.size() == 2)
+    {
+        Rule conditionalRule = rule;
+        collectRequired(*effect.parameters[0], conditionalRule.required);
+        collectEffects(*effect.parameters[1], conditionalRule, rules);
+    } else if(!isOperator(label))
+    {
+        std::string predicate = boost::to_lower_copy(label);
+        mChanged.insert(predicate);
+        Rule addRule = rule;
+        addRule.added.push_back(predicate);
+        rules.push_back(addRule);
+    }
+}
+
+void ReachabilityAnalysis::checkGoal(const Expression& goal, const boost::unordered_set<std::string>& status, const boost::unordered_set<std::string>& objects)
+{
+    if(goal.label == "and")
+    {
+        BOOST_FOREACH(const ExpressionPtr& e, goal.parameters)
+        {
+            checkGoal(*e, status, objects);
+            if(isUnsolvable())
+            {
+                return;
+            }
+        }
+        return;
+    }
+
+    bool negated = goal.label == "not" && goal.parameters.size() == 1;
+    const Expression& atom = negated ? *goal.parameters.front() : goal;
+    if(isOperator(atom.label))
+    {
+        return;
+    }
+
+    std::string key;
+    bool ground = getGroundAtom(atom, key);
+    if(ground)
+    {
+        BOOST_FOREACH(const ExpressionPtr& parameter, atom.parameters)
+        {
+            if(!objects.count(boost::to_lower_copy(parameter->label)))
+            {
+                mReason = "goal " + goal.toLISP() + " refers to the unknown object '" + parameter->label + "'";
+                return;
+            }
+        }
+    }
+
+    std::string predicate = boost::to_lower_copy(atom.label);
+    if(negated)
+    {
+        if(ground && !mChanged.count(predicate) && status.count(key))
+        {
+            mReason = "goal " + goal.toLISP() + " contradicts the initial status, which no action changes";
+        }
+        return;
+    }
+
+    if(!mReachable.count(predicate))
+    {
+        mReason = "goal " + goal.toLISP() + " is unreachable, since no reachable action adds '" + atom.label + "'";
+    } else if(ground && !mChanged.count(predicate) && !status.count(key))
+    {
+        mReason = "goal " + goal.toLISP() + " does not hold initially, and no action changes '" + atom.label + "'";
+    }
+}
+
+} // end namespace pddl_planner
@@ -0,0 +1,84 @@
+#ifndef PDDL_PLANNER_REACHABILITY_ANALYSIS_HPP
+#define PDDL_PLANNER_REACHABILITY_ANALYSIS_HPP
+
+#include <pddl_planner/representation/Problem.hpp>
+#include <boost/unordered_set.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace pddl_planner
+{
+    /**
+     * \class ReachabilityAnalysis
+     * \brief Relaxed reachability analysis of a problem, which detects problems whose goal
+     * cannot be reached at all without calling a planner
+     * \details The analysis works on predicates rather than on ground atoms and ignores
+     * delete effects as well as negative and disjunctive preconditions, i.e. a predicate
+     * is reachable if it holds initially or is added by an action whose positive
+     * preconditions are reachable. In addition, ground goal atoms of static predicates, which
+     * no action changes, have to agree with the initial status. The analysis thus
+     * over-approximates reachability -- a problem it rejects has no solution, but not all
+     * unsolvable problems are detected. Since nothing is grounded, the analysis is cheap
+     * compared to the start of a planner
+     */
+    class ReachabilityAnalysis
+    {
+    public:
+        /**
+         * Analyse a problem with the domain associated with it
+         */
+        ReachabilityAnalysis(const representation::Problem& problem);
+
+        /**
+         * Analyse a problem with a given domain, which overrides the problem's domain
+         */
+        ReachabilityAnalysis(const representation::Domain& domain, const representation::Problem& problem);
+
+        /**
+         * Check if the problem provably has no solution
+         */
+        bool isUnsolvable() const { return !mReason.empty(); }
+
+        /**
+         * Get the reason why the problem has no solution
+         * \return reason, or an empty string if the problem might be solvable
+         */
+        const std::string& getReason() const { return mReason; }
+
+        /**
+         * Get the predicates which can hold in some reachable state, in lower case
+         */
+        std::set<std::string> getReachablePredicates() const;
+
+    private:
+        /**
+         * Predicates which an action or one of its conditional effects adds if the required
+         * predicates are reachable
+         */
+        struct Rule
+        {
+            std::vector<std::string> required;
+            std::vector<std::string> added;
+        };
+
+        void analyse(const representation::Domain& domain, const representation::Problem& problem);
+
+        /**
+         * Collect the effects of an action into rules
+         * \param rule Rule of the enclosing effect
+         */
+        void collectEffects(const representation::Expression& effect, const Rule& rule, std::vector<Rule>& rules);
+
+        /**
+         * Check a goal, which is split at conjunctions
+         */
+        void checkGoal(const representation::Expression& goal, const boost::unordered_set<std::string>& status, const boost::unordered_set<std::string>& objects);
+
+        boost::unordered_set<std::string> mReachable;
+        // Predicates which appear in action effects, all others are static
+        boost::unordered_set<std::string> mChanged;
+        std::string mReason;
+    };
+}
+#endif // PDDL_PLANNER_REACHABILITY_ANALYSIS_HPP
@@ -0,0 +1,216 @@
+#include <pddl_planner/RemoteConnection.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+#include <sstream>
+#include <algorithm>
+
+namespace pddl_planner
+{
+
+namespace
+{
+    int toMilliseconds(double timeout)
+    {
+        return timeout > 0 ? (int)(1000. * timeout) + 1 : 0;
+    }
+}
+
+RemoteConnection::RemoteConnection(int fd)
+    : mFd(fd)
+{}
+
+RemoteConnection::RemoteConnection(const std::string& endpoint, double timeout)
+    : mFd(-1)
+{
+    size_t colon = endpoint.rfind(':');
+    if(colon == std::string::npos)
+    {
+        throw PlanGenerationException("RemoteConnection: invalid endpoint '" + endpoint + "', expected 'host:port'");
+    }
+    std::string host = endpoint.substr(0, colon);
+    std::string port = endpoint.substr(colon + 1);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* addresses = NULL;
+    int result = getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses);
+    if(result != 0)
+    {
+        throw PlanGenerationException("RemoteConnection: could not resolve '" + endpoint + "': " + gai_strerror(result));
+    }
+
+    std::string error = "no address";
+    for(struct addrinfo* address = addresses; address && mFd == -1; address = address->ai_next)
+    {
+        int fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK, address->ai_protocol);
+        if(fd == -1)
+        {
+            error = strerror(errno);
+            continue;
+        }
+
+        // Connect without blocking, so that an unreachable host is given up after the timeout
+        int connectError = 0;
+        if(-1 == connect(fd, address->ai_addr, address->ai_addrlen))
+        {
+            connectError = errno;
+            if(connectError == EINPROGRESS)
+            {
+                struct pollfd pfd;
+                pfd.fd = fd;
+                pfd.events = POLLOUT;
+                connectError = ETIMEDOUT;
+                if(poll(&pfd, 1, toMilliseconds(timeout)) > 0)
+                {
+                    socklen_t length = sizeof(connectError);
+                    getsockopt(fd, SOL_SOCKET, SO_ERROR, &connectError, &length);
+                }
+            }
+        }
+
+        if(connectError == 0)
+        {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            mFd = fd;
+        } else {
+            error = strerror(connectError);
+            close(fd);
+        }
+    }
+    freeaddrinfo(addresses);
+
+    if(mFd == -1)
+    {
+        throw PlanGenerationException("RemoteConnection: could not connect to '" + endpoint + "': " + error);
+    }
+}
+
+RemoteConnection::~RemoteConnection()
+{
+    if(mFd != -1)
+    {
+        close(mFd);
+    }
+}
+
+void RemoteConnection::send(const std::string& data)
+{
+    const char* pos = data.data();
+    size_t remaining = data.size();
+    while(remaining > 0)
+    {
+        ssize_t bytes = ::send(mFd, pos, remaining, MSG_NOSIGNAL);
+        if(bytes > 0)
+        {
+            pos += bytes;
+            remaining -= bytes;
+        } else if(errno != EINTR)
+        {
+            throw PlanGenerationException("RemoteConnection: failed to send: " + std::string(strerror(errno)));
+        }
+    }
+}
+
+bool RemoteConnection::receive(double timeout)
+{
+    struct pollfd pfd;
+    pfd.fd = mFd;
+    pfd.events = POLLIN;
+    int result;
+    do {
+        result = poll(&pfd, 1, toMilliseconds(timeout));
+    } while(-1 == result && EINTR == errno);
+
+    if(result == 0)
+    {
+        return false;
+    }
+
+    char buffer[64 * 1024];
+    ssize_t bytes;
+    do {
+        bytes = recv(mFd, buffer, sizeof(buffer), 0);
+    } while(-1 == bytes && EINTR == errno);
+
+    if(bytes <= 0)
+    {
+        throw PlanGenerationException("RemoteConnection: connection closed");
+    }
+    mBuffer.append(buffer, bytes);
+    return true;
+}
+
+bool RemoteConnection::readLine(std::string& line, double timeout)
+{
+    boost::chrono::steady_clock::time_point deadline = boost::chrono::steady_clock::now() + boost::chrono::microseconds((int64_t)(1e6 * timeout));
+    size_t newline;
+    while((newline = mBuffer.find('\n')) == std::string::npos)
+    {
+        double remaining = boost::chrono::duration<double>(deadline - boost::chrono::steady_clock::now()).count();
+        if(!receive(std::max(remaining, 0.0)))
+        {
+            return false;
+        }
+    }
+    line = mBuffer.substr(0, newline);
+    mBuffer.erase(0, newline + 1);
+    return true;
+}
+
+bool RemoteConnection::readBytes(size_t size, std::string& data, double timeout)
+{
+    boost::chrono::steady_clock::time_point deadline = boost::chrono::steady_clock::now() + boost::chrono::microseconds((int64_t)(1e6 * timeout));
+    while(mBuffer.size() < size)
+    {
+        double remaining = boost::chrono::duration<double>(deadline - boost::chrono::steady_clock::now()).count();
+        if(!receive(std::max(remaining, 0.0)))
+        {
+            return false;
+        }
+    }
+    data = mBuffer.substr(0, size);
+    mBuffer.erase(0, size);
+    return true;
+}
+
+std::string RemoteConnection::encodeStatistics(const PlannerStatistics& statistics)
+{
+    std::stringstream ss;
+    ss << statistics.wallTime << " " << statistics.timeToFirstPlan << " "
+        << statistics.userTime << " " << statistics.systemTime << " "
+        << statistics.peakMemory << " " << statistics.exitStatus << " "
+        << statistics.timedOut << " " << statistics.cancelled << " " << statistics.cached << " "
+        << statistics.unsolvable;
+    return ss.str();
+}
+
+bool RemoteConnection::decodeStatistics(const std::string& encoded, PlannerStatistics& statistics)
+{
+    std::istringstream ss(encoded);
+    if(!(ss >> statistics.wallTime >> statistics.timeToFirstPlan
+        >> statistics.userTime >> statistics.systemTime
+        >> statistics.peakMemory >> statistics.exitStatus
+        >> statistics.timedOut >> statistics.cancelled >> statistics.cached))
+    {
+        return false;
+    }
+    // Older servers do not report the result of the reachability check
+    statistics.unsolvable = false;
+    ss >> statistics.unsolvable;
+    return true;
+}
+
+} // end namespace pddl_planner
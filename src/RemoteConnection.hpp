@@ -0,0 +1,97 @@
+#ifndef PDDL_PLANNER_REMOTE_CONNECTION_HPP
+#define PDDL_PLANNER_REMOTE_CONNECTION_HPP
+
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <string>
+
+namespace pddl_planner
+{
+    /**
+     * \class RemoteConnection
+     * \brief Buffered TCP connection between a remote planner and a PlanningServer
+     * \details The protocol is line based, where a line announces the message and, if
+     * needed, the size of the payload which follows it
+     *
+     * Requests:
+     *  - "STATUS\n" asks for the number of active planning requests
+     *  - "PLAN <planner> <timeout> <domain size> <action size> <problem size>\n" followed by
+     *    the domain, action and problem descriptions starts a planning request
+     *  - "CANCEL\n" cancels the running planning request of the connection
+     *
+     * Responses:
+     *  - "STATUS <queue depth>\n"
+     *  - "PLAN <actions> <cost>\n" followed by one line per action, as soon as a plan is available
+     *  - "DONE <statistics>\n" when a planning request has finished, see encodeStatistics
+     *  - "ERROR <size>\n" followed by the error message
+     */
+    class RemoteConnection
+    {
+    public:
+        /**
+         * Take ownership of a connected socket
+         */
+        RemoteConnection(int fd);
+
+        /**
+         * Connect to a server
+         * \param endpoint Address of the server as 'host:port'
+         * \param timeout Timeout in seconds for establishing the connection
+         * \throws PlanGenerationException if the connection cannot be established
+         */
+        RemoteConnection(const std::string& endpoint, double timeout);
+
+        /**
+         * Deconstructor closes the connection
+         */
+        ~RemoteConnection();
+
+        /**
+         * Send data
+         * \throws PlanGenerationException if the connection is broken
+         */
+        void send(const std::string& data);
+
+        /**
+         * Read a line
+         * \param line Receives the line without the trailing newline
+         * \param timeout Timeout in seconds, 0 only returns a line which is already available
+         * \return true if a line has been read, false if the timeout expired
+         * \throws PlanGenerationException if the connection has been closed
+         */
+        bool readLine(std::string& line, double timeout);
+
+        /**
+         * Read a given number of bytes
+         * \param timeout Timeout in seconds for the complete data
+         * \return true if the data has been read, false if the timeout expired
+         * \throws PlanGenerationException if the connection has been closed
+         */
+        bool readBytes(size_t size, std::string& data, double timeout);
+
+        /**
+         * Encode the statistics of a planner call in a single line
+         */
+        static std::string encodeStatistics(const PlannerStatistics& statistics);
+
+        /**
+         * Decode statistics encoded by encodeStatistics
+         * \return true on success, false if the encoding is invalid
+         */
+        static bool decodeStatistics(const std::string& encoded, PlannerStatistics& statistics);
+
+    private:
+        RemoteConnection(const RemoteConnection& other);
+        RemoteConnection& operator=(const RemoteConnection& other);
+
+        /**
+         * Wait for data and append it to the buffer
+         * \return true if data has been received, false if the timeout expired
+         * \throws PlanGenerationException if the connection has been closed
+         */
+        bool receive(double timeout);
+
+        int mFd;
+        std::string mBuffer;
+    };
+}
+#endif // PDDL_PLANNER_REMOTE_CONNECTION_HPP
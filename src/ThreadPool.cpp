@@ -0,0 +1,235 @@
+#include <pddl_planner/ThreadPool.hpp>
+#include <boost/bind.hpp>
+#include <base/logging.h>
+
+namespace pddl_planner
+{
+
+namespace
+{
+    // Pool the current thread is working for
+    thread_local const ThreadPool* tlsWorkerPool = NULL;
+
+    // Maximum number of concurrent calls of remote planners
+    const size_t REMOTE_CONCURRENCY = 64;
+
+    size_t defaultConcurrency(size_t concurrency)
+    {
+        if(concurrency > 0)
+        {
+            return concurrency;
+        }
+        size_t cores = boost::thread::hardware_concurrency();
+        return cores > 0 ? cores : 1;
+    }
+}
+
+ThreadPool::ThreadPool(size_t concurrency)
+    : mConcurrency(defaultConcurrency(concurrency))
+    , mNumberOfWorkers(0)
+    , mIdle(0)
+    , mRunning(0)
+    , mShutdown(false)
+{}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        mShutdown = true;
+        mCondition.notify_all();
+    }
+    mWorkers.join_all();
+}
+
+ThreadPool& ThreadPool::getDefault()
+{
+    static ThreadPool threadPool;
+    return threadPool;
+}
+
+ThreadPool& ThreadPool::getRemote()
+{
+    static ThreadPool threadPool(REMOTE_CONCURRENCY);
+    return threadPool;
+}
+
+void ThreadPool::setConcurrency(size_t concurrency)
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mConcurrency = defaultConcurrency(concurrency);
+    startWorkerIfNeeded();
+    mCondition.notify_all();
+}
+
+size_t ThreadPool::getConcurrency() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mConcurrency;
+}
+
+void ThreadPool::submit(const Task& task)
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mTasks.push_back(task);
+    startWorkerIfNeeded();
+    mCondition.notify_one();
+}
+
+bool ThreadPool::runPendingTask()
+{
+    Task task;
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        if(mTasks.empty())
+        {
+            return false;
+        }
+        task = mTasks.front();
+        mTasks.pop_front();
+    }
+    execute(task);
+    return true;
+}
+
+bool ThreadPool::isWorkerThread() const
+{
+    return tlsWorkerPool == this;
+}
+
+void ThreadPool::startWorkerIfNeeded()
+{
+    // Workers are never stopped, so a lowered limit only restricts the number of running tasks
+    while(mIdle < mTasks.size() && mNumberOfWorkers < mConcurrency)
+    {
+        mWorkers.create_thread(boost::bind(&ThreadPool::workerLoop, this));
+        ++mNumberOfWorkers;
+        ++mIdle;
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    tlsWorkerPool = this;
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    while(true)
+    {
+        while(!mShutdown && (mTasks.empty() || mRunning >= mConcurrency))
+        {
+            mCondition.wait(lock);
+        }
+        if(mTasks.empty())
+        {
+            // Shutdown is only completed once all queued tasks are done
+            --mIdle;
+            return;
+        }
+
+        Task task = mTasks.front();
+        mTasks.pop_front();
+        --mIdle;
+        ++mRunning;
+
+        lock.unlock();
+        execute(task);
+        lock.lock();
+
+        --mRunning;
+        ++mIdle;
+        mCondition.notify_all();
+    }
+}
+
+void ThreadPool::execute(const Task& task)
+{
+    try {
+        task();
+    } catch(const std::exception& e)
+    {
+        LOG_ERROR("ThreadPool: task failed: %s", e.what());
+    } catch(...)
+    {
+        LOG_ERROR("ThreadPool: task failed with unknown exception");
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : mPool(pool)
+    , mPending(0)
+{}
+
+TaskGroup::~TaskGroup()
+{
+    waitAll();
+}
+
+void TaskGroup::run(const ThreadPool::Task& task)
+{
+    run(task, mPool);
+}
+
+void TaskGroup::run(const ThreadPool::Task& task, ThreadPool& pool)
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        ++mPending;
+    }
+    pool.submit(boost::bind(&TaskGroup::execute, this, task));
+}
+
+void TaskGroup::wait()
+{
+    waitAll();
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    if(mException)
+    {
+        std::exception_ptr exception = mException;
+        mException = std::exception_ptr();
+        std::rethrow_exception(exception);
+    }
+}
+
+void TaskGroup::execute(const ThreadPool::Task& task)
+{
+    std::exception_ptr exception;
+    try {
+        task();
+    } catch(...)
+    {
+        exception = std::current_exception();
+    }
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    if(exception && !mException)
+    {
+        mException = exception;
+    }
+    --mPending;
+    mCondition.notify_all();
+}
+
+void TaskGroup::waitAll()
+{
+    bool helping = mPool.isWorkerThread();
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    while(mPending > 0)
+    {
+        if(helping)
+        {
+            // A worker waiting for other tasks would block its slot, so work on the queue instead
+            lock.unlock();
+            bool executed = mPool.runPendingTask();
+            lock.lock();
+            if(executed)
+            {
+                continue;
+            }
+            mCondition.timed_wait(lock, boost::posix_time::milliseconds(10));
+        } else {
+            mCondition.wait(lock);
+        }
+    }
+}
+
+} // end namespace pddl_planner
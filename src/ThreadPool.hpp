@@ -0,0 +1,157 @@
+#ifndef PDDL_PLANNER_THREAD_POOL_HPP
+#define PDDL_PLANNER_THREAD_POOL_HPP
+
+#include <deque>
+#include <vector>
+#include <exception>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace pddl_planner
+{
+    /**
+     * \class ThreadPool
+     * \brief Bounded pool of worker threads which run the planner calls
+     * \details At most 'concurrency' tasks are executed at the same time, further tasks
+     * are queued. Worker threads are started on demand and kept for reuse
+     */
+    class ThreadPool
+    {
+    public:
+        typedef boost::function<void ()> Task;
+
+        /**
+         * Constructor
+         * \param concurrency Maximum number of tasks running in parallel, 0 will use
+         * the number of available cores
+         */
+        ThreadPool(size_t concurrency = 0);
+
+        /**
+         * Deconstructor waits for all queued tasks to finish
+         */
+        ~ThreadPool();
+
+        /**
+         * Get the process-wide pool which is shared by all Planning instances
+         * \return thread pool
+         */
+        static ThreadPool& getDefault();
+
+        /**
+         * Get the process-wide pool which runs the calls of remote planners -- these calls
+         * wait for the workers instead of using a core, so that they run outside of the
+         * default pool and do not take the slots of local planners
+         * \return thread pool
+         */
+        static ThreadPool& getRemote();
+
+        /**
+         * Set the maximum number of tasks running in parallel -- tasks already running
+         * are not affected when the limit is decreased
+         * \param concurrency Concurrency limit, 0 will use the number of available cores
+         */
+        void setConcurrency(size_t concurrency);
+
+        /**
+         * Get the maximum number of tasks running in parallel
+         * \return concurrency limit
+         */
+        size_t getConcurrency() const;
+
+        /**
+         * Queue a task for execution
+         * \param task Task, which should not throw
+         */
+        void submit(const Task& task);
+
+        /**
+         * Execute the next queued task in the calling thread
+         * \return true if a task has been executed, false if there was none
+         */
+        bool runPendingTask();
+
+        /**
+         * Check whether the calling thread is a worker thread of this pool
+         * \return true if calling thread is a worker of this pool
+         */
+        bool isWorkerThread() const;
+
+    private:
+        ThreadPool(const ThreadPool& other);
+        ThreadPool& operator=(const ThreadPool& other);
+
+        /**
+         * Loop of worker thread
+         */
+        void workerLoop();
+
+        /**
+         * Start further workers, if queued tasks cannot be picked up otherwise
+         * -- requires mMutex to be locked
+         */
+        void startWorkerIfNeeded();
+
+        static void execute(const Task& task);
+
+        mutable boost::mutex mMutex;
+        boost::condition_variable mCondition;
+        boost::thread_group mWorkers;
+
+        size_t mConcurrency;
+        size_t mNumberOfWorkers;
+        size_t mIdle;
+        size_t mRunning;
+        bool mShutdown;
+        std::deque<Task> mTasks;
+    };
+
+    /**
+     * \class TaskGroup
+     * \brief Set of tasks running in a ThreadPool which can be waited for
+     * \details When waiting from within a worker thread, queued tasks are executed
+     * while waiting, so that nested use of the pool cannot deadlock
+     */
+    class TaskGroup
+    {
+    public:
+        TaskGroup(ThreadPool& pool = ThreadPool::getDefault());
+
+        /**
+         * Deconstructor waits for all tasks of this group
+         */
+        ~TaskGroup();
+
+        /**
+         * Run a task as part of this group
+         */
+        void run(const ThreadPool::Task& task);
+
+        /**
+         * Run a task as part of this group in another pool than the one of the group
+         */
+        void run(const ThreadPool::Task& task, ThreadPool& pool);
+
+        /**
+         * Wait for all tasks of this group
+         * \throws the first exception which has been thrown by any of the tasks
+         */
+        void wait();
+
+    private:
+        TaskGroup(const TaskGroup& other);
+        TaskGroup& operator=(const TaskGroup& other);
+
+        void execute(const ThreadPool::Task& task);
+        void waitAll();
+
+        ThreadPool& mPool;
+        boost::mutex mMutex;
+        boost::condition_variable mCondition;
+        size_t mPending;
+        std::exception_ptr mException;
+    };
+}
+#endif // PDDL_PLANNER_THREAD_POOL_HPP
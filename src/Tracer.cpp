@@ -0,0 +1,164 @@
+#include <pddl_planner/Tracer.hpp>
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fstream>
+
+namespace pddl_planner
+{
+
+namespace
+{
+    const boost::chrono::steady_clock::time_point msEpoch = boost::chrono::steady_clock::now();
+
+    void writeString(std::ostream& out, const std::string& text)
+    {
+        out << '"';
+        std::string::const_iterator it = text.begin();
+        for(; it != text.end(); ++it)
+        {
+            if(*it == '"' || *it == '\\')
+            {
+                out << '\\' << *it;
+            } else if((unsigned char) *it < 0x20)
+            {
+                out << ' ';
+            } else {
+                out << *it;
+            }
+        }
+        out << '"';
+    }
+}
+
+Tracer::Tracer()
+    : mEnabled(false)
+    , mCapacity(0)
+    , mDropped(0)
+{}
+
+Tracer& Tracer::getInstance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::enable(size_t capacity)
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mCapacity = capacity;
+    mEnabled = true;
+}
+
+void Tracer::disable()
+{
+    mEnabled = false;
+}
+
+void Tracer::setCallback(const TraceCallback& callback)
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mCallback = callback;
+}
+
+void Tracer::record(const TraceEvent& event)
+{
+    TraceCallback callback;
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        if(mEvents.size() < mCapacity)
+        {
+            mEvents.push_back(event);
+        } else {
+            ++mDropped;
+        }
+        callback = mCallback;
+    }
+
+    if(callback)
+    {
+        callback(event);
+    }
+}
+
+std::vector<TraceEvent> Tracer::getEvents() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mEvents;
+}
+
+size_t Tracer::getDropped() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mDropped;
+}
+
+void Tracer::clear()
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mEvents.clear();
+    mDropped = 0;
+}
+
+void Tracer::writeChromeTrace(std::ostream& out) const
+{
+    std::vector<TraceEvent> events = getEvents();
+    pid_t pid = getpid();
+
+    out << "{\"traceEvents\":[";
+    std::vector<TraceEvent>::const_iterator it = events.begin();
+    for(; it != events.end(); ++it)
+    {
+        out << (it == events.begin() ? "\n" : ",\n") << "{\"name\":";
+        writeString(out, it->name);
+        out << ",\"cat\":\"pddl_planner\",\"ph\":\"X\",\"ts\":" << it->start
+            << ",\"dur\":" << it->duration
+            << ",\"pid\":" << pid
+            << ",\"tid\":" << it->thread;
+        if(!it->detail.empty())
+        {
+            out << ",\"args\":{\"detail\":";
+            writeString(out, it->detail);
+            out << "}";
+        }
+        out << "}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+}
+
+void Tracer::save(const std::string& filename) const
+{
+    std::ofstream out(filename.c_str());
+    if(!out)
+    {
+        throw PlanGenerationException("Tracer: failed to open '" + filename + "'");
+    }
+    writeChromeTrace(out);
+    if(!out)
+    {
+        throw PlanGenerationException("Tracer: failed to write '" + filename + "'");
+    }
+}
+
+uint64_t Tracer::now() const
+{
+    return boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now() - msEpoch).count();
+}
+
+void TraceSpan::start(const char* name, const std::string& detail)
+{
+    mEvent.name = name;
+    mEvent.detail = detail;
+    mEvent.thread = syscall(SYS_gettid);
+    mEvent.start = Tracer::getInstance().now();
+}
+
+void TraceSpan::finish()
+{
+    mEvent.duration = Tracer::getInstance().now() - mEvent.start;
+    mActive = false;
+    Tracer::getInstance().record(mEvent);
+}
+
+} // end namespace pddl_planner
@@ -0,0 +1,178 @@
+#ifndef PDDL_PLANNER_TRACER_HPP
+#define PDDL_PLANNER_TRACER_HPP
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace pddl_planner
+{
+    /**
+     * Completed span of a planning stage
+     */
+    struct TraceEvent
+    {
+        TraceEvent()
+            : name(NULL)
+            , start(0)
+            , duration(0)
+            , thread(0)
+        {}
+
+        // Name of the stage, a string literal
+        const char* name;
+        // Optional detail, e.g. the planner or file a stage refers to
+        std::string detail;
+        // Start and duration in microseconds -- the start is relative to the start of the process
+        uint64_t start;
+        uint64_t duration;
+        // Kernel id of the thread
+        long thread;
+    };
+
+    // Callback receiving each completed span, e.g. to forward it to an OpenTelemetry exporter
+    typedef boost::function<void (const TraceEvent& event)> TraceCallback;
+
+    /**
+     * \class Tracer
+     * \brief Process-wide collector of spans covering the stages of planning requests
+     * \details Tracing is disabled by default, so that a span costs a single atomic load.
+     * When enabled, spans are kept in memory up to a capacity and can be written in the
+     * Chrome trace event format, which chrome://tracing and Perfetto display as timeline
+     * per thread. A callback allows to hand spans to other tracing systems
+     */
+    class Tracer
+    {
+    public:
+        /**
+         * Get the process-wide tracer
+         * \return tracer
+         */
+        static Tracer& getInstance();
+
+        /**
+         * Start recording spans
+         * \param capacity Maximum number of spans kept in memory, further spans are
+         * dropped but still passed to the callback
+         */
+        void enable(size_t capacity = 1000000);
+
+        /**
+         * Stop recording spans -- recorded spans are kept
+         */
+        void disable();
+
+        /**
+         * Check if spans are recorded
+         */
+        bool isEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
+
+        /**
+         * Set a callback receiving each completed span -- it is called from the thread
+         * which completed the span
+         */
+        void setCallback(const TraceCallback& callback);
+
+        /**
+         * Record a completed span
+         */
+        void record(const TraceEvent& event);
+
+        /**
+         * Get the recorded spans in the order of completion
+         */
+        std::vector<TraceEvent> getEvents() const;
+
+        /**
+         * Get the number of spans which have been dropped since the capacity was exceeded
+         */
+        size_t getDropped() const;
+
+        /**
+         * Remove all recorded spans
+         */
+        void clear();
+
+        /**
+         * Write the recorded spans as Chrome trace JSON
+         */
+        void writeChromeTrace(std::ostream& out) const;
+
+        /**
+         * Write the recorded spans as Chrome trace JSON to a file
+         * \throws PlanGenerationException if the file cannot be written
+         */
+        void save(const std::string& filename) const;
+
+        /**
+         * Get the current time in microseconds relative to the start of the process
+         */
+        uint64_t now() const;
+
+    private:
+        Tracer();
+        Tracer(const Tracer& other);
+        Tracer& operator=(const Tracer& other);
+
+        std::atomic<bool> mEnabled;
+        mutable boost::mutex mMutex;
+        size_t mCapacity;
+        size_t mDropped;
+        std::vector<TraceEvent> mEvents;
+        TraceCallback mCallback;
+    };
+
+    /**
+     * \class TraceSpan
+     * \brief Span covering the lifetime of the object or until end() is called -- it is
+     * only recorded if tracing was enabled when the span started
+     */
+    class TraceSpan
+    {
+    public:
+        /**
+         * Start a span
+         * \param name Name of the stage, which has to be a string literal
+         * \param detail Optional detail, which is only copied if tracing is enabled
+         */
+        TraceSpan(const char* name, const std::string& detail = std::string())
+            : mActive(Tracer::getInstance().isEnabled())
+        {
+            if(mActive)
+            {
+                start(name, detail);
+            }
+        }
+
+        ~TraceSpan()
+        {
+            end();
+        }
+
+        /**
+         * End the span before its destruction
+         */
+        void end()
+        {
+            if(mActive)
+            {
+                finish();
+            }
+        }
+
+    private:
+        TraceSpan(const TraceSpan& other);
+        TraceSpan& operator=(const TraceSpan& other);
+
+        void start(const char* name, const std::string& detail);
+        void finish();
+
+        bool mActive;
+        TraceEvent mEvent;
+    };
+}
+#endif // PDDL_PLANNER_TRACER_HPP
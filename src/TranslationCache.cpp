@@ -0,0 +1,287 @@
+#include <pddl_planner/TranslationCache.hpp>
+#include <pddl_planner/PlanCache.hpp>
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <boost/filesystem.hpp>
+#include <base/logging.h>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+
+namespace fs = boost::filesystem;
+
+namespace pddl_planner
+{
+
+namespace
+{
+    /**
+     * Link a file to a new location, or copy it if linking is not possible,
+     * e.g. across file systems
+     */
+    bool linkOrCopy(const std::string& from, const std::string& to)
+    {
+        boost::system::error_code ec;
+        fs::remove(to, ec);
+        fs::create_hard_link(from, to, ec);
+        if(ec)
+        {
+            ec.clear();
+            fs::copy_file(from, to, fs::copy_option::overwrite_if_exists, ec);
+        }
+        return !ec;
+    }
+
+    /**
+     * Create a temporary filename for the given file, which is unique among the threads and
+     * processes sharing the directory
+     */
+    std::string createTmpFilename(const std::string& filename)
+    {
+        static std::atomic<unsigned int> counter(0);
+        std::stringstream ss;
+        ss << filename << ".tmp." << getpid() << "." << counter++;
+        return ss.str();
+    }
+}
+
+TranslationCache::TranslationCache(const std::string& directory, size_t capacity)
+    : mDirectory(directory)
+    , mCapacity(capacity)
+    , mHits(0)
+    , mMisses(0)
+{
+    boost::system::error_code ec;
+    fs::create_directories(mDirectory, ec);
+    if(!fs::is_directory(mDirectory))
+    {
+        throw PlanGenerationException("TranslationCache: could not create directory '" + mDirectory + "'");
+    }
+
+    // Reuse existing entries, most recently written first
+    std::vector< std::pair<std::time_t, std::string> > existing;
+    fs::directory_iterator dirIt(mDirectory, ec);
+    for(; !ec && dirIt != fs::directory_iterator(); dirIt.increment(ec))
+    {
+        if(dirIt->path().extension() == ".sas")
+        {
+            boost::system::error_code timeEc;
+            existing.push_back(std::make_pair(fs::last_write_time(dirIt->path(), timeEc), dirIt->path().stem().string()));
+        }
+    }
+    std::sort(existing.rbegin(), existing.rend());
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    for(size_t i = 0; i < existing.size(); ++i)
+    {
+        mEntries.push_back(existing[i].second);
+        mIndex[existing[i].second] = --mEntries.end();
+    }
+    touch("");
+}
+
+std::string TranslationCache::createRequest(const std::string& domainDescriptions, const std::string& actionDescriptions, const std::string& problem)
+{
+    return PlanCache::createRequest("translation", domainDescriptions, actionDescriptions, problem);
+}
+
+std::string TranslationCache::createKey(const std::string& domainDescriptions, const std::string& actionDescriptions, const std::string& problem)
+{
+    return PlanCache::getKey(createRequest(domainDescriptions, actionDescriptions, problem));
+}
+
+bool TranslationCache::provide(const std::string& request, const std::string& filename, const Translator& translator)
+{
+    std::string key = PlanCache::getKey(request);
+    boost::shared_ptr<boost::mutex> keyMutex;
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        boost::shared_ptr<boost::mutex>& entry = mKeyMutexes[key];
+        if(!entry)
+        {
+            entry.reset(new boost::mutex);
+        }
+        keyMutex = entry;
+    }
+
+    bool provided = false;
+    {
+        // Concurrent requests for this key wait for a running translation
+        boost::unique_lock<boost::mutex> keyLock(*keyMutex);
+        std::string cachedFilename = getFilename(key);
+
+        bool cached = false;
+        {
+            boost::unique_lock<boost::mutex> lock(mMutex);
+            cached = mIndex.count(key) && fs::exists(cachedFilename);
+        }
+        // The entry of a colliding request is replaced below
+        cached = cached && isStoredRequest(key, request);
+
+        if(cached && linkOrCopy(cachedFilename, filename))
+        {
+            boost::unique_lock<boost::mutex> lock(mMutex);
+            ++mHits;
+            touch(key);
+            provided = true;
+        } else {
+            {
+                boost::unique_lock<boost::mutex> lock(mMutex);
+                ++mMisses;
+            }
+
+            provided = translator(filename) && fs::exists(filename);
+            if(provided)
+            {
+                if(!store(key, request, filename))
+                {
+                    LOG_WARN("TranslationCache: failed to store translation '%s'", cachedFilename.c_str());
+                } else {
+                    boost::unique_lock<boost::mutex> lock(mMutex);
+                    touch(key);
+                }
+            }
+        }
+    }
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    std::map<std::string, boost::shared_ptr<boost::mutex> >::iterator it = mKeyMutexes.find(key);
+    keyMutex.reset();
+    if(it != mKeyMutexes.end() && it->second.unique())
+    {
+        mKeyMutexes.erase(it);
+    }
+    return provided;
+}
+
+void TranslationCache::clear()
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    std::list<std::string>::const_iterator it = mEntries.begin();
+    for(; it != mEntries.end(); ++it)
+    {
+        remove(*it);
+    }
+    mEntries.clear();
+    mIndex.clear();
+}
+
+uint64_t TranslationCache::getHits() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mHits;
+}
+
+uint64_t TranslationCache::getMisses() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mMisses;
+}
+
+size_t TranslationCache::size() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mEntries.size();
+}
+
+std::string TranslationCache::getFilename(const std::string& key) const
+{
+    return (fs::path(mDirectory) / (key + ".sas")).string();
+}
+
+std::string TranslationCache::getRequestFilename(const std::string& key) const
+{
+    return (fs::path(mDirectory) / (key + ".request")).string();
+}
+
+bool TranslationCache::isStoredRequest(const std::string& key, const std::string& request) const
+{
+    std::ifstream in(getRequestFilename(key).c_str(), std::ios::binary);
+    if(!in.is_open())
+    {
+        return false;
+    }
+    std::string stored((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if(stored != request)
+    {
+        LOG_DEBUG("TranslationCache: entry '%s' belongs to another request", key.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool TranslationCache::store(const std::string& key, const std::string& request, const std::string& filename) const
+{
+    std::string requestFilename = getRequestFilename(key);
+    std::string tmpRequestFilename = createTmpFilename(requestFilename);
+    {
+        std::ofstream out(tmpRequestFilename.c_str(), std::ios::binary);
+        out.write(request.data(), request.size());
+        out.close();
+        if(!out)
+        {
+            boost::system::error_code ec;
+            fs::remove(tmpRequestFilename, ec);
+            return false;
+        }
+    }
+
+    std::string cachedFilename = getFilename(key);
+    std::string tmpFilename = createTmpFilename(cachedFilename);
+    boost::system::error_code ec;
+    if(!linkOrCopy(filename, tmpFilename))
+    {
+        fs::remove(tmpRequestFilename, ec);
+        return false;
+    }
+
+    // The translation is only used along with a matching request, so the request is
+    // replaced first
+    fs::rename(tmpRequestFilename, requestFilename, ec);
+    if(!ec)
+    {
+        fs::rename(tmpFilename, cachedFilename, ec);
+    }
+    if(ec)
+    {
+        boost::system::error_code removeEc;
+        fs::remove(tmpRequestFilename, removeEc);
+        fs::remove(tmpFilename, removeEc);
+        return false;
+    }
+    return true;
+}
+
+void TranslationCache::remove(const std::string& key) const
+{
+    boost::system::error_code ec;
+    fs::remove(getFilename(key), ec);
+    fs::remove(getRequestFilename(key), ec);
+}
+
+void TranslationCache::touch(const std::string& key)
+{
+    if(!key.empty())
+    {
+        std::map<std::string, std::list<std::string>::iterator>::iterator it = mIndex.find(key);
+        if(it != mIndex.end())
+        {
+            mEntries.splice(mEntries.begin(), mEntries, it->second);
+        } else {
+            mEntries.push_front(key);
+            mIndex[key] = mEntries.begin();
+        }
+    }
+
+    while(mEntries.size() > mCapacity)
+    {
+        remove(mEntries.back());
+        mIndex.erase(mEntries.back());
+        mEntries.pop_back();
+    }
+}
+
+} // end namespace pddl_planner
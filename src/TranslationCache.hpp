@@ -0,0 +1,122 @@
+#ifndef PDDL_PLANNER_TRANSLATION_CACHE_HPP
+#define PDDL_PLANNER_TRANSLATION_CACHE_HPP
+
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <stdint.h>
+#include <string>
+#include <list>
+#include <map>
+
+namespace pddl_planner
+{
+    /**
+     * \class TranslationCache
+     * \brief Cache for translated planning tasks, e.g. the output.sas file of the Fast Downward translator
+     * \details The translated task encodes the objects and the initial state, so entries are
+     * keyed by domain and problem. Concurrent requests for the same key share a single
+     * translation, i.e. planners that run in parallel on the same problem translate it once.
+     * Each entry is stored along with its normalized request, which is compared before the
+     * entry is used, so that a hash collision is a cache miss
+     */
+    class TranslationCache
+    {
+    public:
+        /**
+         * Translator which writes the translated task to the given file
+         * \return true on success, false otherwise
+         */
+        typedef boost::function<bool (const std::string& filename)> Translator;
+
+        /**
+         * Constructor
+         * \param directory Directory to store the translated tasks in, existing entries are reused
+         * \param capacity Maximum number of stored tasks
+         * \throws PlanGenerationException if directory cannot be created
+         */
+        TranslationCache(const std::string& directory, size_t capacity = 16);
+
+        /**
+         * Create the normalized request for a planning task
+         * \return normalized request
+         */
+        static std::string createRequest(const std::string& domainDescriptions, const std::string& actionDescriptions, const std::string& problem);
+
+        /**
+         * Create the cache key for a planning task, i.e. a hash of its normalized request
+         * \return cache key
+         */
+        static std::string createKey(const std::string& domainDescriptions, const std::string& actionDescriptions, const std::string& problem);
+
+        /**
+         * Provide the translated task for the given request in a file -- the task is translated
+         * with the given translator unless it is already cached
+         * \param request Normalized request as returned by createRequest
+         * \param filename File which receives the translated task
+         * \param translator Translator which is called on a cache miss
+         * \return true if the file contains the translated task, false if translation failed
+         */
+        bool provide(const std::string& request, const std::string& filename, const Translator& translator);
+
+        /**
+         * Remove all stored tasks
+         */
+        void clear();
+
+        /**
+         * Get number of cache hits
+         */
+        uint64_t getHits() const;
+
+        /**
+         * Get number of cache misses
+         */
+        uint64_t getMisses() const;
+
+        /**
+         * Get number of stored tasks
+         */
+        size_t size() const;
+
+    private:
+        std::string getFilename(const std::string& key) const;
+        std::string getRequestFilename(const std::string& key) const;
+
+        /**
+         * Check whether the stored entry of the key belongs to the given request
+         */
+        bool isStoredRequest(const std::string& key, const std::string& request) const;
+
+        /**
+         * Store an entry -- the files are written under unique names and renamed, so that
+         * readers never see partial files, even if processes share the directory
+         * \return true on success, false otherwise
+         */
+        bool store(const std::string& key, const std::string& request, const std::string& filename) const;
+
+        /**
+         * Remove the files of an entry
+         */
+        void remove(const std::string& key) const;
+
+        /**
+         * Mark entry as most recently used and evict the least recently used entries if needed
+         */
+        void touch(const std::string& key);
+
+        mutable boost::mutex mMutex;
+        std::string mDirectory;
+        size_t mCapacity;
+
+        // Most recently used entries are at the front
+        std::list<std::string> mEntries;
+        std::map<std::string, std::list<std::string>::iterator> mIndex;
+        // Serializes the translation per key
+        std::map<std::string, boost::shared_ptr<boost::mutex> > mKeyMutexes;
+
+        uint64_t mHits;
+        uint64_t mMisses;
+    };
+}
+#endif // PDDL_PLANNER_TRANSLATION_CACHE_HPP
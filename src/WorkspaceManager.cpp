@@ -0,0 +1,210 @@
+#include <pddl_planner/WorkspaceManager.hpp>
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <boost/filesystem.hpp>
+#include <base/logging.h>
+#include <vector>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+namespace fs = boost::filesystem;
+
+namespace pddl_planner
+{
+
+WorkspaceManager::WorkspaceManager(const std::string& root, size_t poolSize)
+    : mRoot(root)
+    , mPoolSize(poolSize)
+    , mShutdown(false)
+{}
+
+WorkspaceManager::~WorkspaceManager()
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        mShutdown = true;
+        mCondition.notify_all();
+    }
+    if(mCleanupThread.joinable())
+    {
+        mCleanupThread.join();
+    }
+
+    std::map<std::string, WorkspaceQueue>::iterator it = mPool.begin();
+    for(; it != mPool.end(); ++it)
+    {
+        WorkspaceQueue::iterator wit = it->second.begin();
+        for(; wit != it->second.end(); ++wit)
+        {
+            boost::system::error_code ec;
+            fs::remove_all(*wit, ec);
+        }
+    }
+}
+
+WorkspaceManager& WorkspaceManager::getInstance()
+{
+    static WorkspaceManager workspaceManager;
+    return workspaceManager;
+}
+
+void WorkspaceManager::setRoot(const std::string& root)
+{
+    if(!fs::is_directory(root))
+    {
+        throw PlanGenerationException("WorkspaceManager: root '" + root + "' is not an existing directory");
+    }
+
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mRoot = root;
+
+    // Discard pooled workspaces, since they belong to the previous root
+    std::map<std::string, WorkspaceQueue>::iterator it = mPool.begin();
+    for(; it != mPool.end(); ++it)
+    {
+        mReleased.insert(mReleased.end(), it->second.begin(), it->second.end());
+    }
+    mPool.clear();
+
+    if(!mReleased.empty() && !mCleanupThread.joinable())
+    {
+        mCleanupThread = boost::thread(&WorkspaceManager::cleanupLoop, this);
+    }
+    mCondition.notify_all();
+}
+
+std::string WorkspaceManager::getRoot() const
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    return mRoot;
+}
+
+void WorkspaceManager::setPoolSize(size_t poolSize)
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mPoolSize = poolSize;
+}
+
+std::string WorkspaceManager::acquire(const std::string& tag)
+{
+    std::string root;
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        WorkspaceQueue& pool = mPool[tag];
+        if(!pool.empty())
+        {
+            std::string workspace = pool.front();
+            pool.pop_front();
+            return workspace;
+        }
+        root = mRoot;
+    }
+
+    // mkdtemp guarantees a unique directory, even for concurrent requests
+    std::string pattern = root + "/pddl_planner_" + tag + "_XXXXXX";
+    std::vector<char> buffer(pattern.begin(), pattern.end());
+    buffer.push_back('\0');
+    if(NULL == mkdtemp(&buffer[0]))
+    {
+        std::string msg = "WorkspaceManager: could not create workspace below '" + root + "': " + std::string(strerror(errno));
+        LOG_ERROR("%s", msg.c_str());
+        throw PlanGenerationException(msg);
+    }
+
+    std::string workspace(&buffer[0]);
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mTags[workspace] = tag;
+    return workspace;
+}
+
+void WorkspaceManager::release(const std::string& workspace)
+{
+    boost::unique_lock<boost::mutex> lock(mMutex);
+    mReleased.push_back(workspace);
+    if(!mCleanupThread.joinable())
+    {
+        mCleanupThread = boost::thread(&WorkspaceManager::cleanupLoop, this);
+    }
+    mCondition.notify_all();
+}
+
+void WorkspaceManager::cleanupLoop()
+{
+    while(true)
+    {
+        std::string workspace;
+        {
+            boost::unique_lock<boost::mutex> lock(mMutex);
+            while(mReleased.empty() && !mShutdown)
+            {
+                mCondition.wait(lock);
+            }
+            if(mReleased.empty())
+            {
+                return;
+            }
+            workspace = mReleased.front();
+            mReleased.pop_front();
+        }
+
+        // Remove the content, but keep the directory itself for reuse
+        bool cleaned = true;
+        boost::system::error_code ec;
+        fs::directory_iterator dirIt(workspace, ec);
+        for(; !ec && dirIt != fs::directory_iterator(); dirIt.increment(ec))
+        {
+            boost::system::error_code removeEc;
+            fs::remove_all(dirIt->path(), removeEc);
+            if(removeEc)
+            {
+                LOG_WARN("WorkspaceManager: failed to remove '%s': %s", dirIt->path().string().c_str(), removeEc.message().c_str());
+                cleaned = false;
+            }
+        }
+        cleaned = cleaned && !ec;
+
+        bool recycle = false;
+        {
+            boost::unique_lock<boost::mutex> lock(mMutex);
+            std::map<std::string, std::string>::iterator it = mTags.find(workspace);
+            if(it != mTags.end())
+            {
+                WorkspaceQueue& pool = mPool[it->second];
+                recycle = cleaned && !mShutdown && pool.size() < mPoolSize && fs::path(workspace).parent_path() == fs::path(mRoot);
+                if(recycle)
+                {
+                    pool.push_back(workspace);
+                } else {
+                    mTags.erase(it);
+                }
+            }
+        }
+
+        if(!recycle)
+        {
+            fs::remove_all(workspace, ec);
+        }
+    }
+}
+
+WorkspaceLease::WorkspaceLease(const std::string& tag, WorkspaceManager& manager)
+    : mManager(manager)
+    , mPath(manager.acquire(tag))
+    , mReleased(false)
+{}
+
+WorkspaceLease::~WorkspaceLease()
+{
+    release();
+}
+
+void WorkspaceLease::release()
+{
+    if(!mReleased)
+    {
+        mReleased = true;
+        mManager.release(mPath);
+    }
+}
+
+} // end namespace pddl_planner
@@ -0,0 +1,140 @@
+#ifndef PDDL_PLANNER_WORKSPACE_MANAGER_HPP
+#define PDDL_PLANNER_WORKSPACE_MANAGER_HPP
+
+#include <string>
+#include <map>
+#include <deque>
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace pddl_planner
+{
+    /**
+     * \class WorkspaceManager
+     * \brief Provides unique scratch directories for planner calls
+     * \details Directories are created below a configurable root directory, e.g. a tmpfs mount.
+     * Released directories are emptied by a background thread and recycled, so that
+     * the request path neither pays for creating nor for removing directories
+     */
+    class WorkspaceManager
+    {
+    public:
+        /**
+         * Constructor
+         * \param root Root directory below which the workspaces will be created
+         * \param poolSize Maximum number of recycled workspaces kept per tag
+         */
+        WorkspaceManager(const std::string& root = "/tmp", size_t poolSize = 8);
+
+        /**
+         * Deconstructor waits for pending cleanups and removes all pooled workspaces
+         */
+        ~WorkspaceManager();
+
+        /**
+         * Get the process-wide workspace manager which is used by the planners
+         * \return workspace manager
+         */
+        static WorkspaceManager& getInstance();
+
+        /**
+         * Set the root directory for new workspaces -- pooled workspaces
+         * below the previous root will be discarded
+         * \throws PlanGenerationException if root is not an existing directory
+         */
+        void setRoot(const std::string& root);
+
+        /**
+         * Get the root directory for workspaces
+         * \return root directory
+         */
+        std::string getRoot() const;
+
+        /**
+         * Set maximum number of recycled workspaces kept per tag
+         */
+        void setPoolSize(size_t poolSize);
+
+        /**
+         * Acquire an empty workspace which is exclusively used by the caller until released
+         * \param tag Tag, e.g. the planner name, which becomes part of the directory name
+         * \return path to the workspace directory
+         * \throws PlanGenerationException if no workspace could be created
+         */
+        std::string acquire(const std::string& tag);
+
+        /**
+         * Release a workspace -- its content will be removed asynchronously before the
+         * workspace is reused
+         * \param workspace Path of the workspace as returned by acquire
+         */
+        void release(const std::string& workspace);
+
+    private:
+        WorkspaceManager(const WorkspaceManager& other);
+        WorkspaceManager& operator=(const WorkspaceManager& other);
+
+        /**
+         * Loop of cleanup thread
+         */
+        void cleanupLoop();
+
+        typedef std::deque<std::string> WorkspaceQueue;
+
+        mutable boost::mutex mMutex;
+        boost::condition_variable mCondition;
+        boost::thread mCleanupThread;
+
+        std::string mRoot;
+        size_t mPoolSize;
+        bool mShutdown;
+
+        // Workspaces pending for cleanup and mapping of workspaces to their tag
+        WorkspaceQueue mReleased;
+        std::map<std::string, std::string> mTags;
+        // Readily cleaned workspaces per tag
+        std::map<std::string, WorkspaceQueue> mPool;
+    };
+
+    /**
+     * \class WorkspaceLease
+     * \brief Holds a workspace acquired from a WorkspaceManager and releases it on
+     * destruction, so that the workspace is also handed back when a planner call fails
+     */
+    class WorkspaceLease
+    {
+    public:
+        /**
+         * Acquire a workspace
+         * \param tag Tag of the workspace, see WorkspaceManager::acquire
+         * \throws PlanGenerationException if no workspace could be created
+         */
+        WorkspaceLease(const std::string& tag, WorkspaceManager& manager = WorkspaceManager::getInstance());
+
+        /**
+         * Deconstructor releases the workspace, unless it has been released already
+         */
+        ~WorkspaceLease();
+
+        /**
+         * Get the path of the workspace
+         * \return path to the workspace directory
+         */
+        const std::string& getPath() const { return mPath; }
+
+        /**
+         * Release the workspace -- further calls have no effect
+         */
+        void release();
+
+    private:
+        WorkspaceLease(const WorkspaceLease& other);
+        WorkspaceLease& operator=(const WorkspaceLease& other);
+
+        WorkspaceManager& mManager;
+        std::string mPath;
+        bool mReleased;
+    };
+}
+#endif // PDDL_PLANNER_WORKSPACE_MANAGER_HPP
@@ -3,12 +3,9 @@
 #include <fstream>
 #include <sstream>
 #include <string.h>
-#include <boost/filesystem.hpp>
 #include <base/logging.h>
-#include <base/time.h>
 #include <list>
-
-namespace fs = boost::filesystem;
+#include <vector>
 
 namespace pddl_planner
 {
@@ -20,42 +17,28 @@ Planner::Planner(const std::string& resultFileBasename)
     msResultFileBasename = resultFileBasename;
 }
 
-PlanCandidates Planner::plan(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout)
+PlanCandidates Planner::plan(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout, const CancellationToken& token, const PlanCallback& callback)
 {
     LOG_DEBUG("Planner called with problem: '%s'", problem.c_str());
-    int result = system("which cedalion-planner");
-    if(result != 0)
-    {
-        std::string msg = "Could not find 'cedalion-planner' script";
-        LOG_ERROR("%s",msg.c_str());
-        throw PlanGenerationException(msg);
-    }
-
-    std::string currentTime = base::Time::now().toString();
-    fs::path path(msTempDirBasename + "/" + currentTime + "_cedalion");
+    std::string executable = getExecutable();
 
-    if(!fs::exists(path))
-    {
-        if (!fs::create_directory(path))
-        {
-            LOG_ERROR("Could not create directory: %s", path.string().c_str());
-        }
-    }
-    mTempDir = path.string();
-    mTimeout = timeout;
-    prepare(problem, actionDescriptions, domainDescriptions);
-    PlanCandidates planCandidates = generatePlanCandidates();
+    PlannerCall call = prepare("cedalion", problem, actionDescriptions, domainDescriptions, timeout);
+    PlanCandidates planCandidates = generatePlanCandidates(call, executable, token, callback);
     return planCandidates;
 }
 
-PlanCandidates Planner::generatePlanCandidates()
+PlanCandidates Planner::generatePlanCandidates(const PlannerCall& call, const std::string& executable, const CancellationToken& token, const PlanCallback& callback)
 {
-    std::string cmd = "cedalion-planner " + mDomainFilename + " " + mProblemFilename + " ipc seq-sat-cedalion " + "--plan-file " + mResultFilename;
-    
-
-    std::list<std::string> pattern;
-    pattern.push_back("cedalion");
-    PlanCandidates planCandidates = generateCandidates(cmd, mTempDir, mResultFilename, pattern, mTimeout, getName());
+    std::vector<std::string> arguments;
+    arguments.push_back(executable);
+    arguments.push_back(call.domainFilename);
+    arguments.push_back(call.problemFilename);
+    arguments.push_back("ipc");
+    arguments.push_back("seq-sat-cedalion");
+    arguments.push_back("--plan-file");
+    arguments.push_back(call.resultFilename);
+
+    PlanCandidates planCandidates = generateCandidates(arguments, call.tempDir, call.resultFilename, call.timeout, getName(), token, callback);
         
     std::list<std::string> files;
     files.push_back(std::string("output"));
@@ -63,7 +46,7 @@ PlanCandidates Planner::generatePlanCandidates()
     files.push_back(std::string("plan_numbers_and_cost"));
     files.push_back(std::string("elapsed.time"));
     
-    cleanup(mTempDir, files);
+    cleanup(call, files);
     return planCandidates;
 }
 
@@ -1,14 +1,17 @@
 #include <pddl_planner/planners/FastDownward.hpp>
+#include <pddl_planner/Process.hpp>
+#include <pddl_planner/CoreAllocator.hpp>
+#include <pddl_planner/Tracer.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/bind.hpp>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string.h>
-#include <boost/filesystem.hpp>
 #include <base/logging.h>
-#include <base/time.h>
 #include <list>
-
-namespace fs = boost::filesystem;
+#include <vector>
 
 namespace pddl_planner
 {
@@ -20,56 +23,133 @@ Planner::Planner(const std::string& resultFileBasename, const std::string& alias
     msResultFileBasename = resultFileBasename;
 }
 
-PlanCandidates Planner::plan(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout)
+PlanCandidates Planner::plan(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout, const CancellationToken& token, const PlanCallback& callback)
 {
     LOG_DEBUG("Planner called with problem: '%s'", problem.c_str());
-    int result = system("which fast_downward-planner");
-    if(result != 0)
+    std::string executable = getExecutable();
+
+    PlannerCall call = prepare("fd", problem, actionDescriptions, domainDescriptions, timeout);
+
+    // The search of an alias can start from a translated task, so that the translation
+    // is shared between calls for the same domain and problem
+    boost::shared_ptr<TranslationCache> cache = getTranslationCache();
+    std::string translatedFilename;
+    if(cache && !mAlias.empty())
+    {
+        typedef boost::chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+        std::string filename = call.tempDir + "/output.sas";
+        std::string request = TranslationCache::createRequest(domainDescriptions, actionDescriptions, problem);
+        if(cache->provide(request, filename, boost::bind(&Planner::translate, this, boost::cref(call), executable, call.timeout, boost::cref(token), _1)))
+        {
+            translatedFilename = filename;
+            call.timeout -= boost::chrono::duration<double>(Clock::now() - start).count();
+        } else {
+            LOG_WARN("Planner %s: translation failed -- running the complete planner", getName().c_str());
+        }
+    }
+
+    PlanCandidates planCandidates = generatePlanCandidates(call, executable, token, callback, translatedFilename);
+    return planCandidates;
+}
+
+void Planner::setTranslationCache(const boost::shared_ptr<TranslationCache>& cache)
+{
+    boost::unique_lock<boost::mutex> lock(mTranslationCacheMutex);
+    mTranslationCache = cache;
+}
+
+boost::shared_ptr<TranslationCache> Planner::getTranslationCache() const
+{
+    boost::unique_lock<boost::mutex> lock(mTranslationCacheMutex);
+    return mTranslationCache;
+}
+
+bool Planner::translate(const PlannerCall& call, const std::string& executable, double timeout, const CancellationToken& token, const std::string& filename)
+{
+    TraceSpan span("translate", getName());
+    std::vector<std::string> arguments;
+    arguments.push_back(executable);
+    arguments.push_back("--translate");
+    arguments.push_back(call.domainFilename);
+    arguments.push_back(call.problemFilename);
+
+    // The translator is subject to the same limits as the search
+    CoreReservation cores;
+    ResourceLimits limits = getResourceLimits();
+    if(!cores.getCores().empty())
     {
-        std::string msg = "Could not find 'fast_downward-planner' planner script";
-        LOG_ERROR("%s",msg.c_str());
-        throw PlanGenerationException(msg);
+        limits.cpus = cores.getCores();
     }
 
-    std::string currentTime = base::Time::now().toString();
-    fs::path path(msTempDirBasename + "/" + currentTime + "_fd");
+    Process process(arguments, call.tempDir, limits);
+    try {
+        process.start();
+    } catch(const PlanGenerationException& e)
+    {
+        LOG_WARN("Planner %s: translator could not be started: %s", getName().c_str(), e.what());
+        return false;
+    }
 
-    if(!fs::exists(path))
+    boost::chrono::steady_clock::time_point deadline = boost::chrono::steady_clock::now() + boost::chrono::milliseconds((int)(1000. * timeout));
+    bool result = false;
+    while(!result && !token.isCancelled())
     {
-        if (!fs::create_directory(path))
+        double remaining = boost::chrono::duration<double>(deadline - boost::chrono::steady_clock::now()).count();
+        if(remaining <= 0)
         {
-            LOG_ERROR("Could not create directory: %s", path.string().c_str());
+            break;
         }
+        result = process.waitFor(std::min(remaining, msCancellationPollInterval / 1000.));
     }
-    mTempDir = path.string();
-    mTimeout = timeout;
-    prepare(problem, actionDescriptions, domainDescriptions);
-    PlanCandidates planCandidates = generatePlanCandidates();
-    return planCandidates;
+
+    if(!result)
+    {
+        process.kill();
+        return false;
+    }
+    // The translator writes output.sas into its working directory
+    std::string translated = call.tempDir + "/output.sas";
+    if(translated != filename && boost::filesystem::exists(translated))
+    {
+        boost::system::error_code ec;
+        boost::filesystem::rename(translated, filename, ec);
+    }
+    return process.getExitStatus() == 0 && boost::filesystem::exists(filename);
 }
 
-PlanCandidates Planner::generatePlanCandidates()
+PlanCandidates Planner::generatePlanCandidates(const PlannerCall& call, const std::string& executable, const CancellationToken& token, const PlanCallback& callback, const std::string& translatedFilename)
 {
-    chdir(mTempDir.c_str());
-    std::string cmd;
+    std::vector<std::string> arguments;
+    arguments.push_back(executable);
     if(mAlias.empty())
     {
         LOG_WARN("Fast-Downward is being used with no alias!!");
-        cmd = "fast_downward-planner " + mDomainFilename + " " + mProblemFilename;
     }
     else
     {
-        cmd = "fast_downward-planner --alias " + mAlias + " " + mDomainFilename + " " + mProblemFilename;
+        arguments.push_back("--alias");
+        arguments.push_back(mAlias);
+    }
+    if(translatedFilename.empty())
+    {
+        arguments.push_back(call.domainFilename);
+        arguments.push_back(call.problemFilename);
+    } else {
+        arguments.push_back(translatedFilename);
+    }
+
+    PlanCandidates planCandidates;
+    if(call.timeout > 0 && !token.isCancelled())
+    {
+        planCandidates = generateCandidates(arguments, call.tempDir, call.resultFilename, call.timeout, getName(), token, callback);
     }
-    std::list<std::string> pattern;
-    pattern.push_back("fast_downward");
-    PlanCandidates planCandidates = generateCandidates(cmd, mTempDir, mResultFilename, pattern, mTimeout, getName());
 
     std::list<std::string> files;
     files.push_back(std::string("output"));
     files.push_back(std::string("output.sas"));
 
-    cleanup(mTempDir, files);
+    cleanup(call, files);
     return planCandidates;
 }
 
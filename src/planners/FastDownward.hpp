@@ -2,6 +2,9 @@
 #define PDDL_PLANNER_FASTDOWNWARD_HPP
 
 #include <pddl_planner/PDDLPlannerInterface.hpp>
+#include <pddl_planner/TranslationCache.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 
 namespace pddl_planner
 {
@@ -46,17 +49,43 @@ namespace fast_downward
         /**
          * Create plan candidates for the given pddl planning problem
          */
-        PlanCandidates plan(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout);
+        PlanCandidates plan(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout, const CancellationToken& token = CancellationToken(), const PlanCallback& callback = PlanCallback());
+
+        /**
+         * Set the cache for translated tasks -- when set, the translator runs once per
+         * domain and problem and the search of subsequent calls starts from the cached
+         * output.sas, which requires an alias
+         * \param cache Translation cache, an empty pointer disables caching
+         */
+        void setTranslationCache(const boost::shared_ptr<TranslationCache>& cache);
+
+        /**
+         * Get the cache for translated tasks
+         * \return translation cache, or an empty pointer if caching is disabled
+         */
+        boost::shared_ptr<TranslationCache> getTranslationCache() const;
 
     private:
+        /**
+         * Run the translator of the planner call, i.e. translate domain and problem into the given file
+         * \param timeout Maximum time in seconds for the translation
+         * \return true if the translation succeeded, false otherwise
+         */
+        bool translate(const PlannerCall& call, const std::string& executable, double timeout, const CancellationToken& token, const std::string& filename);
+
         /**
          * Generate the plan candidates for the given problem
          * There is no priority in the order of candidates
+         * \param call Files and settings of this planner call
+         * \param executable Absolute path of the planner's executable
          * \throws PlanGenerationException
          */
-        PlanCandidates generatePlanCandidates();
-        
+        PlanCandidates generatePlanCandidates(const PlannerCall& call, const std::string& executable, const CancellationToken& token, const PlanCallback& callback, const std::string& translatedFilename = "");
+
         std::string mAlias;
+
+        mutable boost::mutex mTranslationCacheMutex;
+        boost::shared_ptr<TranslationCache> mTranslationCache;
     };
 } 
 }
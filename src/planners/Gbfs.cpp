@@ -0,0 +1,142 @@
+#include <pddl_planner/planners/Gbfs.hpp>
+#include <pddl_planner/planners/GroundTask.hpp>
+#include <pddl_planner/representation/Parser.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/unordered_map.hpp>
+#include <base/logging.h>
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+namespace pddl_planner
+{
+namespace gbfs
+{
+
+// Number of expansions after which timeout and cancellation are checked
+static const size_t CHECK_INTERVAL = 64;
+
+PlanCandidates Planner::plan(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout, const CancellationToken& token, const PlanCallback& callback)
+{
+    LOG_DEBUG("Planner called with problem: '%s'", problem.c_str());
+    try {
+        representation::Domain domain = representation::Parser::parseDomain(domainDescriptions + "\n" + actionDescriptions);
+        representation::Problem parsedProblem = representation::Parser::parseProblem(problem, domain);
+        return plan(parsedProblem, timeout, token, callback);
+    } catch(const representation::ParseError& e)
+    {
+        std::string msg = getName() + ": " + e.what();
+        LOG_ERROR("%s", msg.c_str());
+        throw PlanGenerationException(msg);
+    }
+}
+
+PlanCandidates Planner::plan(const representation::Problem& problem, double timeout, const CancellationToken& token, const PlanCallback& callback)
+{
+    typedef boost::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + boost::chrono::duration_cast<Clock::duration>(boost::chrono::duration<double>(timeout));
+
+    PlanCandidates planCandidates;
+    PlannerStatistics& statistics = planCandidates.statistics;
+    GroundTask task(problem);
+    LOG_DEBUG("%s: grounded %d atoms and %d actions", getName().c_str(), (int) task.getAtoms().size(), (int) task.getActions().size());
+
+    struct Node
+    {
+        int parent;
+        int action;
+    };
+
+    std::vector<State> states;
+    std::vector<Node> nodes;
+    boost::unordered_map<State, int> visited;
+    // Open list ordered by heuristic value, ties are broken in FIFO order
+    typedef std::pair<int, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > open;
+
+    int h = task.computeFFHeuristic(task.getInitialState());
+    states.push_back(task.getInitialState());
+    nodes.push_back(Node { -1, -1 });
+    visited[task.getInitialState()] = 0;
+    if(h != GroundTask::INFINITE_COST)
+    {
+        open.push(Entry(h, 0));
+    }
+
+    size_t expansions = 0;
+    while(!open.empty())
+    {
+        if(++expansions % CHECK_INTERVAL == 0)
+        {
+            if(token.isCancelled())
+            {
+                LOG_INFO("Planner %s has been cancelled", getName().c_str());
+                statistics.cancelled = true;
+                statistics.wallTime = boost::chrono::duration<double>(Clock::now() - start).count();
+                return planCandidates;
+            }
+            if(Clock::now() > deadline)
+            {
+                LOG_INFO("Planner %s timed out after %d expansions", getName().c_str(), (int) expansions);
+                statistics.timedOut = true;
+                statistics.wallTime = boost::chrono::duration<double>(Clock::now() - start).count();
+                return planCandidates;
+            }
+        }
+
+        int index = open.top().second;
+        open.pop();
+        if(task.isGoal(states[index]))
+        {
+            Plan plan;
+            for(int n = index; nodes[n].parent >= 0; n = nodes[n].parent)
+            {
+                plan.addAction(task.getActions()[nodes[n].action].action);
+            }
+            std::reverse(plan.action_sequence.begin(), plan.action_sequence.end());
+            LOG_INFO("Planner %s found plan of length %d after %d expansions", getName().c_str(), (int) plan.action_sequence.size(), (int) expansions);
+
+            planCandidates.addPlan(plan);
+            planCandidates.updateStatistics();
+            statistics.wallTime = boost::chrono::duration<double>(Clock::now() - start).count();
+            statistics.timeToFirstPlan = statistics.wallTime;
+            if(callback)
+            {
+                callback(plan);
+            }
+            return planCandidates;
+        }
+
+        for(size_t a = 0; a < task.getActions().size(); ++a)
+        {
+            if(!task.isApplicable(a, states[index]))
+            {
+                continue;
+            }
+
+            State successor = task.apply(a, states[index]);
+            if(visited.count(successor))
+            {
+                continue;
+            }
+
+            int successorIndex = states.size();
+            visited[successor] = successorIndex;
+            nodes.push_back(Node { index, (int) a });
+            h = task.computeFFHeuristic(successor);
+            states.push_back(successor);
+            if(h != GroundTask::INFINITE_COST)
+            {
+                open.push(Entry(h, successorIndex));
+            }
+        }
+    }
+
+    LOG_INFO("Planner %s: problem '%s' is unsolvable", getName().c_str(), problem.name.c_str());
+    statistics.wallTime = boost::chrono::duration<double>(Clock::now() - start).count();
+    return planCandidates;
+}
+
+}
+}
@@ -0,0 +1,63 @@
+#ifndef PDDL_PLANNER_GBFS_HPP
+#define PDDL_PLANNER_GBFS_HPP
+
+#include <pddl_planner/PDDLPlannerInterface.hpp>
+#include <pddl_planner/representation/Problem.hpp>
+
+namespace pddl_planner
+{
+namespace gbfs
+{
+    /**
+     * In-process planner, which grounds the problem and runs a greedy best-first search
+     * guided by the FF heuristic
+     * \details No files are written and no process is started, so that small problems are
+     * solved without the startup costs of the external planners. The supported subset of
+     * PDDL is described in GroundTask
+     */
+    class Planner : public PDDLPlannerInterface
+    {
+    public:
+        /**
+         * Get name of this planner implementation
+         * \return Name of planner
+         */
+        std::string getName() const { return "GBFS"; }
+
+        /**
+         * The planner does not use an executable
+         * \return empty string
+         */
+        std::string getCmd() const { return ""; }
+
+        /**
+         * Get version of this planner implementation
+         * \return version as int
+         */
+        int getVersion() const { return 1; }
+
+        /**
+         * The planner is always available, since it runs in-process
+         * \return true
+         */
+        bool isAvailable() const { return true; }
+
+        /**
+         * Create plan candidates for the given pddl planning problem
+         * The descriptions are parsed and solved in-process
+         * \throws PlanGenerationException if the descriptions are invalid or use unsupported features
+         */
+        PlanCandidates plan(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout, const CancellationToken& token = CancellationToken(), const PlanCallback& callback = PlanCallback());
+
+        /**
+         * Create plan candidates for the given problem, which refers to its domain
+         * \return plan candidates, which are empty if the problem is unsolvable, the timeout
+         * expired or the call has been cancelled
+         * \throws PlanGenerationException if the problem uses unsupported features
+         */
+        PlanCandidates plan(const representation::Problem& problem, double timeout, const CancellationToken& token = CancellationToken(), const PlanCallback& callback = PlanCallback());
+    };
+}
+}
+
+#endif // PDDL_PLANNER_GBFS_HPP
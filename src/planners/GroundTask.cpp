@@ -0,0 +1,736 @@
+#include <pddl_planner/planners/GroundTask.hpp>
+#include <boost/foreach.hpp>
+#include <boost/unordered_set.hpp>
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace pddl_planner
+{
+namespace gbfs
+{
+
+using representation::Expression;
+using representation::Label;
+using representation::Type;
+
+const int GroundTask::INFINITE_COST = std::numeric_limits<int>::max();
+
+namespace
+{
+    typedef std::map<Label, Label> Binding;
+
+    Formula makeNot(const Formula& formula)
+    {
+        switch(formula.type)
+        {
+            case Formula::TRUE_FORMULA:
+                return Formula(Formula::FALSE_FORMULA);
+            case Formula::FALSE_FORMULA:
+                return Formula(Formula::TRUE_FORMULA);
+            case Formula::NOT:
+                return formula.children.front();
+            default:
+                break;
+        }
+        Formula negation(Formula::NOT);
+        negation.children.push_back(formula);
+        return negation;
+    }
+
+    /**
+     * Create a conjunction or disjunction, which is simplified and flattened
+     */
+    Formula makeJunction(Formula::Type type, const std::vector<Formula>& children)
+    {
+        Formula::Type neutral = type == Formula::AND ? Formula::TRUE_FORMULA : Formula::FALSE_FORMULA;
+        Formula::Type dominant = type == Formula::AND ? Formula::FALSE_FORMULA : Formula::TRUE_FORMULA;
+
+        Formula junction(type);
+        BOOST_FOREACH(const Formula& child, children)
+        {
+            if(child.type == dominant)
+            {
+                return Formula(dominant);
+            } else if(child.type == neutral)
+            {
+                continue;
+            } else if(child.type == type)
+            {
+                junction.children.insert(junction.children.end(), child.children.begin(), child.children.end());
+            } else {
+                junction.children.push_back(child);
+            }
+        }
+
+        if(junction.children.empty())
+        {
+            return Formula(neutral);
+        } else if(junction.children.size() == 1)
+        {
+            return junction.children.front();
+        }
+        return junction;
+    }
+
+    bool isNumericEffect(const Label& label)
+    {
+        return label == "increase" || label == "decrease" || label == "assign" || label == "scale-up" || label == "scale-down";
+    }
+
+    int addCosts(int a, int b)
+    {
+        if(a == GroundTask::INFINITE_COST || b == GroundTask::INFINITE_COST)
+        {
+            return GroundTask::INFINITE_COST;
+        }
+        return a + b;
+    }
+
+    int computeCost(const Formula& formula, const std::vector<int>& costs)
+    {
+        switch(formula.type)
+        {
+            case Formula::TRUE_FORMULA:
+            case Formula::NOT:
+                return 0;
+            case Formula::FALSE_FORMULA:
+                return GroundTask::INFINITE_COST;
+            case Formula::ATOM:
+                return costs[formula.atom];
+            case Formula::AND:
+            {
+                int cost = 0;
+                BOOST_FOREACH(const Formula& child, formula.children)
+                {
+                    cost = addCosts(cost, computeCost(child, costs));
+                }
+                return cost;
+            }
+            case Formula::OR:
+            {
+                int cost = GroundTask::INFINITE_COST;
+                BOOST_FOREACH(const Formula& child, formula.children)
+                {
+                    cost = std::min(cost, computeCost(child, costs));
+                }
+                return cost;
+            }
+        }
+        return GroundTask::INFINITE_COST;
+    }
+
+    /**
+     * Mark the atoms which have to be achieved to satisfy a formula in the relaxed task
+     */
+    void collectRequiredAtoms(const Formula& formula, const std::vector<int>& costs, std::vector<bool>& marked, std::vector<int>& open)
+    {
+        switch(formula.type)
+        {
+            case Formula::ATOM:
+                if(costs[formula.atom] > 0 && !marked[formula.atom])
+                {
+                    marked[formula.atom] = true;
+                    open.push_back(formula.atom);
+                }
+                break;
+            case Formula::AND:
+                BOOST_FOREACH(const Formula& child, formula.children)
+                {
+                    collectRequiredAtoms(child, costs, marked, open);
+                }
+                break;
+            case Formula::OR:
+            {
+                const Formula* cheapest = NULL;
+                int cheapestCost = GroundTask::INFINITE_COST;
+                BOOST_FOREACH(const Formula& child, formula.children)
+                {
+                    int cost = computeCost(child, costs);
+                    if(!cheapest || cost < cheapestCost)
+                    {
+                        cheapest = &child;
+                        cheapestCost = cost;
+                    }
+                }
+                if(cheapest)
+                {
+                    collectRequiredAtoms(*cheapest, costs, marked, open);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * Instantiates the actions, the goal and the initial state of a problem
+ */
+class Grounder
+{
+public:
+    Grounder(const representation::Problem& problem, GroundTask& task)
+        : mProblem(problem)
+        , mDomain(problem.domain)
+        , mTask(task)
+    {}
+
+    void ground()
+    {
+        BOOST_FOREACH(const representation::Constant& constant, mDomain.constants)
+        {
+            mObjects.push_back(constant);
+        }
+        BOOST_FOREACH(const representation::TypedItem& object, mProblem.objects)
+        {
+            mObjects.push_back(object);
+        }
+
+        BOOST_FOREACH(const representation::Action& action, mDomain.actions)
+        {
+            BOOST_FOREACH(const Expression& effect, action.effects)
+            {
+                collectModifiedPredicates(effect);
+            }
+        }
+
+        std::vector<std::string> fluentFacts;
+        BOOST_FOREACH(const Expression& fact, mProblem.status)
+        {
+            if(fact.label == "=")
+            {
+                // Initial values of functions
+                continue;
+            }
+            if(!mDomain.isPredicate(fact.label))
+            {
+                throw PlanGenerationException("GBFS: unsupported initial fact '" + fact.toLISP() + "'");
+            }
+
+            std::string key = getAtomKey(fact, Binding());
+            if(mModifiedPredicates.count(fact.label))
+            {
+                fluentFacts.push_back(key);
+            } else {
+                mStaticFacts.insert(key);
+            }
+        }
+
+        BOOST_FOREACH(const representation::Action& action, mDomain.actions)
+        {
+            groundAction(action);
+        }
+
+        if(mProblem.goal.isNull())
+        {
+            throw PlanGenerationException("GBFS: problem '" + mProblem.name + "' has no goal");
+        }
+        Binding binding;
+        mTask.mGoal = groundFormula(mProblem.goal, binding);
+
+        std::vector<int> initialAtoms;
+        BOOST_FOREACH(const std::string& key, fluentFacts)
+        {
+            initialAtoms.push_back(getAtom(key));
+        }
+        mTask.mInitialState.assign((mTask.mAtoms.size() + 63) / 64, 0);
+        BOOST_FOREACH(int atom, initialAtoms)
+        {
+            mTask.mInitialState[atom / 64] |= uint64_t(1) << (atom % 64);
+        }
+    }
+
+private:
+    void collectModifiedPredicates(const Expression& effect)
+    {
+        if(effect.label == "and" || effect.label == "not")
+        {
+            BOOST_FOREACH(const representation::ExpressionPtr& e, effect.parameters)
+            {
+                collectModifiedPredicates(*e);
+            }
+        } else if(Expression::isQuantor(effect.label))
+        {
+            collectModifiedPredicates(*effect.parameters.front());
+        } else if(effect.label == "when")
+        {
+            if(effect.parameters.size() != 2)
+            {
+                throw PlanGenerationException("GBFS: invalid conditional effect '" + effect.toLISP() + "'");
+            }
+            collectModifiedPredicates(*effect.parameters.back());
+        } else if(!isNumericEffect(effect.label))
+        {
+            mModifiedPredicates.insert(effect.label);
+        }
+    }
+
+    const std::vector<Label>& getObjects(const Type& type)
+    {
+        std::map<Type, std::vector<Label> >::const_iterator cit = mObjectsByType.find(type);
+        if(cit != mObjectsByType.end())
+        {
+            return cit->second;
+        }
+
+        std::vector<Label>& objects = mObjectsByType[type];
+        BOOST_FOREACH(const representation::TypedItem& object, mObjects)
+        {
+            if(type.empty() || type == "object" || object.type == type)
+            {
+                objects.push_back(object.label);
+            }
+        }
+        return objects;
+    }
+
+    Label resolve(const Expression& term, const Binding& binding) const
+    {
+        if(!term.isAtomic())
+        {
+            throw PlanGenerationException("GBFS: unsupported term '" + term.toLISP() + "'");
+        }
+        if(representation::VariableManager::isVariable(term.label))
+        {
+            Binding::const_iterator cit = binding.find(term.label);
+            if(cit == binding.end())
+            {
+                throw PlanGenerationException("GBFS: unbound variable '" + term.label + "'");
+            }
+            return cit->second;
+        }
+        return term.label;
+    }
+
+    std::string getAtomKey(const Expression& e, const Binding& binding) const
+    {
+        std::string key = e.label;
+        BOOST_FOREACH(const representation::ExpressionPtr& parameter, e.parameters)
+        {
+            key += " " + resolve(*parameter, binding);
+        }
+        return key;
+    }
+
+    int getAtom(const std::string& key)
+    {
+        boost::unordered_map<std::string, int>::const_iterator cit = mTask.mAtomIndex.find(key);
+        if(cit != mTask.mAtomIndex.end())
+        {
+            return cit->second;
+        }
+        int atom = mTask.mAtoms.size();
+        mTask.mAtoms.push_back(key);
+        mTask.mAtomIndex[key] = atom;
+        return atom;
+    }
+
+    /**
+     * Bind a quantified variable to each object of its type and combine the results
+     */
+    template<typename Function>
+    void forEachObject(const Expression& quantified, Binding& binding, Function function)
+    {
+        const Label& variable = quantified.typedItem.label;
+        Binding::const_iterator cit = binding.find(variable);
+        bool shadowed = cit != binding.end();
+        Label previous = shadowed ? cit->second : Label();
+
+        const std::vector<Label>& objects = getObjects(quantified.typedItem.type);
+        BOOST_FOREACH(const Label& object, objects)
+        {
+            binding[variable] = object;
+            function(object);
+        }
+
+        if(shadowed)
+        {
+            binding[variable] = previous;
+        } else {
+            binding.erase(variable);
+        }
+    }
+
+    Formula groundFormula(const Expression& e, Binding& binding)
+    {
+        if(e.label == "and" || e.label == "or")
+        {
+            std::vector<Formula> children;
+            BOOST_FOREACH(const representation::ExpressionPtr& child, e.parameters)
+            {
+                children.push_back(groundFormula(*child, binding));
+            }
+            return makeJunction(e.label == "and" ? Formula::AND : Formula::OR, children);
+        } else if(e.label == "not")
+        {
+            if(e.parameters.size() != 1)
+            {
+                throw PlanGenerationException("GBFS: invalid negation '" + e.toLISP() + "'");
+            }
+            return makeNot(groundFormula(*e.parameters.front(), binding));
+        } else if(e.label == "imply")
+        {
+            if(e.parameters.size() != 2)
+            {
+                throw PlanGenerationException("GBFS: invalid implication '" + e.toLISP() + "'");
+            }
+            std::vector<Formula> children;
+            children.push_back(makeNot(groundFormula(*e.parameters.front(), binding)));
+            children.push_back(groundFormula(*e.parameters.back(), binding));
+            return makeJunction(Formula::OR, children);
+        } else if(e.label == "=")
+        {
+            if(e.parameters.size() != 2)
+            {
+                throw PlanGenerationException("GBFS: invalid equality '" + e.toLISP() + "'");
+            }
+            bool equal = resolve(*e.parameters.front(), binding) == resolve(*e.parameters.back(), binding);
+            return Formula(equal ? Formula::TRUE_FORMULA : Formula::FALSE_FORMULA);
+        } else if(Expression::isQuantor(e.label))
+        {
+            std::vector<Formula> children;
+            const Expression& body = *e.parameters.front();
+            forEachObject(e, binding, [&](const Label&) { children.push_back(groundFormula(body, binding)); });
+            return makeJunction(e.label == "forall" ? Formula::AND : Formula::OR, children);
+        }
+
+        if(!mDomain.isPredicate(e.label))
+        {
+            throw PlanGenerationException("GBFS: unsupported condition '" + e.toLISP() + "'");
+        }
+
+        std::string key = getAtomKey(e, binding);
+        if(!mModifiedPredicates.count(e.label))
+        {
+            return Formula(mStaticFacts.count(key) ? Formula::TRUE_FORMULA : Formula::FALSE_FORMULA);
+        }
+        return Formula(Formula::ATOM, getAtom(key));
+    }
+
+    /**
+     * Ground an effect, where atoms are added to the conditional effect with the given index
+     */
+    void groundEffect(const Expression& e, Binding& binding, size_t target, std::vector<ConditionalEffect>& effects)
+    {
+        if(e.label == "and")
+        {
+            BOOST_FOREACH(const representation::ExpressionPtr& child, e.parameters)
+            {
+                groundEffect(*child, binding, target, effects);
+            }
+        } else if(Expression::isQuantor(e.label))
+        {
+            if(e.label != "forall")
+            {
+                throw PlanGenerationException("GBFS: invalid effect '" + e.toLISP() + "'");
+            }
+            const Expression& body = *e.parameters.front();
+            forEachObject(e, binding, [&](const Label&) { groundEffect(body, binding, target, effects); });
+        } else if(e.label == "when")
+        {
+            std::vector<Formula> conditions;
+            conditions.push_back(effects[target].condition);
+            conditions.push_back(groundFormula(*e.parameters.front(), binding));
+            Formula condition = makeJunction(Formula::AND, conditions);
+            if(!condition.isFalse())
+            {
+                effects.push_back(ConditionalEffect());
+                effects.back().condition = condition;
+                groundEffect(*e.parameters.back(), binding, effects.size() - 1, effects);
+            }
+        } else if(isNumericEffect(e.label))
+        {
+            if(e.parameters.empty() || e.parameters.front()->label != "total-cost")
+            {
+                throw PlanGenerationException("GBFS: unsupported numeric effect '" + e.toLISP() + "'");
+            }
+        } else {
+            bool isDelete = e.label == "not";
+            const Expression& atom = isDelete ? *e.parameters.front() : e;
+            if(!mDomain.isPredicate(atom.label))
+            {
+                throw PlanGenerationException("GBFS: unsupported effect '" + e.toLISP() + "'");
+            }
+
+            int atomIndex = getAtom(getAtomKey(atom, binding));
+            if(isDelete)
+            {
+                effects[target].deleteEffects.push_back(atomIndex);
+            } else {
+                effects[target].addEffects.push_back(atomIndex);
+            }
+        }
+    }
+
+    static void collectVariables(const Expression& e, std::set<Label>& variables)
+    {
+        if(e.isAtomic() && representation::VariableManager::isVariable(e.label))
+        {
+            variables.insert(e.label);
+        }
+        BOOST_FOREACH(const representation::ExpressionPtr& child, e.parameters)
+        {
+            collectVariables(*child, variables);
+        }
+    }
+
+    static void collectConjuncts(const Expression& e, std::vector<const Expression*>& conjuncts)
+    {
+        if(e.label == "and")
+        {
+            BOOST_FOREACH(const representation::ExpressionPtr& child, e.parameters)
+            {
+                collectConjuncts(*child, conjuncts);
+            }
+        } else {
+            conjuncts.push_back(&e);
+        }
+    }
+
+    void groundAction(const representation::Action& action)
+    {
+        // Conjuncts of the precondition are checked as soon as their variables are bound,
+        // so that static preconditions prune the instantiation early
+        std::vector<const Expression*> conjuncts;
+        BOOST_FOREACH(const Expression& precondition, action.preconditions)
+        {
+            collectConjuncts(precondition, conjuncts);
+        }
+
+        std::vector< std::vector<const Expression*> > conjunctsByDepth(action.arguments.size() + 1);
+        BOOST_FOREACH(const Expression* conjunct, conjuncts)
+        {
+            std::set<Label> variables;
+            collectVariables(*conjunct, variables);
+            size_t depth = 0;
+            for(size_t i = 0; i < action.arguments.size(); ++i)
+            {
+                if(variables.count(action.arguments[i].label))
+                {
+                    depth = i + 1;
+                }
+            }
+            conjunctsByDepth[depth].push_back(conjunct);
+        }
+
+        Binding binding;
+        std::vector<Formula> preconditions;
+        bindArguments(action, 0, conjunctsByDepth, binding, preconditions);
+    }
+
+    void bindArguments(const representation::Action& action, size_t depth, const std::vector< std::vector<const Expression*> >& conjunctsByDepth, Binding& binding, std::vector<Formula>& preconditions)
+    {
+        size_t size = preconditions.size();
+        BOOST_FOREACH(const Expression* conjunct, conjunctsByDepth[depth])
+        {
+            Formula formula = groundFormula(*conjunct, binding);
+            if(formula.isFalse())
+            {
+                preconditions.resize(size);
+                return;
+            }
+            preconditions.push_back(formula);
+        }
+
+        if(depth == action.arguments.size())
+        {
+            GroundAction groundAction;
+            groundAction.action.name = action.label;
+            BOOST_FOREACH(const representation::TypedItem& argument, action.arguments)
+            {
+                groundAction.action.addArgument(binding[argument.label]);
+            }
+            groundAction.precondition = makeJunction(Formula::AND, preconditions);
+
+            // The first effect collects the unconditional effects
+            std::vector<ConditionalEffect> effects(1);
+            BOOST_FOREACH(const Expression& effect, action.effects)
+            {
+                groundEffect(effect, binding, 0, effects);
+            }
+            BOOST_FOREACH(const ConditionalEffect& effect, effects)
+            {
+                if(!effect.addEffects.empty() || !effect.deleteEffects.empty())
+                {
+                    groundAction.effects.push_back(effect);
+                }
+            }
+            mTask.mActions.push_back(groundAction);
+        } else {
+            const representation::TypedItem& argument = action.arguments[depth];
+            const std::vector<Label>& objects = getObjects(argument.type);
+            BOOST_FOREACH(const Label& object, objects)
+            {
+                binding[argument.label] = object;
+                bindArguments(action, depth + 1, conjunctsByDepth, binding, preconditions);
+            }
+            binding.erase(argument.label);
+        }
+        preconditions.resize(size);
+    }
+
+    const representation::Problem& mProblem;
+    const representation::Domain& mDomain;
+    GroundTask& mTask;
+
+    representation::TypedItemList mObjects;
+    std::map<Type, std::vector<Label> > mObjectsByType;
+    std::set<Label> mModifiedPredicates;
+    boost::unordered_set<std::string> mStaticFacts;
+};
+
+GroundTask::GroundTask(const representation::Problem& problem)
+{
+    Grounder grounder(problem, *this);
+    grounder.ground();
+}
+
+bool GroundTask::evaluate(const Formula& formula, const State& state)
+{
+    switch(formula.type)
+    {
+        case Formula::TRUE_FORMULA:
+            return true;
+        case Formula::FALSE_FORMULA:
+            return false;
+        case Formula::ATOM:
+            return holds(state, formula.atom);
+        case Formula::NOT:
+            return !evaluate(formula.children.front(), state);
+        case Formula::AND:
+            BOOST_FOREACH(const Formula& child, formula.children)
+            {
+                if(!evaluate(child, state))
+                {
+                    return false;
+                }
+            }
+            return true;
+        case Formula::OR:
+            BOOST_FOREACH(const Formula& child, formula.children)
+            {
+                if(evaluate(child, state))
+                {
+                    return true;
+                }
+            }
+            return false;
+    }
+    return false;
+}
+
+State GroundTask::apply(size_t action, const State& state) const
+{
+    const std::vector<ConditionalEffect>& effects = mActions[action].effects;
+    std::vector<const ConditionalEffect*> activeEffects;
+    BOOST_FOREACH(const ConditionalEffect& effect, effects)
+    {
+        if(evaluate(effect.condition, state))
+        {
+            activeEffects.push_back(&effect);
+        }
+    }
+
+    State successor = state;
+    BOOST_FOREACH(const ConditionalEffect* effect, activeEffects)
+    {
+        BOOST_FOREACH(int atom, effect->deleteEffects)
+        {
+            successor[atom / 64] &= ~(uint64_t(1) << (atom % 64));
+        }
+    }
+    BOOST_FOREACH(const ConditionalEffect* effect, activeEffects)
+    {
+        BOOST_FOREACH(int atom, effect->addEffects)
+        {
+            successor[atom / 64] |= uint64_t(1) << (atom % 64);
+        }
+    }
+    return successor;
+}
+
+void GroundTask::computeRelaxedCosts(const State& state, std::vector<int>& costs, std::vector<std::pair<int,int> >& supporters) const
+{
+    costs.assign(mAtoms.size(), INFINITE_COST);
+    supporters.assign(mAtoms.size(), std::make_pair(-1, -1));
+    for(size_t atom = 0; atom < mAtoms.size(); ++atom)
+    {
+        if(holds(state, atom))
+        {
+            costs[atom] = 0;
+        }
+    }
+
+    bool changed = true;
+    while(changed)
+    {
+        changed = false;
+        for(size_t a = 0; a < mActions.size(); ++a)
+        {
+            const GroundAction& action = mActions[a];
+            int preconditionCost = computeCost(action.precondition, costs);
+            if(preconditionCost == INFINITE_COST)
+            {
+                continue;
+            }
+
+            for(size_t e = 0; e < action.effects.size(); ++e)
+            {
+                const ConditionalEffect& effect = action.effects[e];
+                int cost = addCosts(addCosts(preconditionCost, computeCost(effect.condition, costs)), 1);
+                if(cost == INFINITE_COST)
+                {
+                    continue;
+                }
+                BOOST_FOREACH(int atom, effect.addEffects)
+                {
+                    if(cost < costs[atom])
+                    {
+                        costs[atom] = cost;
+                        supporters[atom] = std::make_pair(a, e);
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+}
+
+int GroundTask::computeFFHeuristic(const State& state) const
+{
+    std::vector<int> costs;
+    std::vector<std::pair<int,int> > supporters;
+    computeRelaxedCosts(state, costs, supporters);
+    if(computeCost(mGoal, costs) == INFINITE_COST)
+    {
+        return INFINITE_COST;
+    }
+
+    std::vector<bool> marked(mAtoms.size(), false);
+    std::vector<bool> usedActions(mActions.size(), false);
+    std::vector<int> open;
+    collectRequiredAtoms(mGoal, costs, marked, open);
+
+    int relaxedPlanLength = 0;
+    while(!open.empty())
+    {
+        int atom = open.back();
+        open.pop_back();
+
+        const std::pair<int,int>& supporter = supporters[atom];
+        const GroundAction& action = mActions[supporter.first];
+        if(!usedActions[supporter.first])
+        {
+            usedActions[supporter.first] = true;
+            ++relaxedPlanLength;
+            collectRequiredAtoms(action.precondition, costs, marked, open);
+        }
+        collectRequiredAtoms(action.effects[supporter.second].condition, costs, marked, open);
+    }
+    return relaxedPlanLength;
+}
+
+} // end namespace gbfs
+} // end namespace pddl_planner
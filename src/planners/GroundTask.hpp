@@ -0,0 +1,136 @@
+#ifndef PDDL_PLANNER_GROUND_TASK_HPP
+#define PDDL_PLANNER_GROUND_TASK_HPP
+
+#include <pddl_planner/PDDLPlannerTypes.hpp>
+#include <pddl_planner/representation/Problem.hpp>
+#include <boost/unordered_map.hpp>
+#include <limits>
+
+namespace pddl_planner
+{
+namespace gbfs
+{
+    // State as a bitset over the ground atoms of a task
+    typedef std::vector<uint64_t> State;
+
+    /**
+     * \struct Formula
+     * \brief Ground (and simplified) precondition, condition or goal
+     */
+    struct Formula
+    {
+        enum Type { TRUE_FORMULA, FALSE_FORMULA, ATOM, NOT, AND, OR };
+
+        Type type;
+        // Index of the ground atom for type ATOM
+        int atom;
+        std::vector<Formula> children;
+
+        Formula(Type type = TRUE_FORMULA, int atom = -1)
+            : type(type)
+            , atom(atom)
+        {}
+
+        bool isTrue() const { return type == TRUE_FORMULA; }
+        bool isFalse() const { return type == FALSE_FORMULA; }
+    };
+
+    /**
+     * \struct ConditionalEffect
+     * \brief Atoms added and deleted when the condition holds in the state the action is applied to
+     */
+    struct ConditionalEffect
+    {
+        Formula condition;
+        std::vector<int> addEffects;
+        std::vector<int> deleteEffects;
+    };
+
+    /**
+     * \struct GroundAction
+     * \brief Action with all parameters bound to objects
+     */
+    struct GroundAction
+    {
+        Action action;
+        Formula precondition;
+        std::vector<ConditionalEffect> effects;
+    };
+
+    /**
+     * \class GroundTask
+     * \brief Grounded representation of a planning problem
+     * \details Grounding instantiates all actions for all objects of matching types, while
+     * atoms of static predicates, i.e. predicates which no action modifies, are evaluated
+     * against the initial state right away. Supported are typed STRIPS extended by negative,
+     * disjunctive and quantified preconditions, equality and conditional effects. Types are
+     * matched exactly, since the domain representation does not keep the type hierarchy --
+     * 'object' matches all objects. Cost effects on 'total-cost' are ignored
+     */
+    class GroundTask
+    {
+    public:
+        static const int INFINITE_COST;
+
+        /**
+         * Ground the given problem
+         * \throws PlanGenerationException if the problem uses unsupported features
+         */
+        GroundTask(const representation::Problem& problem);
+
+        const std::vector<GroundAction>& getActions() const { return mActions; }
+
+        const std::vector<std::string>& getAtoms() const { return mAtoms; }
+
+        const State& getInitialState() const { return mInitialState; }
+
+        const Formula& getGoal() const { return mGoal; }
+
+        /**
+         * Test whether the given atom holds in a state
+         */
+        static bool holds(const State& state, int atom) { return state[atom / 64] & (uint64_t(1) << (atom % 64)); }
+
+        /**
+         * Evaluate a formula in a state
+         */
+        static bool evaluate(const Formula& formula, const State& state);
+
+        /**
+         * Test whether an action can be applied in a state
+         */
+        bool isApplicable(size_t action, const State& state) const { return evaluate(mActions[action].precondition, state); }
+
+        /**
+         * Apply an action to a state, where delete effects are applied before add effects
+         * \return successor state
+         */
+        State apply(size_t action, const State& state) const;
+
+        /**
+         * Test whether a state satisfies the goal
+         */
+        bool isGoal(const State& state) const { return evaluate(mGoal, state); }
+
+        /**
+         * Compute the FF heuristic, i.e. the number of actions of a relaxed plan extracted
+         * from the additive heuristic, where negative conditions are ignored
+         * \return heuristic value or INFINITE_COST if the goal is unreachable
+         */
+        int computeFFHeuristic(const State& state) const;
+
+    private:
+        void computeRelaxedCosts(const State& state, std::vector<int>& costs, std::vector<std::pair<int,int> >& supporters) const;
+
+        std::vector<std::string> mAtoms;
+        boost::unordered_map<std::string, int> mAtomIndex;
+        std::vector<GroundAction> mActions;
+        State mInitialState;
+        Formula mGoal;
+
+        friend class Grounder;
+    };
+
+} // end namespace gbfs
+} // end namespace pddl_planner
+#endif // PDDL_PLANNER_GROUND_TASK_HPP
@@ -45,15 +45,17 @@ namespace lama
         /**
          * Create plan candidates for the given pddl planning problem
          */
-        PlanCandidates plan(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout);
+        PlanCandidates plan(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout, const CancellationToken& token = CancellationToken(), const PlanCallback& callback = PlanCallback());
 
     private:
         /**
          * Generate the plan candidates for the given problem
          * There is no priority in the order of candidates
+         * \param call Files and settings of this planner call
+         * \param executable Absolute path of the planner's executable
          * \throws PlanGenerationException
          */
-        PlanCandidates generatePlanCandidates();
+        PlanCandidates generatePlanCandidates(const PlannerCall& call, const std::string& executable, const CancellationToken& token, const PlanCallback& callback);
     };
 }
 }
@@ -0,0 +1,192 @@
+#include <pddl_planner/planners/Remote.hpp>
+#include <pddl_planner/RemoteConnection.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <base/logging.h>
+#include <sstream>
+#include <limits>
+#include <cstdio>
+
+namespace pddl_planner
+{
+namespace remote
+{
+
+// Timeout in seconds for connecting to a worker
+static const double CONNECT_TIMEOUT = 1.0;
+// Time in seconds a worker may take beyond the timeout to report the end of a call
+static const double GRACE_PERIOD = 5.0;
+// Interval in seconds at which a running call checks for cancellation
+static const double POLL_INTERVAL = 0.01;
+
+Planner::Planner(const std::string& name, const std::string& remotePlanner, const std::vector<std::string>& endpoints)
+    : mName(name)
+    , mRemotePlanner(remotePlanner)
+    , mEndpoints(endpoints)
+    , mNextEndpoint(0)
+{}
+
+bool Planner::isAvailable() const
+{
+    std::vector<std::string>::const_iterator it = mEndpoints.begin();
+    for(; it != mEndpoints.end(); ++it)
+    {
+        if(queryQueueDepth(*it) >= 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int Planner::queryQueueDepth(const std::string& endpoint) const
+{
+    try {
+        RemoteConnection connection(endpoint, CONNECT_TIMEOUT);
+        connection.send("STATUS\n");
+        std::string line;
+        int depth;
+        if(connection.readLine(line, CONNECT_TIMEOUT) && 1 == sscanf(line.c_str(), "STATUS %d", &depth))
+        {
+            return depth;
+        }
+        LOG_WARN("%s: invalid status response of '%s'", mName.c_str(), endpoint.c_str());
+    } catch(const PlanGenerationException& e)
+    {
+        LOG_DEBUG("%s: %s", mName.c_str(), e.what());
+    }
+    return -1;
+}
+
+std::string Planner::selectEndpoint()
+{
+    size_t offset;
+    {
+        boost::unique_lock<boost::mutex> lock(mMutex);
+        offset = mNextEndpoint++;
+    }
+
+    std::string selected;
+    int minimumDepth = std::numeric_limits<int>::max();
+    for(size_t i = 0; i < mEndpoints.size(); ++i)
+    {
+        const std::string& endpoint = mEndpoints[(offset + i) % mEndpoints.size()];
+        int depth = queryQueueDepth(endpoint);
+        if(depth >= 0 && depth < minimumDepth)
+        {
+            minimumDepth = depth;
+            selected = endpoint;
+            if(depth == 0)
+            {
+                break;
+            }
+        }
+    }
+
+    if(selected.empty())
+    {
+        throw PlanGenerationException(mName + ": no worker is reachable");
+    }
+    return selected;
+}
+
+PlanCandidates Planner::plan(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout, const CancellationToken& token, const PlanCallback& callback)
+{
+    typedef boost::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + boost::chrono::duration_cast<Clock::duration>(boost::chrono::duration<double>(timeout + GRACE_PERIOD));
+
+    std::string endpoint = selectEndpoint();
+    LOG_INFO("%s: sending request to '%s'", mName.c_str(), endpoint.c_str());
+    RemoteConnection connection(endpoint, CONNECT_TIMEOUT);
+
+    std::stringstream request;
+    request << "PLAN " << mRemotePlanner << " " << timeout << " " << domainDescriptions.size()
+        << " " << actionDescriptions.size() << " " << problem.size() << "\n"
+        << domainDescriptions << actionDescriptions << problem;
+    connection.send(request.str());
+
+    PlanCandidates planCandidates;
+    PlannerStatistics& statistics = planCandidates.statistics;
+    bool cancelSent = false;
+    while(true)
+    {
+        if(!cancelSent && (token.isCancelled() || Clock::now() > deadline))
+        {
+            LOG_INFO("%s: cancelling request on '%s'", mName.c_str(), endpoint.c_str());
+            connection.send("CANCEL\n");
+            cancelSent = true;
+            // Give the worker time to report the plans it has found so far
+            deadline = Clock::now() + boost::chrono::duration_cast<Clock::duration>(boost::chrono::duration<double>(GRACE_PERIOD));
+        } else if(cancelSent && Clock::now() > deadline)
+        {
+            LOG_WARN("%s: worker '%s' did not finish the request", mName.c_str(), endpoint.c_str());
+            statistics.cancelled = token.isCancelled();
+            statistics.timedOut = !statistics.cancelled;
+            break;
+        }
+
+        std::string line;
+        if(!connection.readLine(line, POLL_INTERVAL))
+        {
+            continue;
+        }
+
+        size_t size;
+        double cost = -1.0;
+        if(sscanf(line.c_str(), "PLAN %zu %lf", &size, &cost) >= 1)
+        {
+            Plan plan;
+            plan.cost = cost;
+            for(size_t i = 0; i < size; ++i)
+            {
+                std::string actionLine;
+                if(!connection.readLine(actionLine, GRACE_PERIOD))
+                {
+                    throw PlanGenerationException(mName + ": incomplete plan from '" + endpoint + "'");
+                }
+                std::vector<std::string> tokens;
+                boost::algorithm::split(tokens, actionLine, boost::is_any_of(" \t"), boost::token_compress_on);
+                Action action(tokens[0]);
+                for(size_t t = 1; t < tokens.size(); ++t)
+                {
+                    action.addArgument(tokens[t]);
+                }
+                plan.addAction(action);
+            }
+
+            planCandidates.addPlan(plan);
+            if(statistics.timeToFirstPlan < 0)
+            {
+                statistics.timeToFirstPlan = boost::chrono::duration<double>(Clock::now() - start).count();
+            }
+            if(callback)
+            {
+                callback(plan);
+            }
+        } else if(line.compare(0, 5, "DONE ") == 0)
+        {
+            PlannerStatistics remoteStatistics = statistics;
+            if(RemoteConnection::decodeStatistics(line.substr(5), remoteStatistics))
+            {
+                statistics = remoteStatistics;
+            } else {
+                LOG_WARN("%s: invalid statistics '%s'", mName.c_str(), line.c_str());
+            }
+            break;
+        } else if(1 == sscanf(line.c_str(), "ERROR %zu", &size))
+        {
+            std::string message;
+            connection.readBytes(size, message, GRACE_PERIOD);
+            throw PlanGenerationException(mName + ": worker '" + endpoint + "' failed: " + message);
+        } else {
+            throw PlanGenerationException(mName + ": invalid response '" + line + "' from '" + endpoint + "'");
+        }
+    }
+
+    planCandidates.updateStatistics();
+    return planCandidates;
+}
+
+}
+}
@@ -0,0 +1,87 @@
+#ifndef PDDL_PLANNER_REMOTE_HPP
+#define PDDL_PLANNER_REMOTE_HPP
+
+#include <pddl_planner/PDDLPlannerInterface.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace pddl_planner
+{
+namespace remote
+{
+    /**
+     * Planner, which forwards its calls to a pool of PlanningServer daemons
+     * \details Each call is sent to the worker with the fewest active requests, plans are
+     * streamed back while the remote planner is still searching and cancelling the call
+     * cancels the remote request
+     */
+    class Planner : public PDDLPlannerInterface
+    {
+    public:
+        /**
+         * Constructor
+         * \param name Name under which this planner is registered
+         * \param remotePlanner Name of the planner which runs on the workers
+         * \param endpoints Addresses of the workers as 'host:port'
+         */
+        Planner(const std::string& name, const std::string& remotePlanner, const std::vector<std::string>& endpoints);
+
+        /**
+         * Get name of this planner implementation
+         * \return Name of planner
+         */
+        std::string getName() const { return mName; }
+
+        /**
+         * The planner does not use a local executable
+         * \return empty string
+         */
+        std::string getCmd() const { return ""; }
+
+        /**
+         * Get version of this planner implementation
+         * \return version as int
+         */
+        int getVersion() const { return 1; }
+
+        /**
+         * Check if at least one of the workers is reachable
+         * \return true if a worker answered, false otherwise
+         */
+        bool isAvailable() const;
+
+        /**
+         * The planner runs on the workers
+         * \return true
+         */
+        bool isRemote() const { return true; }
+
+        /**
+         * Create plan candidates for the given pddl planning problem on one of the workers
+         * \throws PlanGenerationException if no worker is reachable or the worker reports an error
+         */
+        PlanCandidates plan(const std::string& problem, const std::string& actionDescriptions, const std::string& domainDescriptions, double timeout, const CancellationToken& token = CancellationToken(), const PlanCallback& callback = PlanCallback());
+
+    private:
+        /**
+         * Ask a worker for the number of its active requests
+         * \return queue depth or -1 if the worker is not reachable
+         */
+        int queryQueueDepth(const std::string& endpoint) const;
+
+        /**
+         * Select the worker with the smallest queue depth, ties are resolved round-robin
+         * \throws PlanGenerationException if no worker is reachable
+         */
+        std::string selectEndpoint();
+
+        std::string mName;
+        std::string mRemotePlanner;
+        std::vector<std::string> mEndpoints;
+
+        boost::mutex mMutex;
+        size_t mNextEndpoint;
+    };
+}
+}
+
+#endif // PDDL_PLANNER_REMOTE_HPP
@@ -2,9 +2,10 @@
 #include <algorithm>
 #include <sstream>
 #include <boost/foreach.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/assign/list_of.hpp>
 #include <base/Logging.hpp>
-#include "grammar/lisp/Expression.hpp"
+#include "Parser.hpp"
 
 namespace pddl_planner {
 namespace representation {
@@ -19,19 +20,19 @@ Expression::Expression(const Label& label)
 }
 
 Expression::Expression(const Expression& other)
-{
-    *this = other;
-}
+    : label(other.label)
+    , parameters(other.parameters)
+    , typedItem(other.typedItem)
+{}
+
+Expression::Expression(Expression&& other) noexcept
+    : label(std::move(other.label))
+    , parameters(std::move(other.parameters))
+    , typedItem(std::move(other.typedItem))
+{}
 
 Expression::~Expression()
-{
-    ExpressionPtrList::iterator it = parameters.begin();
-    for(; it != parameters.end(); ++it)
-    {
-        delete *it;
-        *it = NULL;
-    }
-}
+{}
 
 Expression::Expression(const Label& label, const Expression& arg0, const Expression& arg1, const Expression& arg2, const Expression& arg3, const Expression& arg4, const Expression& arg5, const Expression& arg6, const Expression& arg7, const Expression& arg8, const Expression& arg9, const Expression& arg10)
     : label(label)
@@ -136,12 +137,22 @@ Expression::Expression(Quantor quantor, const TypedItem& typedItem, const Expres
 
 void Expression::addParameter(const Label& e)
 {
-    parameters.push_back( new Expression(e) );
+    parameters.push_back( boost::make_shared<const Expression>(e) );
 }
 
 void Expression::addParameter(const Expression& e)
 {
-    parameters.push_back( new Expression(e) );
+    parameters.push_back( boost::make_shared<const Expression>(e) );
+}
+
+void Expression::addParameter(Expression&& e)
+{
+    parameters.push_back( boost::make_shared<const Expression>(std::move(e)) );
+}
+
+void Expression::addParameter(const ExpressionPtr& e)
+{
+    parameters.push_back(e);
 }
 
 std::map<Quantor, std::string> QuantorTxt = boost::assign::map_list_of
@@ -165,7 +176,7 @@ std::string Expression::toLISP() const
         }
         txt += ")";
 
-        BOOST_FOREACH(Expression* e, parameters)
+        BOOST_FOREACH(const ExpressionPtr& e, parameters)
         {
             txt += " " + e->toLISP();
         }
@@ -174,7 +185,7 @@ std::string Expression::toLISP() const
     }
 
     std::string txt = "(" + label;
-    BOOST_FOREACH(Expression* e, parameters)
+    BOOST_FOREACH(const ExpressionPtr& e, parameters)
     {
         txt += " " + e->toLISP();
     }
@@ -184,21 +195,13 @@ std::string Expression::toLISP() const
 
 Expression Expression::fromString(const std::string& expressionString)
 {
-    typedef grammar::lisp::Expression<std::string::const_iterator, qi::space_type> lisp_expression_grammar;
-    lisp_expression_grammar grammar;
-    Expression expression;
-
-    std::string::const_iterator iter = expressionString.begin();
-    std::string::const_iterator end = expressionString.end();
-
-    bool r = phrase_parse(iter, end, grammar, qi::space, expression);
-    if(r && iter == end)
+    try {
+        return Parser::parseExpression(expressionString);
+    } catch(const ParseError& e)
     {
-        return expression;
+        throw std::invalid_argument("pddl_planner::representation::Expression::fromString: '" +\
+                expressionString + "' is not a valid expression -- " + std::string(e.what()));
     }
-
-    throw std::invalid_argument("pddl_planner::representation::Expression::fromString: '" +\
-            expressionString + "' is not a valid expression");
 }
 
 bool Expression::isQuantor(const Label& label)
@@ -220,21 +223,25 @@ Expression& Expression::operator=(const Expression& other)
     {
         label = other.label;
         typedItem = other.typedItem;
+        parameters = other.parameters;
+    }
+    return *this;
+}
 
-        {
-            parameters.clear();
-            BOOST_FOREACH(Expression* e, other.parameters)
-            {
-                addParameter(*e);
-            }
-        }
+Expression& Expression::operator=(Expression&& other) noexcept
+{
+    if( this != &other)
+    {
+        label = std::move(other.label);
+        typedItem = std::move(other.typedItem);
+        parameters = std::move(other.parameters);
     }
     return *this;
 }
 
 bool Expression::operator==(const Expression& other) const
 {
-    if(label != other.label && typedItem != other.typedItem)
+    if(label != other.label || typedItem != other.typedItem)
     {
         return false;
     }
@@ -244,20 +251,11 @@ bool Expression::operator==(const Expression& other) const
         return false;
     }
 
-    ExpressionPtrList::const_iterator pit = parameters.begin();
-    for(;pit != parameters.end(); ++pit)
+    // The order of parameters matters, e.g. for the arguments of an atom
+    for(size_t i = 0; i < parameters.size(); ++i)
     {
-        bool found = false;
-        ExpressionPtrList::const_iterator oit = other.parameters.begin();
-        for(; oit != other.parameters.end(); ++oit)
-        {
-            if(*pit == *oit)
-            {
-                found = true;
-                break;
-            }
-        }
-        if(!found)
+        // Shared subtrees are equal without comparing their content
+        if(parameters[i] != other.parameters[i] && !(*parameters[i] == *other.parameters[i]))
         {
             return false;
         }
@@ -430,6 +428,7 @@ Domain::Domain(const std::string& name)
 void Domain::addType(const Type& type)
 {
     types.push_back(type);
+    mTypeIndex.append(types);
 }
 
 void Domain::addConstant(const TypedItem& constant, bool overwrite)
@@ -448,6 +447,7 @@ void Domain::addConstant(const TypedItem& constant, bool overwrite)
     }
 
     constants.push_back( constant );
+    mConstantIndex.append(constants);
 }
 
 void Domain::addPredicate(const Predicate& predicate, bool overwrite)
@@ -459,6 +459,7 @@ void Domain::addPredicate(const Predicate& predicate, bool overwrite)
         removePredicate(predicate.label);
     }
     predicates.push_back(predicate);
+    mPredicateIndex.append(predicates);
 }
 
 void Domain::addRequirement(const Requirement& requirement)
@@ -481,6 +482,7 @@ void Domain::addAction(const Action& action, bool overwrite)
     }
 
     actions.push_back(action);
+    mActionIndex.append(actions);
 }
 
 void Domain::addFunction(const Function& function, bool overwrite)
@@ -492,85 +494,66 @@ void Domain::addFunction(const Function& function, bool overwrite)
         removeFunction(function.label);
     }
     functions.push_back(function);
+    mFunctionIndex.append(functions);
 }
 
-void Domain::removeConstant(const Label& label)
+namespace
 {
-    ConstantList::iterator cit = constants.begin();
-    for(; cit != constants.end(); ++cit)
+    template<typename List>
+    void removeAll(List& list, LabelIndex& index, const Label& label)
     {
-        if(cit->label == label)
+        if(index.find(list, label) < 0)
         {
-            constants.erase(cit);
+            return;
         }
+
+        typename List::iterator it = list.begin();
+        while(it != list.end())
+        {
+            if(it->label == label)
+            {
+                it = list.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        index.rebuild(list);
     }
 }
 
+void Domain::removeConstant(const Label& label)
+{
+    removeAll(constants, mConstantIndex, label);
+}
+
 void Domain::removePredicate(const Label& label)
 {
-    PredicateList::iterator cit = predicates.begin();
-    for(; cit != predicates.end(); ++cit)
-    {
-        if(cit->label == label)
-        {
-            predicates.erase(cit);
-        }
-    }
+    removeAll(predicates, mPredicateIndex, label);
 }
 
 void Domain::removeAction(const Label& label)
 {
-    ActionList::iterator cit = actions.begin();
-    for(; cit != actions.end(); ++cit)
-    {
-        if(cit->label == label)
-        {
-            actions.erase(cit);
-        }
-    }
+    removeAll(actions, mActionIndex, label);
 }
 
 void Domain::removeFunction(const Label& label)
 {
-    FunctionList::iterator cit = functions.begin();
-    for(; cit != functions.end(); ++cit)
-    {
-        if(cit->label == label)
-        {
-            functions.erase(cit);
-        }
-    }
+    removeAll(functions, mFunctionIndex, label);
 }
 
 bool Domain::isType(const Type& type) const
 {
-    return types.end() != std::find(types.begin(), types.end(), type);
+    return mTypeIndex.find(types, type) >= 0;
 }
 
 bool Domain::isConstant(const Label& label) const
 {
-    ConstantList::const_iterator cit = constants.begin();
-    for(; cit != constants.end(); ++cit)
-    {
-        if(cit->label == label)
-        {
-            return true;
-        }
-    }
-    return false;
+    return mConstantIndex.find(constants, label) >= 0;
 }
 
 bool Domain::isPredicate(const Label& label) const
 {
-    PredicateList::const_iterator cit = predicates.begin();
-    for(; cit != predicates.end(); ++cit)
-    {
-        if(cit->label == label)
-        {
-            return true;
-        }
-    }
-    return false;
+    return mPredicateIndex.find(predicates, label) >= 0;
 }
 
 bool Domain::isRequirement(const Requirement& requirement) const
@@ -588,50 +571,30 @@ bool Domain::isRequirement(const Requirement& requirement) const
 
 bool Domain::isAction(const Label& label) const
 {
-    ActionList::const_iterator cit = actions.begin();
-    for(; cit != actions.end(); ++cit)
-    {
-        if(cit->label == label)
-        {
-            return true;
-        }
-    }
-    return false;
+    return mActionIndex.find(actions, label) >= 0;
 }
 
 bool Domain::isFunction(const Label& label) const
 {
-    FunctionList::const_iterator cit = functions.begin();
-    for(; cit != functions.end(); ++cit)
-    {
-        if(cit->label == label)
-        {
-            return true;
-        }
-    }
-    return false;
+    return mFunctionIndex.find(functions, label) >= 0;
 }
 
 Predicate Domain::getPredicate(const Label& label) const
 {
-    BOOST_FOREACH(Predicate p, predicates)
+    int position = mPredicateIndex.find(predicates, label);
+    if(position >= 0)
     {
-        if(p.label == label)
-        {
-            return p;
-        }
+        return predicates[position];
     }
     throw std::runtime_error("pddl_planner::representation::Domain::getPredicate: predicate '" + label + "' could not be found");
 }
 
 Action Domain::getAction(const Label& label) const
 {
-    BOOST_FOREACH(Action a, actions)
+    int position = mActionIndex.find(actions, label);
+    if(position >= 0)
     {
-        if(a.label == label)
-        {
-            return a;
-        }
+        return actions[position];
     }
     throw std::runtime_error("pddl_planner::representation::Domain::getAction: action '" + label + "' could not be found");
 }
@@ -758,7 +721,8 @@ std::string Domain::toLISP() const
 
 void Domain::validate(const Expression& e, const VariableManager& variableManager) const
 {
-    ArityValidator operatorValidator;
+    // Operators and quantifiers are the same for all domains
+    static const ArityValidator operatorValidator;
 
     if(e.isAtomic())
     {
@@ -770,16 +734,14 @@ void Domain::validate(const Expression& e, const VariableManager& variableManage
     } else if( isPredicate(e.label) )
     {
         LOG_DEBUG_S << "Validating predicate: '" << e.label << "'";
-        Predicate p = getPredicate(e.label);
-        BOOST_FOREACH(Expression* ePtr, e.parameters)
+        BOOST_FOREACH(const ExpressionPtr& ePtr, e.parameters)
         {
             validate(*ePtr, variableManager);
         }
     } else if( isAction(e.label))
     {
         LOG_DEBUG_S << "Validating action: '" << e.label << "'";
-        Action a = getAction(e.label);
-        BOOST_FOREACH(Expression* ePtr, e.parameters)
+        BOOST_FOREACH(const ExpressionPtr& ePtr, e.parameters)
         {
             validate(*ePtr, variableManager);
         }
@@ -790,7 +752,7 @@ void Domain::validate(const Expression& e, const VariableManager& variableManage
     } else if( operatorValidator.isOperator(e.label) )
     {
         LOG_DEBUG_S << "Validating operator: '" << e.label << "'";
-        BOOST_FOREACH(Expression* ePtr, e.parameters)
+        BOOST_FOREACH(const ExpressionPtr& ePtr, e.parameters)
         {
             validate(*ePtr, variableManager);
         }
@@ -807,19 +769,19 @@ void Domain::validate() const
         throw std::runtime_error("pddl_planner::representation::Domain::validate domain is empty");
     }
 
-    BOOST_FOREACH(Action action, actions)
+    BOOST_FOREACH(const Action& action, actions)
     {
         LOG_DEBUG_S << "Validating action: " << action.label;
 
         VariableManager variableManager(action.arguments);
 
-        BOOST_FOREACH(Expression e, action.preconditions)
+        BOOST_FOREACH(const Expression& e, action.preconditions)
         {
             LOG_DEBUG_S << "Validating precondition: " << e.label;
             validate(e, variableManager);
         }
 
-        BOOST_FOREACH(Expression e, action.effects)
+        BOOST_FOREACH(const Expression& e, action.effects)
         {
             LOG_DEBUG_S << "Validating effect: " << e.label;
             validate(e, variableManager);
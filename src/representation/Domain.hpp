@@ -9,6 +9,8 @@
 #include <stdexcept>
 #include <cstdarg>
 #include <stack>
+#include <boost/unordered_map.hpp>
+#include <boost/shared_ptr.hpp>
 
 namespace pddl_planner {
 namespace representation {
@@ -264,12 +266,17 @@ public:
 enum Quantor { UNKNOWN_QUANTOR, FORALL, EXISTS };
 extern std::map<Quantor,std::string> QuantorTxt;
 
-class Expression;
-typedef std::vector<Expression*> ExpressionPtrList;
+struct Expression;
+typedef boost::shared_ptr<const Expression> ExpressionPtr;
+typedef std::vector<ExpressionPtr> ExpressionPtrList;
 /**
  * \class Expression
  * \brief Representation of (LISP) expressions
  * \details Expression are needed to handle addition of actions, e.g., as part of preconditions or effects
+ *
+ * The parameters of an expression are immutable subtrees, which are shared between copies of
+ * an expression. Thus, copying an expression only copies its label and the list of parameter
+ * references, but not the complete tree
  */
 struct Expression
 {
@@ -281,6 +288,7 @@ struct Expression
 
     Expression(const Label& label = "");
     Expression(const Expression& other);
+    Expression(Expression&& other) noexcept;
     virtual ~Expression();
 
     Expression(const Label& label, const Expression& arg0, const Expression& arg1 = Expression(), const Expression& arg2 = Expression(), const Expression& arg3 = Expression(), const Expression& arg4 = Expression(), const Expression& arg5 = Expression(), const Expression& arg6 = Expression(), const Expression& arg7 = Expression(), const Expression& arg8 = Expression(), const Expression& arg9 = Expression(), const Expression& arg10 = Expression());
@@ -294,6 +302,12 @@ struct Expression
      */
     void addParameter(const Label& e);
     void addParameter(const Expression& e);
+    void addParameter(Expression&& e);
+
+    /**
+     * Add a parameter which shares the given subtree
+     */
+    void addParameter(const ExpressionPtr& e);
 
     bool isAtomic() const { return parameters.empty(); }
 
@@ -305,6 +319,7 @@ struct Expression
      * Assign operator
      */
     Expression& operator=(const Expression& other);
+    Expression& operator=(Expression&& other) noexcept;
 
     /**
      * Equals operator
@@ -413,6 +428,84 @@ struct Action
 };
 typedef std::vector<Action> ActionList;
 
+/**
+ * \class LabelIndex
+ * \brief Hash index which maps the labels of a list's items to their position in the list
+ * \details The index is updated by the methods of Domain which modify a list. Lookups do
+ * not modify the index, so that a shared domain can be queried concurrently. Since the
+ * lists can also be modified directly, a lookup checks the label of the indexed item and
+ * falls back to a linear search if the label does not match or is not indexed
+ */
+class LabelIndex
+{
+public:
+    LabelIndex()
+        : mListSize(0)
+    {}
+
+    /**
+     * Find the position of the first item with the given label
+     * \return position of the item, or -1 if there is no such item
+     */
+    template<typename List>
+    int find(const List& list, const Label& label) const
+    {
+        boost::unordered_map<Label, size_t>::const_iterator cit = mPositions.find(label);
+        if(cit != mPositions.end() && cit->second < list.size() && getLabel(list[cit->second]) == label)
+        {
+            return (int) cit->second;
+        }
+
+        // List has been modified directly
+        for(size_t i = 0; i < list.size(); ++i)
+        {
+            if(getLabel(list[i]) == label)
+            {
+                return (int) i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Register the item which has been appended to the list
+     */
+    template<typename List>
+    void append(const List& list)
+    {
+        if(mListSize + 1 == list.size())
+        {
+            mPositions.insert(std::make_pair(getLabel(list.back()), list.size() - 1));
+            mListSize = list.size();
+        } else {
+            rebuild(list);
+        }
+    }
+
+    /**
+     * Index the list again, e.g. after items have been removed from it
+     */
+    template<typename List>
+    void rebuild(const List& list)
+    {
+        mPositions.clear();
+        for(size_t i = 0; i < list.size(); ++i)
+        {
+            // Keep the first occurrence as the linear search does
+            mPositions.insert(std::make_pair(getLabel(list[i]), i));
+        }
+        mListSize = list.size();
+    }
+
+private:
+    static const Label& getLabel(const Type& type) { return type; }
+    template<typename Item>
+    static const Label& getLabel(const Item& item) { return item.label; }
+
+    boost::unordered_map<Label, size_t> mPositions;
+    size_t mListSize;
+};
+
 /**
  * \brief An internal representation of a PDDL domain description
  * \details This class allows to programmatically build a PDDL domain description and
@@ -495,6 +588,14 @@ struct Domain
      * \throw std::runtime_error if expression is not properly defined
      */
     void validate() const;
+
+private:
+    // Indexes for lookups by label, which are updated by the add and remove methods
+    LabelIndex mTypeIndex;
+    LabelIndex mConstantIndex;
+    LabelIndex mPredicateIndex;
+    LabelIndex mActionIndex;
+    LabelIndex mFunctionIndex;
 };
 
 } // end namespace representation
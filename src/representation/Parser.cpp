@@ -0,0 +1,551 @@
+#include "Parser.hpp"
+#include <sstream>
+#include <cstring>
+#include <strings.h>
+#include <boost/foreach.hpp>
+
+namespace pddl_planner {
+namespace representation {
+
+ParseError::ParseError(const std::string& msg, size_t line, size_t column)
+    : std::invalid_argument(msg)
+    , mLine(line)
+    , mColumn(column)
+{}
+
+namespace
+{
+
+enum TokenType { OPEN, CLOSE, SYMBOL, END };
+
+/**
+ * A token refers to the parsed text, i.e. it is only valid as long as the text is
+ */
+struct Token
+{
+    TokenType type;
+    const char* begin;
+    size_t length;
+    size_t line;
+    size_t column;
+
+    std::string str() const { return std::string(begin, length); }
+
+    bool is(const char* keyword) const
+    {
+        return type == SYMBOL && length == strlen(keyword) && 0 == strncasecmp(begin, keyword, length);
+    }
+};
+
+/**
+ * Tokenizer which skips whitespace and comments, and creates tokens on demand
+ */
+class Lexer
+{
+    const char* mPos;
+    const char* mEnd;
+    const char* mLineStart;
+    size_t mLine;
+
+    Token mToken;
+
+public:
+    Lexer(const std::string& text)
+        : mPos(text.data())
+        , mEnd(text.data() + text.size())
+        , mLineStart(text.data())
+        , mLine(1)
+    {
+        advance();
+    }
+
+    const Token& peek() const { return mToken; }
+
+    Token next()
+    {
+        Token token = mToken;
+        advance();
+        return token;
+    }
+
+    void fail(const Token& token, const std::string& msg) const
+    {
+        std::stringstream ss;
+        ss << "pddl_planner::representation::Parser: line " << token.line << ", column " << token.column << ": " << msg;
+        throw ParseError(ss.str(), token.line, token.column);
+    }
+
+    static std::string describe(const Token& token)
+    {
+        switch(token.type)
+        {
+            case OPEN:
+                return "'('";
+            case CLOSE:
+                return "')'";
+            case END:
+                return "end of input";
+            default:
+                return "'" + token.str() + "'";
+        }
+    }
+
+    void expect(TokenType type)
+    {
+        if(mToken.type != type)
+        {
+            fail(mToken, std::string("expected ") + (type == OPEN ? "'('" : (type == CLOSE ? "')'" : "end of input")) + " but found " + describe(mToken));
+        }
+        advance();
+    }
+
+    Token expectSymbol()
+    {
+        if(mToken.type != SYMBOL)
+        {
+            fail(mToken, "expected label but found " + describe(mToken));
+        }
+        return next();
+    }
+
+    void expectKeyword(const char* keyword)
+    {
+        if(!mToken.is(keyword))
+        {
+            fail(mToken, std::string("expected '") + keyword + "' but found " + describe(mToken));
+        }
+        advance();
+    }
+
+private:
+    void advance()
+    {
+        while(mPos != mEnd)
+        {
+            char c = *mPos;
+            if(c == '\n')
+            {
+                ++mLine;
+                mLineStart = ++mPos;
+            } else if(c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v')
+            {
+                ++mPos;
+            } else if(c == ';')
+            {
+                while(mPos != mEnd && *mPos != '\n')
+                {
+                    ++mPos;
+                }
+            } else {
+                break;
+            }
+        }
+
+        mToken.begin = mPos;
+        mToken.line = mLine;
+        mToken.column = mPos - mLineStart + 1;
+        if(mPos == mEnd)
+        {
+            mToken.type = END;
+            mToken.length = 0;
+            return;
+        }
+
+        switch(*mPos)
+        {
+            case '(':
+                mToken.type = OPEN;
+                mToken.length = 1;
+                ++mPos;
+                return;
+            case ')':
+                mToken.type = CLOSE;
+                mToken.length = 1;
+                ++mPos;
+                return;
+            default:
+                break;
+        }
+
+        mToken.type = SYMBOL;
+        while(mPos != mEnd)
+        {
+            char c = *mPos;
+            if(c == '(' || c == ')' || c == ';' || c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v')
+            {
+                break;
+            }
+            ++mPos;
+        }
+        mToken.length = mPos - mToken.begin;
+    }
+};
+
+const std::string DEFAULT_TYPE = "object";
+
+/**
+ * Parse a list of (optionally) typed items up to the closing parenthesis, e.g. '?x ?y - location ?z'
+ */
+void parseTypedList(Lexer& lexer, TypedItemList& items)
+{
+    size_t untyped = items.size();
+    while(lexer.peek().type != CLOSE)
+    {
+        Token token = lexer.expectSymbol();
+        if(token.is("-"))
+        {
+            if(untyped == items.size())
+            {
+                lexer.fail(token, "type without preceding item");
+            }
+            if(lexer.peek().type == OPEN)
+            {
+                lexer.fail(lexer.peek(), "'either' types are not supported");
+            }
+            Type type = lexer.expectSymbol().str();
+            for(; untyped < items.size(); ++untyped)
+            {
+                items[untyped].type = type;
+            }
+        } else {
+            items.push_back(TypedItem(token.str(), ""));
+        }
+    }
+    lexer.expect(CLOSE);
+
+    for(; untyped < items.size(); ++untyped)
+    {
+        items[untyped].type = DEFAULT_TYPE;
+    }
+}
+
+Expression parseExpression(Lexer& lexer)
+{
+    if(lexer.peek().type == SYMBOL)
+    {
+        Token token = lexer.next();
+        if(Expression::isQuantor(token.str()))
+        {
+            lexer.fail(token, "quantifier without expression");
+        }
+        return Expression(token.str());
+    }
+
+    lexer.expect(OPEN);
+    Token token = lexer.expectSymbol();
+    Label label = token.str();
+
+    if(Expression::isQuantor(label))
+    {
+        lexer.expect(OPEN);
+        TypedItemList variables;
+        parseTypedList(lexer, variables);
+        if(variables.empty())
+        {
+            lexer.fail(token, "quantifier without variables");
+        }
+        BOOST_FOREACH(TypedItem& variable, variables)
+        {
+            if(variable.type == DEFAULT_TYPE)
+            {
+                variable.type.clear();
+            }
+        }
+
+        Expression e = parseExpression(lexer);
+        lexer.expect(CLOSE);
+
+        Quantor quantor = label == QuantorTxt[FORALL] ? FORALL : EXISTS;
+        for(TypedItemList::const_reverse_iterator rit = variables.rbegin(); rit != variables.rend(); ++rit)
+        {
+            e = Expression(quantor, *rit, e);
+        }
+        return e;
+    }
+
+    Expression e(label);
+    while(lexer.peek().type != CLOSE)
+    {
+        if(lexer.peek().type == END)
+        {
+            lexer.fail(lexer.peek(), "missing ')' for '" + label + "'");
+        }
+        e.addParameter(parseExpression(lexer));
+    }
+    lexer.expect(CLOSE);
+    return e;
+}
+
+/**
+ * Skip an empty expression '()', which is allowed for preconditions and effects
+ * \return true if an empty expression has been skipped
+ */
+bool skipEmptyExpression(Lexer& lexer)
+{
+    if(lexer.peek().type != OPEN)
+    {
+        return false;
+    }
+
+    Lexer lookahead = lexer;
+    lookahead.next();
+    if(lookahead.peek().type != CLOSE)
+    {
+        return false;
+    }
+    lookahead.next();
+    lexer = lookahead;
+    return true;
+}
+
+/**
+ * Parse a skeleton list as used for predicates and functions, e.g. '(at ?x - physob ?l - location)'
+ */
+PredicateList parseSkeletons(Lexer& lexer, bool allowFunctionTypes)
+{
+    PredicateList skeletons;
+    while(lexer.peek().type != CLOSE)
+    {
+        lexer.expect(OPEN);
+        Label label = lexer.expectSymbol().str();
+        ArgumentList arguments;
+        parseTypedList(lexer, arguments);
+        skeletons.push_back(Predicate(label, arguments));
+
+        if(allowFunctionTypes && lexer.peek().is("-"))
+        {
+            lexer.next();
+            lexer.expectSymbol();
+        }
+    }
+    lexer.expect(CLOSE);
+    return skeletons;
+}
+
+void parseAction(Lexer& lexer, Domain& domain)
+{
+    Token label = lexer.expectSymbol();
+    Action action(label.str());
+
+    while(lexer.peek().type != CLOSE)
+    {
+        Token keyword = lexer.expectSymbol();
+        if(keyword.is(":parameters"))
+        {
+            lexer.expect(OPEN);
+            ArgumentList arguments;
+            parseTypedList(lexer, arguments);
+            BOOST_FOREACH(const TypedItem& argument, arguments)
+            {
+                action.addArgument(argument);
+            }
+        } else if(keyword.is(":precondition"))
+        {
+            if(!skipEmptyExpression(lexer))
+            {
+                action.addPrecondition(parseExpression(lexer));
+            }
+        } else if(keyword.is(":effect"))
+        {
+            if(!skipEmptyExpression(lexer))
+            {
+                action.addEffect(parseExpression(lexer));
+            }
+        } else {
+            lexer.fail(keyword, "unsupported action element " + Lexer::describe(keyword));
+        }
+    }
+    lexer.expect(CLOSE);
+
+    try {
+        domain.addAction(action);
+    } catch(const std::invalid_argument& e)
+    {
+        lexer.fail(label, e.what());
+    }
+}
+
+void parseDomainSection(Lexer& lexer, Domain& domain)
+{
+    Token section = lexer.expectSymbol();
+    if(section.is(":requirements"))
+    {
+        while(lexer.peek().type != CLOSE)
+        {
+            Token requirement = lexer.expectSymbol();
+            if(requirement.length < 2 || requirement.begin[0] != ':')
+            {
+                lexer.fail(requirement, "invalid requirement " + Lexer::describe(requirement));
+            }
+            Requirement r(requirement.begin + 1, requirement.length - 1);
+            if(!domain.isRequirement(r))
+            {
+                domain.addRequirement(r);
+            }
+        }
+        lexer.expect(CLOSE);
+    } else if(section.is(":types"))
+    {
+        TypedItemList types;
+        parseTypedList(lexer, types);
+        BOOST_FOREACH(const TypedItem& type, types)
+        {
+            if(!domain.isType(type.label))
+            {
+                domain.addType(type.label);
+            }
+            // Implicitly declared parent types
+            if(type.type != DEFAULT_TYPE && !domain.isType(type.type))
+            {
+                domain.addType(type.type);
+            }
+        }
+    } else if(section.is(":constants"))
+    {
+        TypedItemList constants;
+        Token start = lexer.peek();
+        parseTypedList(lexer, constants);
+        BOOST_FOREACH(const Constant& constant, constants)
+        {
+            if(constant.type == DEFAULT_TYPE && !domain.isType(DEFAULT_TYPE))
+            {
+                domain.addType(DEFAULT_TYPE);
+            }
+            try {
+                domain.addConstant(constant);
+            } catch(const std::invalid_argument& e)
+            {
+                lexer.fail(start, e.what());
+            }
+        }
+    } else if(section.is(":predicates"))
+    {
+        Token start = lexer.peek();
+        PredicateList predicates = parseSkeletons(lexer, false);
+        BOOST_FOREACH(const Predicate& predicate, predicates)
+        {
+            try {
+                domain.addPredicate(predicate);
+            } catch(const std::invalid_argument& e)
+            {
+                lexer.fail(start, e.what());
+            }
+        }
+    } else if(section.is(":functions"))
+    {
+        Token start = lexer.peek();
+        FunctionList functions = parseSkeletons(lexer, true);
+        BOOST_FOREACH(const Function& function, functions)
+        {
+            try {
+                domain.addFunction(function);
+            } catch(const std::invalid_argument& e)
+            {
+                lexer.fail(start, e.what());
+            }
+        }
+    } else if(section.is(":action"))
+    {
+        parseAction(lexer, domain);
+    } else {
+        lexer.fail(section, "unsupported domain section " + Lexer::describe(section));
+    }
+}
+
+void parseProblemSection(Lexer& lexer, Problem& problem)
+{
+    Token section = lexer.expectSymbol();
+    if(section.is(":domain"))
+    {
+        Token name = lexer.expectSymbol();
+        if(!problem.domain.name.empty() && !name.is(problem.domain.name.c_str()))
+        {
+            lexer.fail(name, "problem refers to domain '" + name.str() + "' instead of '" + problem.domain.name + "'");
+        }
+        lexer.expect(CLOSE);
+    } else if(section.is(":objects"))
+    {
+        TypedItemList objects;
+        parseTypedList(lexer, objects);
+        BOOST_FOREACH(const TypedItem& object, objects)
+        {
+            problem.addObject(object);
+        }
+    } else if(section.is(":init"))
+    {
+        while(lexer.peek().type != CLOSE)
+        {
+            Token start = lexer.peek();
+            Expression fact = parseExpression(lexer);
+            try {
+                problem.addInitialStatus(fact);
+            } catch(const std::invalid_argument& e)
+            {
+                lexer.fail(start, e.what());
+            }
+        }
+        lexer.expect(CLOSE);
+    } else if(section.is(":goal"))
+    {
+        problem.setGoal(parseExpression(lexer));
+        lexer.expect(CLOSE);
+    } else {
+        lexer.fail(section, "unsupported problem section " + Lexer::describe(section));
+    }
+}
+
+/**
+ * Parse the header '(define (<kind> <name>)' of a description
+ * \return name
+ */
+std::string parseHeader(Lexer& lexer, const char* kind)
+{
+    lexer.expect(OPEN);
+    lexer.expectKeyword("define");
+    lexer.expect(OPEN);
+    lexer.expectKeyword(kind);
+    std::string name = lexer.expectSymbol().str();
+    lexer.expect(CLOSE);
+    return name;
+}
+
+} // end anonymous namespace
+
+Domain Parser::parseDomain(const std::string& text)
+{
+    Lexer lexer(text);
+    Domain domain(parseHeader(lexer, "domain"));
+    while(lexer.peek().type != CLOSE)
+    {
+        lexer.expect(OPEN);
+        parseDomainSection(lexer, domain);
+    }
+    lexer.expect(CLOSE);
+    lexer.expect(END);
+    return domain;
+}
+
+Problem Parser::parseProblem(const std::string& text, const Domain& domain)
+{
+    Lexer lexer(text);
+    Problem problem(parseHeader(lexer, "problem"), domain);
+    while(lexer.peek().type != CLOSE)
+    {
+        lexer.expect(OPEN);
+        parseProblemSection(lexer, problem);
+    }
+    lexer.expect(CLOSE);
+    lexer.expect(END);
+    return problem;
+}
+
+Expression Parser::parseExpression(const std::string& text)
+{
+    Lexer lexer(text);
+    Expression e = representation::parseExpression(lexer);
+    lexer.expect(END);
+    return e;
+}
+
+} // end namespace representation
+} // end namespace pddl_planner
@@ -0,0 +1,73 @@
+#ifndef PDDL_PLANNER_REPRESENTATION_PARSER
+#define PDDL_PLANNER_REPRESENTATION_PARSER
+
+#include <pddl_planner/representation/Problem.hpp>
+
+namespace pddl_planner {
+namespace representation {
+
+/**
+ * \class ParseError
+ * \brief Error of the PDDL parser, which provides the position of the offending token
+ */
+class ParseError : public std::invalid_argument
+{
+    size_t mLine;
+    size_t mColumn;
+
+public:
+    ParseError(const std::string& msg, size_t line, size_t column);
+
+    /**
+     * Get line of the error, starting with 1
+     */
+    size_t getLine() const { return mLine; }
+
+    /**
+     * Get column of the error, starting with 1
+     */
+    size_t getColumn() const { return mColumn; }
+};
+
+/**
+ * \class Parser
+ * \brief Single pass recursive descent parser for PDDL descriptions
+ * \details The parser tokenizes the text in place, i.e. only the labels that end up in the
+ * resulting representation are copied. Supported are the sections :requirements, :types,
+ * :constants, :predicates, :functions and :action for domains, and :domain, :objects, :init
+ * and :goal for problems. Untyped items are assigned the type 'object'. Quantifiers over
+ * multiple variables are represented as nested quantifiers
+ */
+class Parser
+{
+public:
+    /**
+     * Parse a domain description
+     * \param text PDDL domain description
+     * \return domain
+     * \throws ParseError if the description is invalid or uses unsupported features
+     */
+    static Domain parseDomain(const std::string& text);
+
+    /**
+     * Parse a problem description
+     * \param text PDDL problem description
+     * \param domain Domain of the problem
+     * \return problem
+     * \throws ParseError if the description is invalid, uses unsupported features or
+     * refers to a different domain
+     */
+    static Problem parseProblem(const std::string& text, const Domain& domain);
+
+    /**
+     * Parse a single expression, e.g. '(at ?x ?l)'
+     * \param text LISP expression
+     * \return expression
+     * \throws ParseError if the text is not a single valid expression
+     */
+    static Expression parseExpression(const std::string& text);
+};
+
+} // end namespace representation
+} // end namespace pddl_planner
+#endif // PDDL_PLANNER_REPRESENTATION_PARSER
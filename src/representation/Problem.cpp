@@ -1,5 +1,6 @@
 #include "Problem.hpp"
 #include <sstream>
+#include <algorithm>
 #include <boost/foreach.hpp>
 
 namespace pddl_planner {
@@ -8,24 +9,107 @@ namespace representation {
 Problem::Problem(const std::string& name, const Domain& domain)
     : name(name)
     , domain(domain)
+    , mRevision(0)
 {}
 
+static std::string objectToLISP(const TypedItem& object)
+{
+    return "        " + object.label + " - " + object.type + "\n";
+}
+
+std::string Problem::objectsToLISP() const
+{
+    std::string lisp;
+    BOOST_FOREACH(const TypedItem& t, objects)
+    {
+        lisp += objectToLISP(t);
+    }
+    return lisp;
+}
+
 void Problem::addObject(const TypedItem& object, bool overwrite)
 {
     objects.push_back( object );
+    if(mObjectsCached.size() + 1 == objects.size() && std::equal(mObjectsCached.begin(), mObjectsCached.end(), objects.begin()))
+    {
+        mObjectsLISP += objectToLISP(object);
+        mObjectsCached.push_back(object);
+    } else {
+        mObjectsLISP = objectsToLISP();
+        mObjectsCached = objects;
+    }
+    ++mRevision;
 }
 
 void Problem::addInitialStatus(const Expression& e)
 {
-    ExpressionList::iterator cit = status.begin();
-    for(; cit != status.end(); ++cit)
+    syncStatusCache();
+
+    std::string lisp = e.toLISP();
+    if(!mStatusIndex.insert(lisp).second)
+    {
+        throw std::invalid_argument("pddl_planner::representation::Domain::addInitialStatus expression '" + lisp + "' already exists");
+    }
+    status.push_back(e);
+    mStatusCached.push_back(e);
+    mStatusLISP.push_back(lisp);
+    ++mRevision;
+}
+
+bool Problem::removeInitialStatus(const Expression& e)
+{
+    syncStatusCache();
+
+    std::string lisp = e.toLISP();
+    if(!mStatusIndex.erase(lisp))
+    {
+        return false;
+    }
+
+    for(size_t i = 0; i < mStatusLISP.size(); ++i)
+    {
+        if(mStatusLISP[i] == lisp)
+        {
+            mStatusLISP.erase(mStatusLISP.begin() + i);
+            mStatusCached.erase(mStatusCached.begin() + i);
+            status.erase(status.begin() + i);
+            break;
+        }
+    }
+    ++mRevision;
+    return true;
+}
+
+void Problem::invalidateCache()
+{
+    mStatusCached.clear();
+    mStatusLISP.clear();
+    mStatusIndex.clear();
+    mObjectsCached.clear();
+    mObjectsLISP.clear();
+    ++mRevision;
+}
+
+void Problem::syncStatusCache()
+{
+    bool modified = mStatusCached.size() != status.size();
+    mStatusCached.resize(status.size());
+    mStatusLISP.resize(status.size());
+    for(size_t i = 0; i < status.size(); ++i)
     {
-        if(e == *cit)
+        if(!(status[i] == mStatusCached[i]))
         {
-            throw std::invalid_argument("pddl_planner::representation::Domain::addInitialStatus expression '" + e.toLISP() + "' already exists");
+            mStatusCached[i] = status[i];
+            mStatusLISP[i] = status[i].toLISP();
+            modified = true;
         }
     }
-    status.push_back(e);
+
+    if(modified)
+    {
+        mStatusIndex.clear();
+        mStatusIndex.insert(mStatusLISP.begin(), mStatusLISP.end());
+    }
 }
 
 void Problem::setGoal(const Expression& e)
@@ -38,21 +122,21 @@ void Problem::validate() const
     try {
         Domain tmpDomain = domain;
         tmpDomain.validate();
-        BOOST_FOREACH(Constant constant, objects)
+        BOOST_FOREACH(const Constant& constant, objects)
         {
             tmpDomain.addConstant(constant, true);
         }
 
         VariableManager variableManager;
         variableManager.push(":init");
-        BOOST_FOREACH(Expression e, status)
+        BOOST_FOREACH(const Expression& e, status)
         {
             tmpDomain.validate(e, variableManager);
         }
         variableManager.pop();
 
         variableManager.push(":goal");
-        BOOST_FOREACH(const Expression* e, goal.parameters)
+        BOOST_FOREACH(const ExpressionPtr& e, goal.parameters)
         {
             tmpDomain.validate(*e, variableManager);
         }
@@ -66,41 +150,59 @@ void Problem::validate() const
 
 std::string Problem::toLISP() const
 {
-    std::stringstream ss;
-    ss << "; BEGIN problem definition" << std::endl;
-    ss << "(define (problem " << name << ")" << std::endl;
-    ss << "    (:domain " << domain.name << ")" << std::endl;
+    size_t size = mObjectsLISP.size() + 256;
+    BOOST_FOREACH(const std::string& fact, mStatusLISP)
+    {
+        size += fact.size() + 9;
+    }
+
+    std::string lisp;
+    lisp.reserve(size);
+    lisp += "; BEGIN problem definition\n";
+    lisp += "(define (problem " + name + ")\n";
+    lisp += "    (:domain " + domain.name + ")\n";
     if(!objects.empty())
     {
-        ss << "    (:objects " << std::endl;
-        BOOST_FOREACH(TypedItem t, objects)
+        lisp += "    (:objects \n";
+        // Objects might have been modified directly
+        if(objects == mObjectsCached)
         {
-            ss << "        " << t.label << " - " << t.type << std::endl;
+            lisp += mObjectsLISP;
+        } else {
+            lisp += objectsToLISP();
         }
-        ss << "    )" << std::endl;
+        lisp += "    )\n";
     }
 
     if(!status.empty())
     {
-        ss << "    (:init " << std::endl;
-        BOOST_FOREACH(Expression e, status)
+        lisp += "    (:init \n";
+        for(size_t i = 0; i < status.size(); ++i)
         {
-            ss << "        " << e.toLISP() << std::endl;
+            lisp += "        ";
+            // Facts might have been modified directly
+            if(i < mStatusCached.size() && status[i] == mStatusCached[i])
+            {
+                lisp += mStatusLISP[i];
+            } else {
+                lisp += status[i].toLISP();
+            }
+            lisp += "\n";
         }
-        ss << "    )" << std::endl;
+        lisp += "    )\n";
     }
 
     if(!goal.isNull())
     {
-        ss << "    (:goal ";
-        ss << goal.toLISP();
-        ss << ")" << std::endl;
+        lisp += "    (:goal ";
+        lisp += goal.toLISP();
+        lisp += ")\n";
     }
 
-    ss << "; END problem definition" << std::endl;
-    ss << ")" << std::endl;
+    lisp += "; END problem definition\n";
+    lisp += ")\n";
 
-    return ss.str();
+    return lisp;
 }
 
 
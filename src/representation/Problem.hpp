@@ -2,10 +2,24 @@
 #define PDDL_PLANNER_REPRESENTATION_PROBLEM
 
 #include <pddl_planner/representation/Domain.hpp>
+#include <boost/unordered_set.hpp>
+#include <stdint.h>
 
 namespace pddl_planner {
 namespace representation {
 
+/**
+ * \brief An internal representation of a PDDL problem description
+ * \details The serialization of objects and initial status is cached and updated
+ * incrementally when using the methods of this class, so that a replan after changing
+ * a few facts does not serialize the complete problem again. The cache keeps the
+ * objects and facts it has serialized and compares them with the current members, so
+ * that members which have been modified directly are serialized again. Since facts
+ * share their subtrees, this comparison is cheap for unchanged facts.
+ *
+ * Const methods do not modify the cache, so a shared problem can be serialized from
+ * several threads
+ */
 struct Problem
 {
     std::string name;
@@ -30,6 +44,12 @@ struct Problem
      */
     void addInitialStatus(const Expression& e);
 
+    /**
+     * Remove an expression from the initial status
+     * \param e Expression describing the initial status
+     * \return true if the expression has been removed, false if it is not part of the initial status
+     */
+    bool removeInitialStatus(const Expression& e);
 
     /**
      * Set the goal expression
@@ -58,6 +78,43 @@ struct Problem
      * \return problem definition in LISP
      */
     std::string toLISP() const;
+
+    /**
+     * Get the revision of this problem, which increases with every change applied via
+     * the methods of this class
+     * \return revision
+     */
+    uint64_t getRevision() const { return mRevision; }
+
+    /**
+     * Drop the cached serialization
+     * \details Direct modifications of objects and status are detected, so this is
+     * only needed to release the memory of the cache
+     */
+    void invalidateCache();
+
+private:
+    /**
+     * Serialize the facts of the initial status again, which have been modified directly
+     */
+    void syncStatusCache();
+
+    /**
+     * Serialize the objects
+     */
+    std::string objectsToLISP() const;
+
+    uint64_t mRevision;
+
+    // Facts of the initial status which have been serialized, their serialization,
+    // and the set of serialized facts for duplicate detection
+    ExpressionList mStatusCached;
+    std::vector<std::string> mStatusLISP;
+    boost::unordered_set<std::string> mStatusIndex;
+
+    // Objects which have been serialized and their serialization
+    ConstantList mObjectsCached;
+    std::string mObjectsLISP;
 };
 
 } // end representation
@@ -0,0 +1,195 @@
+#include <benchmark/benchmark.h>
+#include <pddl_planner/representation/Domain.hpp>
+#include <pddl_planner/representation/Problem.hpp>
+#include <sstream>
+#include <algorithm>
+
+using namespace pddl_planner::representation;
+
+/**
+ * Microbenchmarks of the representation layer on synthetic domains and problems
+ *
+ * Domains are variants of the rimres domain with a configurable number of move actions,
+ * whose effects carry nested forall/when expressions of a configurable depth. Problems
+ * have a configurable number of objects and initial facts
+ */
+
+static std::string toString(size_t value)
+{
+    std::stringstream ss;
+    ss << value;
+    return ss.str();
+}
+
+/**
+ * Create the effect of a move action, where each level moves the connected objects along
+ * \param depth Number of nested forall/when expressions
+ */
+static Expression createNestedEffect(size_t depth, const std::string& object = "?obj")
+{
+    if(depth == 0)
+    {
+        return Expression("and", Expression("at", object, "?l"), Expression("not", Expression("at", object, "?m")));
+    }
+
+    std::string variable = "?z" + toString(depth);
+    return Expression("and", Expression("at", object, "?l"), Expression("not", Expression("at", object, "?m")),
+            Expression("forall", Expression(variable),
+                Expression("when", Expression("and", Expression("connected", variable, object), Expression("not", Expression("=", variable, object))),
+                    createNestedEffect(depth - 1, variable))));
+}
+
+static Domain createDomain(size_t actions, size_t depth)
+{
+    Domain domain("synthetic");
+    domain.addRequirement("strips");
+    domain.addRequirement("equality");
+    domain.addRequirement("typing");
+    domain.addRequirement("conditional-effects");
+
+    domain.addType("location");
+    domain.addType("physob_id");
+
+    domain.addPredicate(Predicate("at", TypedItem("?x", "physob_id"), TypedItem("?l", "location")));
+    domain.addPredicate(Predicate("connected", TypedItem("?x", "physob_id"), TypedItem("?y", "physob_id")));
+    domain.addPredicate(Predicate("cannot_move", TypedItem("?x", "physob_id")));
+
+    for(size_t i = 0; i < actions; ++i)
+    {
+        Action move("move_" + toString(i), TypedItem("?obj", "physob_id"), TypedItem("?m", "location"), TypedItem("?l", "location"));
+        move.addPrecondition(Expression("and", Expression("at", "?obj", "?m"), Expression("not", Expression("=", "?m", "?l")), Expression("not", Expression("cannot_move", "?obj"))));
+        move.addEffect(createNestedEffect(depth));
+        domain.addAction(move);
+    }
+    return domain;
+}
+
+/**
+ * Create a problem with the given number of objects, half of them locations, and initial
+ * facts, which place and connect the objects
+ */
+static Problem createProblem(size_t objects, size_t facts)
+{
+    Problem problem("synthetic-1", createDomain(4, 2));
+    size_t locations = std::max(objects / 2, (size_t) 1);
+    size_t items = std::max(objects - locations, (size_t) 1);
+    for(size_t i = 0; i < items; ++i)
+    {
+        problem.addObject(Constant("obj_" + toString(i), "physob_id"));
+    }
+    for(size_t i = 0; i < locations; ++i)
+    {
+        problem.addObject(Constant("loc_" + toString(i), "location"));
+    }
+
+    for(size_t i = 0; i < facts; ++i)
+    {
+        size_t item = i % items;
+        size_t other = i / items;
+        if(other % 2 == 0)
+        {
+            problem.addInitialStatus(Expression("at", "obj_" + toString(item), "loc_" + toString((other / 2) % locations)));
+        } else {
+            problem.addInitialStatus(Expression("connected", "obj_" + toString(item), "obj_" + toString((item + other / 2 + 1) % items)));
+        }
+    }
+    problem.setGoal(Expression("and", Expression("at", "obj_0", "loc_" + toString(locations - 1))));
+    return problem;
+}
+
+static void BM_DomainToLISP(benchmark::State& state)
+{
+    Domain domain = createDomain(state.range(0), state.range(1));
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(domain.toLISP());
+    }
+}
+BENCHMARK(BM_DomainToLISP)->Args({10, 2})->Args({100, 2})->Args({1000, 2})->Args({100, 8})->Args({100, 32});
+
+static void BM_DomainValidate(benchmark::State& state)
+{
+    Domain domain = createDomain(state.range(0), state.range(1));
+    for(auto _ : state)
+    {
+        domain.validate();
+    }
+}
+BENCHMARK(BM_DomainValidate)->Args({10, 2})->Args({100, 2})->Args({1000, 2})->Args({100, 8})->Args({100, 32});
+
+// Complete serialization, i.e. without the incremental cache of the problem
+static void BM_ProblemToLISP(benchmark::State& state)
+{
+    Problem problem = createProblem(state.range(0), state.range(1));
+    for(auto _ : state)
+    {
+        problem.invalidateCache();
+        benchmark::DoNotOptimize(problem.toLISP());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_ProblemToLISP)->Args({100, 1000})->Args({1000, 10000})->Args({5000, 100000});
+
+// Serialization after a single fact has changed, as it happens between replans
+static void BM_ProblemToLISPIncremental(benchmark::State& state)
+{
+    Problem problem = createProblem(state.range(0), state.range(1));
+    problem.toLISP();
+    Expression fact("at", "obj_0", "loc_0");
+    for(auto _ : state)
+    {
+        if(!problem.removeInitialStatus(fact))
+        {
+            problem.addInitialStatus(fact);
+        }
+        benchmark::DoNotOptimize(problem.toLISP());
+    }
+}
+BENCHMARK(BM_ProblemToLISPIncremental)->Args({100, 1000})->Args({1000, 10000})->Args({5000, 100000});
+
+static void BM_ProblemAddInitialStatus(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(createProblem(state.range(0), state.range(1)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_ProblemAddInitialStatus)->Args({1000, 10000})->Args({5000, 100000})->Unit(benchmark::kMillisecond);
+
+static void BM_ExpressionCopy(benchmark::State& state)
+{
+    Expression effect = createNestedEffect(state.range(0));
+    for(auto _ : state)
+    {
+        Expression copy(effect);
+        benchmark::DoNotOptimize(copy);
+    }
+}
+BENCHMARK(BM_ExpressionCopy)->Arg(2)->Arg(8)->Arg(32)->Arg(128);
+
+// Copy and modify the top level, as done when adding sub goals
+static void BM_ExpressionCopyModify(benchmark::State& state)
+{
+    Expression effect = createNestedEffect(state.range(0));
+    for(auto _ : state)
+    {
+        Expression copy(effect);
+        copy.addParameter(Expression("cannot_move", "?obj"));
+        benchmark::DoNotOptimize(copy);
+    }
+}
+BENCHMARK(BM_ExpressionCopyModify)->Arg(2)->Arg(8)->Arg(32)->Arg(128);
+
+static void BM_ExpressionFromString(benchmark::State& state)
+{
+    std::string text = createNestedEffect(state.range(0)).toLISP();
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(Expression::fromString(text));
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ExpressionFromString)->Arg(2)->Arg(8)->Arg(32);
+
+BENCHMARK_MAIN();
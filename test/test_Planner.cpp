@@ -2,6 +2,40 @@
 #include <pddl_planner/Planning.hpp>
 #include <pddl_planner/representation/Domain.hpp>
 #include <pddl_planner/representation/Problem.hpp>
+#include <pddl_planner/representation/Parser.hpp>
+#include <pddl_planner/WorkspaceManager.hpp>
+#include <pddl_planner/InputStore.hpp>
+#include <pddl_planner/BinaryRegistry.hpp>
+#include <pddl_planner/PlanCache.hpp>
+#include <pddl_planner/PortfolioScheduler.hpp>
+#include <pddl_planner/TranslationCache.hpp>
+#include <pddl_planner/ThreadPool.hpp>
+#include <pddl_planner/Process.hpp>
+#include <pddl_planner/ProcessPool.hpp>
+#include <pddl_planner/CoreAllocator.hpp>
+#include <pddl_planner/planners/Lama.hpp>
+#include <pddl_planner/planners/Gbfs.hpp>
+#include <pddl_planner/planners/GroundTask.hpp>
+#include <pddl_planner/planners/Remote.hpp>
+#include <pddl_planner/PlanningServer.hpp>
+#include <pddl_planner/Benchmark.hpp>
+#include <pddl_planner/Tracer.hpp>
+#include <pddl_planner/CompactPlan.hpp>
+#include <pddl_planner/PlanRanking.hpp>
+#include <pddl_planner/PlanValidator.hpp>
+#include <pddl_planner/ReachabilityAnalysis.hpp>
+#include <boost/unordered_set.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/assign/list_of.hpp>
+#include <atomic>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <sys/wait.h>
+
+static const std::string domainDescription = "(define (domain rimres)\n(:requirements :strips :equality :typing :conditional-effects)\n(:types location physob_id physob_type)\n(:constants sherpa crex payload - physob_type)\n(:predicates ( at ?x - physob_id ?l - location)\n( is_a ?x - physob_id ?r - physob_type)\n( connected ?x ?y - physob_id)\n( cannot_move ?x - physob_id)\n)\n\n(:action move\n :parameters (?obj - physob_id ?m ?l - location)\n:precondition ( and (at ?obj ?m) (not (= ?m ?l)) (not (cannot_move ?obj) ))\n :effect (and (at ?obj ?l) (not (at ?obj ?m))\n (forall (?z)\n (when (and (connected ?z ?obj) (not (= ?z ?obj)))\n (and (at ?z ?l) (not (at ?z ?m)))\n)))\n)\n (:action move_into_range\n :parameters (?x ?y - physob_id ?m ?l - location)\n :precondition (and (not (cannot_move ?x)) (at ?x ?m) (at ?y ?l) )\n :effect (and (at ?x ?l) (at ?y ?l) (not (at ?x ?m)))\n)\n (:action connect\n :parameters (?x ?y - physob_id ?l - location)\n :precondition (and (at ?x ?l) (at ?y ?l))\n :effect (and (connected ?x ?y) (cannot_move ?y))\n)\n(:action disconnect\n :parameters (?x ?y - physob_id)\n :precondition (and (not (= ?x ?y)) (connected ?x ?y)) \n :effect (and (not (connected ?x ?y)) (not (cannot_move ?y)))\n)\n)\n";
+static const std::string problemDescription = "(define (problem rimres-1)\n (:domain rimres)\n (:objects\n sherpa_0 crex_0 pl_0 - physob_id\n location_s0 location_c0 location_p0 - location\n mission1 - location\n)\n (:init \n (is_a sherpa_0 sherpa)\n (is_a crex_0 crex)\n (is_a pl_0 payload)\n (at sherpa_0 location_s0)\n (at crex_0 location_c0)\n (at pl_0 location_p0)\n (cannot_move pl_0)\n)\n (:goal (and \n (connected sherpa_0 crex_0) \n (connected sherpa_0 pl_0)\n (at sherpa_0 mission1)\n)\n)\n)\n";
 
 BOOST_AUTO_TEST_CASE(main_lama_test)
 {
@@ -9,14 +43,11 @@ BOOST_AUTO_TEST_CASE(main_lama_test)
     using namespace pddl_planner;
     Planning planning;
 
-    std::string domainDescription = "(define (domain rimres)\n(:requirements :strips :equality :typing :conditional-effects)\n(:types location physob_id physob_type)\n(:constants sherpa crex payload - physob_type)\n(:predicates ( at ?x - physob_id ?l - location)\n( is_a ?x - physob_id ?r - physob_type)\n( connected ?x ?y - physob_id)\n( cannot_move ?x - physob_id)\n)\n\n(:action move\n :parameters (?obj - physob_id ?m ?l - location)\n:precondition ( and (at ?obj ?m) (not (= ?m ?l)) (not (cannot_move ?obj) ))\n :effect (and (at ?obj ?l) (not (at ?obj ?m))\n (forall (?z)\n (when (and (connected ?z ?obj) (not (= ?z ?obj)))\n (and (at ?z ?l) (not (at ?z ?m)))\n)))\n)\n (:action move_into_range\n :parameters (?x ?y - physob_id ?m ?l - location)\n :precondition (and (not (cannot_move ?x)) (at ?x ?m) (at ?y ?l) )\n :effect (and (at ?x ?l) (at ?y ?l) (not (at ?x ?m)))\n)\n (:action connect\n :parameters (?x ?y - physob_id ?l - location)\n :precondition (and (at ?x ?l) (at ?y ?l))\n :effect (and (connected ?x ?y) (cannot_move ?y))\n)\n(:action disconnect\n :parameters (?x ?y - physob_id)\n :precondition (and (not (= ?x ?y)) (connected ?x ?y)) \n :effect (and (not (connected ?x ?y)) (not (cannot_move ?y)))\n)\n)\n";
-
     planning.setDomainDescription("rimres",domainDescription);
 
     BOOST_TEST_MESSAGE( "Domain description \n" << domainDescription );
 
     try {
-        std::string problemDescription = "(define (problem rimres-1)\n (:domain rimres)\n (:objects\n sherpa_0 crex_0 pl_0 - physob_id\n location_s0 location_c0 location_p0 - location\n mission1 - location\n)\n (:init \n (is_a sherpa_0 sherpa)\n (is_a crex_0 crex)\n (is_a pl_0 payload)\n (at sherpa_0 location_s0)\n (at crex_0 location_c0)\n (at pl_0 location_p0)\n (cannot_move pl_0)\n)\n (:goal (and \n (connected sherpa_0 crex_0) \n (connected sherpa_0 pl_0)\n (at sherpa_0 mission1)\n)\n)\n)\n";
         BOOST_TEST_MESSAGE( "Domain description \n" << problemDescription );
 
         PlanCandidates planCandidates = planning.plan(problemDescription);
@@ -30,6 +61,1324 @@ BOOST_AUTO_TEST_CASE(main_lama_test)
     }
 }
 
+/**
+ * Wait until the timeout expires or the token is cancelled
+ * \return true if the token has been cancelled, false otherwise
+ */
+static bool wait_for_cancellation(double timeout, const pddl_planner::CancellationToken& token)
+{
+    boost::chrono::steady_clock::time_point deadline = boost::chrono::steady_clock::now() + boost::chrono::milliseconds((int) (1000. * timeout));
+    while(!token.isCancelled() && boost::chrono::steady_clock::now() < deadline)
+    {
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+    }
+    return token.isCancelled();
+}
+
+/**
+ * Planner which uses its complete timeout without finding a plan
+ */
+class SleepingPlanner : public pddl_planner::PDDLPlannerInterface
+{
+public:
+    std::string getName() const { return "SLEEPING"; }
+    std::string getCmd() const { return "sh"; }
+    int getVersion() const { return 1; }
+
+    pddl_planner::PlanCandidates plan(const std::string&, const std::string&, const std::string&, double timeout, const pddl_planner::CancellationToken& token, const pddl_planner::PlanCallback&)
+    {
+        pddl_planner::PlanCandidates planCandidates;
+        planCandidates.statistics.cancelled = wait_for_cancellation(timeout, token);
+        planCandidates.statistics.timedOut = !planCandidates.statistics.cancelled;
+        return planCandidates;
+    }
+};
+
+/**
+ * Planner which fails on every call
+ */
+class FailingPlanner : public pddl_planner::PDDLPlannerInterface
+{
+public:
+    std::string getName() const { return "FAILING"; }
+    std::string getCmd() const { return "sh"; }
+    int getVersion() const { return 1; }
+
+    pddl_planner::PlanCandidates plan(const std::string&, const std::string&, const std::string&, double, const pddl_planner::CancellationToken&, const pddl_planner::PlanCallback&)
+    {
+        throw pddl_planner::PlanGenerationException("FailingPlanner: planning failed");
+    }
+};
+
+/**
+ * Planner which reports a plan right away, but keeps on searching for better plans until
+ * its timeout expires
+ */
+class StreamingPlanner : public pddl_planner::PDDLPlannerInterface
+{
+public:
+    std::string getName() const { return "STREAMING"; }
+    std::string getCmd() const { return "sh"; }
+    int getVersion() const { return 1; }
+
+    pddl_planner::PlanCandidates plan(const std::string&, const std::string&, const std::string&, double timeout, const pddl_planner::CancellationToken& token, const pddl_planner::PlanCallback& callback)
+    {
+        pddl_planner::Action action("move");
+        action.addArgument("sherpa_0");
+        action.addArgument("mission1");
+        pddl_planner::Plan plan;
+        plan.addAction(action);
+
+        pddl_planner::PlanCandidates planCandidates;
+        planCandidates.addPlan(plan);
+        if(callback)
+        {
+            callback(plan);
+        }
+        planCandidates.statistics.cancelled = wait_for_cancellation(timeout, token);
+        planCandidates.statistics.timedOut = !planCandidates.statistics.cancelled;
+        return planCandidates;
+    }
+};
+
+/**
+ * Planner which runs a shell script instead of a planner executable -- the script waits for
+ * the given delay and writes two plans of the test problem, just like an anytime planner
+ */
+class ScriptPlanner : public pddl_planner::PDDLPlannerInterface
+{
+public:
+    ScriptPlanner(const std::string& name = "SCRIPT", double delay = 0.0)
+        : mName(name)
+        , mDelay(delay)
+    {
+        msResultFileBasename = "result";
+    }
+
+    std::string getName() const { return mName; }
+    std::string getCmd() const { return "sh"; }
+    int getVersion() const { return 1; }
+
+    pddl_planner::PlanCandidates plan(const std::string& problem, const std::string& actions, const std::string& domain, double timeout, const pddl_planner::CancellationToken& token, const pddl_planner::PlanCallback& callback)
+    {
+        static const std::string script = "sleep $2\n"
+            "printf '(move sherpa_0 location_s0 location_p0)\\n(connect sherpa_0 pl_0 location_p0)\\n(move sherpa_0 location_p0 location_c0)\\n"
+            "(connect sherpa_0 crex_0 location_c0)\\n(move sherpa_0 location_c0 mission1)\\n; cost = 5 (unit cost)\\n' > \"$1.1\"\n"
+            "printf '(move sherpa_0 location_s0 location_c0)\\n(connect sherpa_0 crex_0 location_c0)\\n(move sherpa_0 location_c0 location_p0)\\n"
+            "(connect sherpa_0 pl_0 location_p0)\\n(move sherpa_0 location_p0 mission1)\\n; cost = 5 (unit cost)\\n' > \"$1.2\"\n";
+
+        pddl_planner::PlannerCall call = prepare("script", problem, actions, domain, timeout);
+        std::stringstream delay;
+        delay << mDelay;
+        std::vector<std::string> arguments = boost::assign::list_of<std::string>("sh")("-c")(script)("sh")(call.resultFilename)(delay.str());
+        pddl_planner::PlanCandidates planCandidates = generateCandidates(arguments, call.tempDir, call.resultFilename, call.timeout, getName(), token, callback);
+        cleanup(call, std::list<std::string>());
+        return planCandidates;
+    }
+
+private:
+    std::string mName;
+    double mDelay;
+};
+
+/**
+ * Set the concurrency of the default pool for the lifetime of this object
+ */
+struct ConcurrencyLimit
+{
+    ConcurrencyLimit(size_t concurrency)
+        : previous(pddl_planner::ThreadPool::getDefault().getConcurrency())
+    {
+        pddl_planner::ThreadPool::getDefault().setConcurrency(concurrency);
+    }
+
+    ~ConcurrencyLimit()
+    {
+        pddl_planner::ThreadPool::getDefault().setConcurrency(previous);
+    }
+
+    size_t previous;
+};
+
+BOOST_AUTO_TEST_CASE(first_wins_test)
+{
+    using namespace pddl_planner;
+    // The planners of the portfolio need to run at the same time, regardless of the number of cores
+    ConcurrencyLimit limit(2);
+    Planning planning;
+    planning.setDomainDescription("rimres",domainDescription);
+    planning.registerPlanner(new SleepingPlanner());
+    planning.registerPlanner(new StreamingPlanner());
+
+    std::set<std::string> planners;
+    planners.insert("GBFS");
+    planners.insert("SLEEPING");
+
+    boost::filesystem::path workingDirectory = boost::filesystem::current_path();
+    PlanResultList planResultList = planning.planFirstWins(problemDescription, planners);
+    BOOST_REQUIRE_MESSAGE(workingDirectory == boost::filesystem::current_path(), "Planning leaves the working directory untouched");
+    BOOST_REQUIRE_MESSAGE(planResultList.size() == planners.size(), "First-wins planning provides a result for each planner");
+    BOOST_REQUIRE_MESSAGE(planResultList.front().first == "GBFS" && !planResultList.front().second.plans.empty(), "First-wins planning provides the winning solution first");
+    BOOST_REQUIRE(planResultList.back().second.statistics.cancelled);
+
+    // The first plan decides the winner, even though its planner keeps on searching
+    planners.erase("GBFS");
+    planners.insert("STREAMING");
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    planResultList = planning.planFirstWins(problemDescription, planners, 60.0, 0.2);
+    double elapsed = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+    BOOST_REQUIRE_MESSAGE(elapsed < 10.0, "First-wins planning returned after " << elapsed << " s");
+    BOOST_REQUIRE_EQUAL(planResultList.size(), planners.size());
+    BOOST_REQUIRE(planResultList.front().first == "STREAMING" && !planResultList.front().second.plans.empty());
+
+    BOOST_REQUIRE_THROW(planning.planFirstWins(problemDescription, std::set<std::string>({"GBFS", "UNKNOWN"})), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(gbfs_test)
+{
+    using namespace pddl_planner;
+    Planning planning;
+    planning.setDomainDescription("rimres",domainDescription);
+
+    BOOST_REQUIRE(planning.getAvailablePlanners().count("GBFS"));
+    PlanCandidates planCandidates = planning.plan(problemDescription, "GBFS");
+    BOOST_REQUIRE_EQUAL(planCandidates.plans.size(), 1);
+    BOOST_TEST_MESSAGE("GBFS plan: " << planCandidates.toString());
+
+    // Validate the plan by executing it on the ground task
+    representation::Domain domain = representation::Parser::parseDomain(domainDescription);
+    representation::Problem problem = representation::Parser::parseProblem(problemDescription, domain);
+    gbfs::GroundTask task(problem);
+    gbfs::State state = task.getInitialState();
+    BOOST_FOREACH(const Action& action, planCandidates.plans.front().action_sequence)
+    {
+        size_t a = 0;
+        for(; a < task.getActions().size(); ++a)
+        {
+            if(task.getActions()[a].action.toString() == action.toString())
+            {
+                break;
+            }
+        }
+        BOOST_REQUIRE_MESSAGE(a < task.getActions().size() && task.isApplicable(a, state), "Action is applicable: " << action.toString());
+        state = task.apply(a, state);
+    }
+    BOOST_REQUIRE(task.isGoal(state));
+
+    problem.setGoal(representation::Expression("at", "sherpa_0", "crex_0"));
+    gbfs::Planner planner;
+    BOOST_REQUIRE(planner.plan(problem, 5.0).plans.empty());
+
+    problem.setGoal(representation::Expression("unknown", "sherpa_0"));
+    BOOST_REQUIRE_THROW(planner.plan(problem, 5.0), PlanGenerationException);
+}
+
+BOOST_AUTO_TEST_CASE(planner_statistics_test)
+{
+    using namespace pddl_planner;
+    Planning planning;
+    planning.setDomainDescription("rimres", domainDescription);
+    planning.registerPlanner(new ScriptPlanner());
+
+    PlanCandidates planCandidates = planning.plan(problemDescription, "SCRIPT");
+    const PlannerStatistics& statistics = planCandidates.statistics;
+    BOOST_TEST_MESSAGE("SCRIPT: " << statistics.toString());
+    BOOST_REQUIRE_EQUAL(planCandidates.plans.size(), 2);
+    BOOST_REQUIRE_EQUAL(statistics.planCount, planCandidates.plans.size());
+    BOOST_REQUIRE(statistics.shortestPlanLength > 0 && statistics.shortestPlanLength <= statistics.longestPlanLength);
+    BOOST_REQUIRE(statistics.timeToFirstPlan >= 0 && statistics.timeToFirstPlan <= statistics.wallTime);
+    BOOST_REQUIRE(!statistics.timedOut && !statistics.cancelled && !statistics.cached);
+    BOOST_REQUIRE(WIFEXITED(statistics.exitStatus));
+    BOOST_REQUIRE(statistics.peakMemory > 0);
+
+    planCandidates = planning.plan(problemDescription, "GBFS");
+    BOOST_REQUIRE_EQUAL(planCandidates.statistics.planCount, 1);
+    BOOST_REQUIRE_EQUAL(planCandidates.statistics.shortestPlanLength, planCandidates.plans.front().action_sequence.size());
+    BOOST_REQUIRE_EQUAL(planCandidates.statistics.exitStatus, -1);
+
+    planning.enablePlanCache();
+    planning.plan(problemDescription, "GBFS");
+    BOOST_REQUIRE(planning.plan(problemDescription, "GBFS").statistics.cached);
+}
+
+BOOST_AUTO_TEST_CASE(portfolio_scheduler_test)
+{
+    using namespace pddl_planner;
+
+    PlannerStatistics solved;
+    solved.planCount = 1;
+    solved.timeToFirstPlan = 2.0;
+    PlannerStatistics unsolved;
+
+    PortfolioScheduler scheduler(0.5);
+    for(int i = 0; i < 4; ++i)
+    {
+        scheduler.record("domain", "LAMA", solved);
+        scheduler.record("domain", "BFSF", unsolved);
+    }
+    PlannerStatistics fast = solved;
+    fast.timeToFirstPlan = 1.0;
+    scheduler.record("domain", "FDSS1", fast);
+    PlannerStatistics cancelled;
+    cancelled.cancelled = true;
+    scheduler.record("domain", "FDSS1", cancelled);
+
+    BOOST_REQUIRE_EQUAL(scheduler.getRecord("domain", "LAMA").successes, 4);
+    BOOST_REQUIRE_EQUAL(scheduler.getRecord("domain", "FDSS1").runs, 1);
+    BOOST_REQUIRE_CLOSE(scheduler.getRecord("domain", "LAMA").getMeanSolveTime(), 2.0, 1e-6);
+
+    std::set<std::string> planners = boost::assign::list_of("BFSF")("FDSS1")("LAMA")("UNIFORM");
+    std::vector<std::string> ranked = scheduler.rank("domain", planners);
+    std::vector<std::string> expected = boost::assign::list_of("LAMA")("FDSS1")("UNIFORM")("BFSF");
+    BOOST_REQUIRE(ranked == expected);
+    // Ties are broken by the time to solution
+    scheduler.record("domain", "UNIFORM", solved);
+    BOOST_REQUIRE(scheduler.rank("domain", planners)[1] == "FDSS1");
+
+    PortfolioSchedule schedule = scheduler.scheduleSequential("domain", planners, 10.0);
+    double total = 0;
+    for(size_t i = 0; i < schedule.size(); ++i)
+    {
+        total += schedule[i].timeout;
+    }
+    BOOST_REQUIRE_CLOSE(total, 10.0, 1e-6);
+    BOOST_REQUIRE(schedule.front().planner == "LAMA" && schedule.front().timeout > schedule.back().timeout);
+    BOOST_REQUIRE_EQUAL(scheduler.scheduleSequential("domain", planners, 1.0).size(), 1);
+    BOOST_REQUIRE_EQUAL(scheduler.scheduleParallel("domain", planners, 2, 5.0).size(), 2);
+    BOOST_REQUIRE(scheduler.scheduleParallel("other", planners, 1, 5.0).front().planner == "BFSF");
+
+    boost::filesystem::path filename = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("pddl_planner_portfolio_%%%%%%");
+    scheduler.save(filename.string());
+    PortfolioScheduler restored;
+    restored.load(filename.string());
+    boost::filesystem::remove(filename);
+    BOOST_REQUIRE(restored.rank("domain", planners) == scheduler.rank("domain", planners));
+    BOOST_REQUIRE_THROW(restored.load(filename.string()), PlanGenerationException);
+
+    Planning planning;
+    planning.setDomainDescription("rimres", domainDescription);
+    PlanningOptions options;
+    options.mode = PlanningOptions::ADAPTIVE_SEQUENTIAL;
+    std::set<std::string> portfolio = boost::assign::list_of("GBFS")("LAMA");
+    PlanResultList results = planning.plan(problemDescription, portfolio, options);
+    BOOST_REQUIRE_EQUAL(results.size(), 1);
+    BOOST_REQUIRE(!results.front().second.plans.empty());
+    std::string key = PortfolioScheduler::createKey(planning.getDomainDescriptions(), planning.getActionDescriptions());
+    BOOST_REQUIRE_EQUAL(planning.getPortfolioScheduler()->getRecord(key, results.front().first).successes, 1);
+
+    options.mode = PlanningOptions::ADAPTIVE_PARALLEL;
+    options.portfolioSize = 1;
+    results = planning.plan(problemDescription, portfolio, options);
+    BOOST_REQUIRE_EQUAL(results.size(), 1);
+
+    // A failing planner is recorded as unsuccessful and the next planner takes over
+    Planning failingPlanning;
+    failingPlanning.setDomainDescription("rimres", domainDescription);
+    failingPlanning.registerPlanner(new FailingPlanner());
+    options.mode = PlanningOptions::ADAPTIVE_SEQUENTIAL;
+    results = failingPlanning.plan(problemDescription, boost::assign::list_of("FAILING")("GBFS"), options);
+    BOOST_REQUIRE_EQUAL(results.size(), 2);
+    BOOST_REQUIRE(results.front().first == "FAILING" && results.front().second.plans.empty());
+    BOOST_REQUIRE(results.back().first == "GBFS" && !results.back().second.plans.empty());
+    PlannerRecord record = failingPlanning.getPortfolioScheduler()->getRecord(key, "FAILING");
+    BOOST_REQUIRE(record.runs == 1 && record.successes == 0);
+}
+
+BOOST_AUTO_TEST_CASE(plan_batch_test)
+{
+    using namespace pddl_planner;
+    representation::Domain domain = representation::Parser::parseDomain(domainDescription);
+    representation::Problem problem = representation::Parser::parseProblem(problemDescription, domain);
+
+    std::vector<representation::Problem> problems;
+    problems.push_back(problem);
+    problem.setGoal(representation::Expression("connected", "sherpa_0", "crex_0"));
+    problems.push_back(problem);
+    problem.setGoal(representation::Expression("at", "sherpa_0", "crex_0"));
+    problems.push_back(problem);
+
+    Planning planning;
+    std::set<std::string> planners = boost::assign::list_of("GBFS");
+    std::vector<PlanResultList> results = planning.planBatch(domain, problems, planners);
+    BOOST_REQUIRE_EQUAL(results.size(), 3);
+    for(size_t i = 0; i < results.size(); ++i)
+    {
+        BOOST_REQUIRE_EQUAL(results[i].size(), 1);
+        BOOST_REQUIRE(results[i].front().first == "GBFS");
+    }
+    // Results are in input order
+    BOOST_REQUIRE(results[0].front().second.toString() == planning.plan(problems[0], "GBFS").toString());
+    BOOST_REQUIRE_EQUAL(results[1].front().second.plans.size(), 1);
+    BOOST_REQUIRE(results[1].front().second.plans.front().action_sequence.size() < results[0].front().second.plans.front().action_sequence.size());
+    BOOST_REQUIRE(results[2].front().second.plans.empty());
+
+    // Jobs which have not started before the deadline are skipped -- each job of the
+    // sleeping planner occupies a worker until the deadline, so the last job cannot start
+    planning.registerPlanner(new SleepingPlanner());
+    planners.insert("SLEEPING");
+    std::vector<std::string> descriptions(4 * ThreadPool::getDefault().getConcurrency(), problemDescription);
+    planning.setDomainDescription("rimres", domainDescription);
+    results = planning.planBatch(descriptions, planners, PlanningOptions(), 0.05);
+    BOOST_REQUIRE_EQUAL(results.size(), descriptions.size());
+    BOOST_REQUIRE(results.back().back().first == "SLEEPING");
+    BOOST_REQUIRE(results.back().back().second.statistics.cancelled);
+    BOOST_REQUIRE(results.front().back().second.statistics.timedOut);
+}
+
+static void plan_concurrently(pddl_planner::Planning* planning, std::set<std::string> planners, size_t* numberOfResults)
+{
+    *numberOfResults = planning->plan(problemDescription, planners).size();
+}
+
+BOOST_AUTO_TEST_CASE(reentrant_planning_test)
+{
+    using namespace pddl_planner;
+    Planning planning;
+    planning.setDomainDescription("rimres",domainDescription);
+    planning.registerPlanner(new ScriptPlanner());
+
+    std::set<std::string> planners;
+    planners.insert("GBFS");
+    planners.insert("SCRIPT");
+
+    // Results of one call must neither leak into subsequent nor into concurrent calls
+    BOOST_REQUIRE(planning.plan(problemDescription, planners).size() == planners.size());
+    BOOST_REQUIRE(planning.plan(problemDescription, planners, true).size() == planners.size());
+
+    std::vector<size_t> numberOfResults(4, 0);
+    boost::thread_group callers;
+    for(size_t i = 0; i < numberOfResults.size(); ++i)
+    {
+        callers.create_thread(boost::bind(plan_concurrently, &planning, planners, &numberOfResults[i]));
+    }
+    callers.join_all();
+    for(size_t i = 0; i < numberOfResults.size(); ++i)
+    {
+        BOOST_REQUIRE_MESSAGE(numberOfResults[i] == planners.size(), "Concurrent call " << i << " has " << numberOfResults[i] << " results");
+    }
+}
+
+static void on_completion(std::atomic<int>* completions, const pddl_planner::PlanningHandle& handle)
+{
+    if(handle.isDone())
+    {
+        ++(*completions);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(async_planning_test)
+{
+    using namespace pddl_planner;
+    Planning planning;
+    planning.setDomainDescription("rimres",domainDescription);
+    planning.registerPlanner(new ScriptPlanner());
+    planning.registerPlanner(new ScriptPlanner("SLOW_SCRIPT", 30.0));
+
+    std::atomic<int> completions(0);
+    PlanningHandle handle = planning.planAsync(problemDescription, std::set<std::string>({"SCRIPT"}));
+    handle.setCallback(boost::bind(on_completion, &completions, _1));
+    BOOST_REQUIRE_MESSAGE(handle.waitFor(5.0), "Asynchronous planning completes");
+    PlanResultList planResultList = handle.get();
+    BOOST_REQUIRE(planResultList.size() == 1);
+    BOOST_REQUIRE(!planResultList.front().second.plans.empty());
+    for(int i = 0; i < 100 && completions == 0; ++i)
+    {
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+    }
+    BOOST_REQUIRE_MESSAGE(completions == 1, "Completion callback called once");
+
+    // Cancellation has to kill the running planner instead of waiting for it
+    PlanningOptions options;
+    options.mode = PlanningOptions::FIRST_WINS;
+    options.timeout = 30.0;
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    handle = planning.planAsync(problemDescription, std::set<std::string>({"SLOW_SCRIPT"}), options);
+    BOOST_REQUIRE(!handle.waitFor(0.1));
+    handle.cancel();
+    BOOST_REQUIRE_MESSAGE(handle.waitFor(5.0), "Cancelled planning completes");
+    BOOST_REQUIRE(handle.isCancelled());
+    BOOST_REQUIRE(boost::chrono::steady_clock::now() - start < boost::chrono::seconds(3));
+
+    BOOST_REQUIRE_THROW(planning.planAsync(problemDescription, std::set<std::string>({"UNKNOWN"})), std::runtime_error);
+}
+
+static void on_plan(boost::mutex* mutex, std::vector<std::string>* planners, const pddl_planner::PlannerName& planner, const pddl_planner::Plan&)
+{
+    boost::unique_lock<boost::mutex> lock(*mutex);
+    planners->push_back(planner);
+}
+
+BOOST_AUTO_TEST_CASE(plan_streaming_test)
+{
+    using namespace pddl_planner;
+    Planning planning;
+    planning.setDomainDescription("rimres",domainDescription);
+    planning.registerPlanner(new ScriptPlanner());
+
+    boost::mutex mutex;
+    std::vector<std::string> streamed;
+    PlanningOptions options;
+    options.planCallback = boost::bind(on_plan, &mutex, &streamed, _1, _2);
+    PlanResultList planResultList = planning.plan(problemDescription, std::set<std::string>({"SCRIPT"}), options);
+
+    BOOST_REQUIRE(planResultList.size() == 1);
+    BOOST_REQUIRE_EQUAL(planResultList.front().second.plans.size(), 2);
+    BOOST_REQUIRE_MESSAGE(streamed.size() == planResultList.front().second.plans.size(), "Each plan has been streamed: " << streamed.size());
+    BOOST_REQUIRE(streamed.front() == "SCRIPT");
+}
+
+BOOST_AUTO_TEST_CASE(remote_planning_test)
+{
+    using namespace pddl_planner;
+    // Client and worker share the default pool, which has a single slot regardless of the
+    // number of cores -- the remote call must not take the slot the worker needs
+    ConcurrencyLimit limit(1);
+    Planning workerPlanning;
+    PlanningServer server(workerPlanning, 0, "127.0.0.1");
+    server.start();
+    BOOST_REQUIRE(server.getPort() != 0);
+    BOOST_REQUIRE_EQUAL(server.getQueueDepth(), 0);
+
+    std::stringstream endpoint;
+    endpoint << "127.0.0.1:" << server.getPort();
+    // The unreachable worker is skipped by the load balancing
+    std::vector<std::string> endpoints = boost::assign::list_of<std::string>("127.0.0.1:1")(endpoint.str());
+
+    Planning planning;
+    planning.setDomainDescription("rimres", domainDescription);
+    planning.registerPlanner(new remote::Planner("REMOTE_GBFS", "GBFS", endpoints));
+    BOOST_REQUIRE(planning.getAvailablePlanners().count("REMOTE_GBFS"));
+
+    std::atomic<int> streamed(0);
+    PlanningOptions options;
+    options.planCallback = [&streamed](const std::string&, const Plan&) { ++streamed; };
+    PlanResultList results = planning.plan(problemDescription, std::set<std::string>({"REMOTE_GBFS"}), options);
+    BOOST_REQUIRE_EQUAL(results.size(), 1);
+    BOOST_REQUIRE(results.front().second.toString() == planning.plan(problemDescription, "GBFS").toString());
+    BOOST_REQUIRE_EQUAL(streamed, 1);
+
+    // Errors of the worker are reported to the client
+    planning.registerPlanner(new remote::Planner("REMOTE_UNKNOWN", "UNKNOWN", endpoints));
+    BOOST_REQUIRE_THROW(planning.plan(problemDescription, "REMOTE_UNKNOWN"), std::runtime_error);
+
+    server.stop();
+    BOOST_REQUIRE(planning.getAvailablePlanners().count("REMOTE_GBFS") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_test)
+{
+    using namespace pddl_planner;
+    namespace fs = boost::filesystem;
+
+    fs::path corpus = fs::temp_directory_path() / fs::unique_path("pddl_planner_benchmark_test_%%%%%%");
+    fs::create_directories(corpus / "rimres");
+    std::ofstream((corpus / "rimres" / "domain.pddl").string().c_str()) << domainDescription;
+    std::ofstream((corpus / "rimres" / "p01.pddl").string().c_str()) << problemDescription;
+    std::ofstream((corpus / "p02-domain.pddl").string().c_str()) << domainDescription;
+    std::ofstream((corpus / "p02.pddl").string().c_str()) << problemDescription;
+    // Problems without domain are skipped
+    std::ofstream((corpus / "orphan.pddl").string().c_str()) << problemDescription;
+
+    std::vector<BenchmarkInstance> instances = Benchmark::findInstances(corpus.string());
+    BOOST_REQUIRE_EQUAL(instances.size(), 2);
+    BOOST_REQUIRE_EQUAL(instances[0].name, "p02.pddl");
+    BOOST_REQUIRE_EQUAL(instances[0].domainFilename, (corpus / "p02-domain.pddl").string());
+    BOOST_REQUIRE_EQUAL(instances[1].name, "rimres/p01.pddl");
+    BOOST_REQUIRE_EQUAL(instances[1].domainFilename, (corpus / "rimres" / "domain.pddl").string());
+
+    Benchmark benchmark(std::set<std::string>({"GBFS"}), 5.0, 2);
+    benchmark.run(instances);
+    BOOST_REQUIRE_EQUAL(benchmark.getRuns().size(), 2 * 3 * 2);
+
+    std::vector<BenchmarkSummary> summaries = benchmark.summarize();
+    BOOST_REQUIRE_EQUAL(summaries.size(), 2 * 3);
+    BOOST_FOREACH(const BenchmarkSummary& summary, summaries)
+    {
+        BOOST_REQUIRE_EQUAL(summary.runs, 2);
+        BOOST_REQUIRE_EQUAL(summary.getSuccessRate(), 1.0);
+        BOOST_REQUIRE(summary.bestPlanLength > 0);
+        BOOST_REQUIRE(summary.meanTimeToFirstPlan >= 0 && summary.meanTimeToFirstPlan <= summary.meanWallTime);
+    }
+
+    std::stringstream csv;
+    benchmark.writeCSV(csv);
+    std::string line;
+    size_t lines = 0;
+    while(std::getline(csv, line))
+    {
+        ++lines;
+    }
+    BOOST_REQUIRE_EQUAL(lines, 1 + summaries.size());
+
+    std::stringstream json;
+    benchmark.writeJSON(json);
+    BOOST_REQUIRE(json.str().find("\"mode\": \"first-wins\"") != std::string::npos);
+
+    BOOST_REQUIRE_THROW(Benchmark::findInstances((corpus / "missing").string()), PlanGenerationException);
+    fs::remove_all(corpus);
+}
+
+BOOST_AUTO_TEST_CASE(tracing_test)
+{
+    using namespace pddl_planner;
+    Planning planning;
+    planning.setDomainDescription("rimres", domainDescription);
+    planning.registerPlanner(new ScriptPlanner());
+    Tracer& tracer = Tracer::getInstance();
+    tracer.clear();
+
+    // Nothing is recorded unless tracing is enabled
+    BOOST_REQUIRE(!planning.plan(problemDescription, "SCRIPT").plans.empty());
+    BOOST_REQUIRE(tracer.getEvents().empty());
+
+    std::atomic<int> forwarded(0);
+    tracer.setCallback([&forwarded](const TraceEvent&) { ++forwarded; });
+    planning.enableTracing();
+    BOOST_REQUIRE(!planning.plan(problemDescription, "SCRIPT").plans.empty());
+    planning.disableTracing();
+    tracer.setCallback(TraceCallback());
+
+    std::vector<TraceEvent> events = tracer.getEvents();
+    BOOST_REQUIRE_EQUAL((size_t) forwarded, events.size());
+    std::set<std::string> stages;
+    BOOST_FOREACH(const TraceEvent& event, events)
+    {
+        stages.insert(event.name);
+    }
+    std::vector<std::string> expectedStages = boost::assign::list_of<std::string>("request")("planner")("workspace")("write inputs")("process start")("search")("scan results")("read plan");
+    BOOST_FOREACH(const std::string& stage, expectedStages)
+    {
+        BOOST_REQUIRE_MESSAGE(stages.count(stage), "Stage has been traced: " << stage);
+    }
+
+    // Spans are completed inside out, so the request span comes last and contains the others --
+    // except for the serialization of the domain, which precedes the request
+    const TraceEvent& request = events.back();
+    BOOST_REQUIRE_EQUAL(std::string(request.name), "request");
+    BOOST_FOREACH(const TraceEvent& event, events)
+    {
+        if(std::string(event.name) != "serialize domain")
+        {
+            BOOST_REQUIRE(event.start >= request.start && event.start + event.duration <= request.start + request.duration);
+        }
+    }
+
+    std::stringstream trace;
+    tracer.writeChromeTrace(trace);
+    BOOST_REQUIRE(trace.str().find("\"name\":\"search\"") != std::string::npos);
+    BOOST_REQUIRE(trace.str().find("\"ph\":\"X\"") != std::string::npos);
+
+    // The capacity limits the spans kept in memory
+    tracer.clear();
+    tracer.enable(1);
+    {
+        TraceSpan first("first");
+        TraceSpan second("second");
+    }
+    tracer.disable();
+    BOOST_REQUIRE_EQUAL(tracer.getEvents().size(), 1);
+    BOOST_REQUIRE_EQUAL(tracer.getDropped(), 1);
+    tracer.clear();
+}
+
+BOOST_AUTO_TEST_CASE(compact_plan_test)
+{
+    using namespace pddl_planner;
+    Planning planning;
+    planning.setDomainDescription("rimres", domainDescription);
+    PlanCandidates planCandidates = planning.plan(problemDescription, "GBFS");
+    BOOST_REQUIRE(!planCandidates.plans.empty());
+    const Plan& plan = planCandidates.plans.front();
+
+    representation::Domain domain = representation::Parser::parseDomain(domainDescription);
+    SymbolTablePtr symbols(new SymbolTable(domain));
+    BOOST_REQUIRE_EQUAL(symbols->size(), domain.actions.size() + domain.constants.size());
+
+    CompactPlan compactPlan(plan, symbols);
+    BOOST_REQUIRE_EQUAL(compactPlan.size(), plan.action_sequence.size());
+    BOOST_REQUIRE_EQUAL(compactPlan.toPlan().toString(), plan.toString());
+    BOOST_REQUIRE_EQUAL(symbols->getSymbol(compactPlan.getActionId(0)), plan.action_sequence.front().name);
+    size_t count = 0;
+    compactPlan.getArgumentIds(0, count);
+    BOOST_REQUIRE_EQUAL(count, plan.action_sequence.front().arguments.size());
+
+    // Equal plans have equal hashes, even with different symbol tables
+    SymbolTablePtr otherSymbols(new SymbolTable());
+    otherSymbols->intern("unrelated");
+    CompactPlan otherPlan(plan, otherSymbols);
+    BOOST_REQUIRE(compactPlan == otherPlan);
+    BOOST_REQUIRE_EQUAL(compactPlan.getHash(), otherPlan.getHash());
+
+    // Plans differing in the split of arguments are different
+    Plan first, second;
+    Action move("move"), connect("connect");
+    move.addArgument("a");
+    move.addArgument("b");
+    connect.addArgument("c");
+    first.addAction(move);
+    first.addAction(connect);
+    move.arguments.pop_back();
+    connect.arguments.insert(connect.arguments.begin(), "b");
+    second.addAction(move);
+    second.addAction(connect);
+    BOOST_REQUIRE(CompactPlan(first, symbols) != CompactPlan(second, symbols));
+
+    boost::unordered_set<CompactPlan> plans;
+    plans.insert(compactPlan);
+    plans.insert(otherPlan);
+    plans.insert(CompactPlan(first, symbols));
+    BOOST_REQUIRE_EQUAL(plans.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(plan_ranking_test)
+{
+    using namespace pddl_planner;
+    Action move("move"), connect("connect");
+    move.addArgument("sherpa_0");
+    move.addArgument("mission1");
+    connect.addArgument("sherpa_0");
+    connect.addArgument("crex_0");
+
+    Plan shortPlan, longPlan, costlyPlan;
+    shortPlan.addAction(move);
+    longPlan.addAction(connect);
+    longPlan.addAction(move);
+    longPlan.cost = 1;
+    costlyPlan.addAction(connect);
+    costlyPlan.cost = 5;
+
+    PlanResultList planResultList;
+    PlanCandidates lamaCandidates, bfsCandidates;
+    lamaCandidates.addPlan(shortPlan);
+    lamaCandidates.addPlan(longPlan);
+    // Same plan with a different cost
+    Plan cheaperPlan = longPlan;
+    cheaperPlan.cost = 0.5;
+    bfsCandidates.addPlan(cheaperPlan);
+    bfsCandidates.addPlan(costlyPlan);
+    bfsCandidates.addPlan(shortPlan);
+    planResultList.push_back(PlanResult("LAMA", lamaCandidates));
+    planResultList.push_back(PlanResult("BFS", bfsCandidates));
+
+    RankedPlanList rankedPlans = PlanRanking::rank(planResultList);
+    BOOST_REQUIRE_EQUAL(rankedPlans.size(), 3);
+    BOOST_REQUIRE_EQUAL(rankedPlans[0].plan.toString(), longPlan.toString());
+    BOOST_REQUIRE_EQUAL(rankedPlans[0].plan.cost, 0.5);
+    BOOST_REQUIRE_EQUAL(rankedPlans[0].planners.size(), 2);
+    BOOST_REQUIRE_EQUAL(rankedPlans[0].planners[0], "LAMA");
+    BOOST_REQUIRE_EQUAL(rankedPlans[0].planners[1], "BFS");
+    // Without reported cost, the plan has unit cost
+    BOOST_REQUIRE_EQUAL(rankedPlans[1].plan.toString(), shortPlan.toString());
+    BOOST_REQUIRE_EQUAL(rankedPlans[1].getCost(), 1);
+    BOOST_REQUIRE_EQUAL(rankedPlans[2].plan.toString(), costlyPlan.toString());
+    BOOST_REQUIRE_EQUAL(rankedPlans[2].planners.size(), 1);
+    BOOST_REQUIRE_EQUAL(rankedPlans[2].planners[0], "BFS");
+
+    rankedPlans = PlanRanking::rank(planResultList, PlanRanking::BY_LENGTH);
+    BOOST_REQUIRE_EQUAL(rankedPlans.size(), 3);
+    // Equal length, so the lower cost comes first
+    BOOST_REQUIRE_EQUAL(rankedPlans[0].plan.toString(), shortPlan.toString());
+    BOOST_REQUIRE_EQUAL(rankedPlans[1].plan.toString(), costlyPlan.toString());
+    BOOST_REQUIRE_EQUAL(rankedPlans[2].plan.toString(), longPlan.toString());
+
+    PlanCandidates planCandidates = PlanRanking::toCandidates(rankedPlans);
+    BOOST_REQUIRE_EQUAL(planCandidates.plans.size(), 3);
+    BOOST_REQUIRE_EQUAL(planCandidates.statistics.shortestPlanLength, 1);
+    BOOST_REQUIRE_EQUAL(planCandidates.statistics.longestPlanLength, 2);
+
+    BOOST_REQUIRE(PlanRanking::rank(PlanResultList()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(plan_repair_test)
+{
+    using namespace pddl_planner;
+    using namespace pddl_planner::representation;
+
+    Domain domain = Parser::parseDomain(domainDescription);
+    Problem problem = Parser::parseProblem(problemDescription, domain);
+
+    Plan plan;
+    std::string actions[] = { "move sherpa_0 location_s0 location_c0", "connect sherpa_0 crex_0 location_c0", "move sherpa_0 location_c0 location_p0", "connect sherpa_0 pl_0 location_p0", "move sherpa_0 location_p0 mission1" };
+    for(size_t i = 0; i < 5; ++i)
+    {
+        std::vector<std::string> tokens;
+        boost::split(tokens, actions[i], boost::is_any_of(" "));
+        pddl_planner::Action action(tokens.front());
+        action.arguments.assign(tokens.begin() + 1, tokens.end());
+        plan.addAction(action);
+    }
+
+    {
+        PlanValidator validator(problem);
+        BOOST_REQUIRE(validator.validate(plan));
+        Plan suffix;
+        BOOST_REQUIRE(validator.findValidSuffix(plan, 0, suffix));
+        BOOST_REQUIRE_EQUAL(suffix.action_sequence.size(), 5);
+        // Moving the payload is not possible
+        plan.action_sequence[2].arguments[0] = "pl_0";
+        BOOST_REQUIRE(!validator.validate(plan));
+        plan.action_sequence[2].arguments[0] = "sherpa_0";
+    }
+
+    // The first move has been executed
+    problem.removeInitialStatus(Expression("at", "sherpa_0", "location_s0"));
+    problem.addInitialStatus(Expression("at", "sherpa_0", "location_c0"));
+
+    Planning planning;
+    std::set<std::string> planners;
+    planners.insert("GBFS");
+    PlanResultList planResultList = planning.replan(problem, plan, planners, PlanningOptions(), 1);
+    BOOST_REQUIRE_EQUAL(planResultList.size(), 1);
+    BOOST_REQUIRE_EQUAL(planResultList.front().first, REPAIRED_PLAN);
+    BOOST_REQUIRE_EQUAL(planResultList.front().second.plans.size(), 1);
+    const Plan& suffix = planResultList.front().second.plans.front();
+    BOOST_REQUIRE_EQUAL(suffix.action_sequence.size(), 4);
+    BOOST_REQUIRE_EQUAL(suffix.action_sequence.front().toString(), "connect sherpa_0 crex_0 location_c0");
+
+    // The payload has been moved, so the previous plan cannot reach the goal anymore
+    problem.removeInitialStatus(Expression("at", "pl_0", "location_p0"));
+    problem.addInitialStatus(Expression("at", "pl_0", "location_s0"));
+    planResultList = planning.replan(problem, plan, planners, PlanningOptions(), 1);
+    BOOST_REQUIRE_EQUAL(planResultList.size(), 1);
+    BOOST_REQUIRE_EQUAL(planResultList.front().first, "GBFS");
+    BOOST_REQUIRE(!planResultList.front().second.plans.empty());
+    PlanValidator validator(problem);
+    BOOST_REQUIRE(validator.validate(planResultList.front().second.plans.front()));
+}
+
+BOOST_AUTO_TEST_CASE(reachability_check_test)
+{
+    using namespace pddl_planner;
+    using namespace pddl_planner::representation;
+
+    Domain domain = Parser::parseDomain(domainDescription);
+    Problem problem = Parser::parseProblem(problemDescription, domain);
+    {
+        ReachabilityAnalysis analysis(problem);
+        BOOST_REQUIRE(!analysis.isUnsolvable());
+        BOOST_REQUIRE(analysis.getReachablePredicates().count("connected"));
+    }
+
+    // No action changes the type of an object
+    Problem unsolvable = problem;
+    unsolvable.setGoal(Expression("and", problem.goal, Expression("is_a", "sherpa_0", "crex")));
+    BOOST_REQUIRE(ReachabilityAnalysis(unsolvable).isUnsolvable());
+
+    Problem unknownObject = problem;
+    unknownObject.setGoal(Expression("and", problem.goal, Expression("at", "robot_0", "mission1")));
+    BOOST_REQUIRE(ReachabilityAnalysis(unknownObject).isUnsolvable());
+
+    // Without connect, the goal cannot be reached
+    Domain reducedDomain = domain;
+    reducedDomain.removeAction("connect");
+    BOOST_REQUIRE(ReachabilityAnalysis(reducedDomain, problem).isUnsolvable());
+
+    Planning planning;
+    planning.registerPlanner(new ScriptPlanner());
+    planning.enableReachabilityCheck();
+    std::set<std::string> planners;
+    planners.insert("GBFS");
+    planners.insert("SCRIPT");
+    PlanResultList planResultList = planning.plan(unsolvable, planners, false, 60.0);
+    BOOST_REQUIRE_EQUAL(planResultList.size(), 2);
+    BOOST_FOREACH(const PlanResult& result, planResultList)
+    {
+        BOOST_REQUIRE(result.second.plans.empty());
+        BOOST_REQUIRE(result.second.statistics.unsolvable);
+    }
+    BOOST_REQUIRE_THROW(planning.plan(unsolvable, "NOT_A_PLANNER"), std::runtime_error);
+
+    std::vector<Problem> problems;
+    problems.push_back(unsolvable);
+    problems.push_back(problem);
+    std::set<std::string> gbfs;
+    gbfs.insert("GBFS");
+    std::vector<PlanResultList> results = planning.planBatch(domain, problems, gbfs);
+    BOOST_REQUIRE_EQUAL(results.size(), 2);
+    BOOST_REQUIRE(results[0].front().second.statistics.unsolvable);
+    BOOST_REQUIRE(!results[1].front().second.statistics.unsolvable);
+    BOOST_REQUIRE(!results[1].front().second.plans.empty());
+
+    PlanCandidates planCandidates = planning.plan(problem, "GBFS");
+    BOOST_REQUIRE(!planCandidates.statistics.unsolvable);
+    BOOST_REQUIRE(!planCandidates.plans.empty());
+
+    // The stub planner does not detect unsolvable problems on its own
+    planning.disableReachabilityCheck();
+    BOOST_REQUIRE(!planning.plan(unsolvable, "SCRIPT", 1.0).statistics.unsolvable);
+}
+
+BOOST_AUTO_TEST_CASE(read_plan_test)
+{
+    using namespace pddl_planner;
+
+    std::string filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("plan-%%%%%%")).string();
+    std::string longArgument(5000, 'x');
+    {
+        std::ofstream out(filename.c_str());
+        out << "(move sherpa_0 location_s0 location_c0)" << std::endl;
+        out << std::endl;
+        out << "  ( connect\tsherpa_0  crex_0 )  ; trailing comment" << std::endl;
+        out << "(noop)" << std::endl;
+        out << "(transport " << longArgument << " l1)" << std::endl;
+        out << "; cost = 3 (unit cost)";
+    }
+
+    lama::Planner planner;
+    Plan plan = planner.readPlan("LAMA", filename);
+    boost::filesystem::remove(filename);
+
+    BOOST_REQUIRE_EQUAL(plan.action_sequence.size(), 4);
+    BOOST_REQUIRE_EQUAL(plan.action_sequence[0].toString(), "move sherpa_0 location_s0 location_c0");
+    BOOST_REQUIRE_EQUAL(plan.action_sequence[1].toString(), "connect sherpa_0 crex_0");
+    BOOST_REQUIRE_EQUAL(plan.action_sequence[2].name, "noop");
+    BOOST_REQUIRE(plan.action_sequence[2].arguments.empty());
+    BOOST_REQUIRE_EQUAL(plan.action_sequence[3].arguments.size(), 2);
+    BOOST_REQUIRE_EQUAL(plan.action_sequence[3].arguments[0], longArgument);
+    BOOST_REQUIRE(plan.hasCost());
+    BOOST_REQUIRE_EQUAL(plan.cost, 3);
+
+    BOOST_REQUIRE_THROW(planner.readPlan("LAMA", filename), PlanGenerationException);
+}
+
+BOOST_AUTO_TEST_CASE(workspace_test)
+{
+    using namespace pddl_planner;
+    namespace fs = boost::filesystem;
+
+    fs::path root = fs::temp_directory_path() / fs::unique_path("pddl_planner_test_%%%%%%");
+    fs::create_directory(root);
+    {
+        WorkspaceManager workspaceManager(root.string(), 1);
+        std::string workspace0 = workspaceManager.acquire("test");
+        std::string workspace1 = workspaceManager.acquire("test");
+        BOOST_REQUIRE_MESSAGE(workspace0 != workspace1, "Workspaces are unique: " << workspace0);
+        BOOST_REQUIRE(fs::is_directory(workspace0) && fs::is_directory(workspace1));
+        BOOST_REQUIRE(fs::path(workspace0).parent_path() == root);
+
+        std::ofstream out((workspace0 + "/plan.1").c_str());
+        out << "(connect sherpa_0 crex_0 location_c0)";
+        out.close();
+
+        workspaceManager.release(workspace0);
+        workspaceManager.release(workspace1);
+
+        // A lease releases its workspace when the planner call fails
+        try {
+            WorkspaceLease lease("failing", workspaceManager);
+            BOOST_REQUIRE(fs::is_directory(lease.getPath()));
+            throw PlanGenerationException("planner failed");
+        } catch(const PlanGenerationException& e)
+        {}
+        WorkspaceLease lease("released", workspaceManager);
+        lease.release();
+        lease.release();
+    }
+    BOOST_REQUIRE_MESSAGE(fs::is_empty(root), "Workspaces are removed");
+    fs::remove_all(root);
+}
+
+BOOST_AUTO_TEST_CASE(binary_registry_test)
+{
+    using namespace pddl_planner;
+    BinaryRegistry& registry = BinaryRegistry::getInstance();
+
+    std::string sh = registry.resolve("sh");
+    BOOST_REQUIRE_MESSAGE(boost::filesystem::path(sh).is_absolute(), "Executable resolved to absolute path: " << sh);
+    BOOST_REQUIRE(registry.resolve("sh") == sh);
+    BOOST_REQUIRE(!registry.isAvailable("pddl_planner-nonexisting-planner"));
+    registry.refresh();
+    BOOST_REQUIRE(registry.resolve("sh") == sh);
+}
+
+BOOST_AUTO_TEST_CASE(plan_cache_test)
+{
+    using namespace pddl_planner;
+
+    std::string key = PlanCache::createKey("LAMA", domainDescription, "", problemDescription);
+    BOOST_REQUIRE_MESSAGE(key == PlanCache::createKey("LAMA", "; comment\n" + domainDescription + "\n\n", "", problemDescription), "Key ignores comments and whitespace");
+    BOOST_REQUIRE(PlanCache::createKey("(at  a b )", "", "", "") == PlanCache::createKey("( at a\tb)", "", "", ""));
+    BOOST_REQUIRE(key != PlanCache::createKey("BFSF", domainDescription, "", problemDescription));
+    BOOST_REQUIRE(PlanCache::createKey("(at a b)", "", "", "") != PlanCache::createKey("(at ab)", "", "", ""));
+    std::string request = PlanCache::createRequest("LAMA", domainDescription, "", problemDescription);
+    BOOST_REQUIRE(request == PlanCache::createRequest("LAMA", "; comment\n" + domainDescription + "\n\n", "", problemDescription));
+
+    Action action("move");
+    action.addArgument("sherpa_0");
+    action.addArgument("location_s0");
+    Plan plan;
+    plan.addAction(action);
+    PlanCandidates planCandidates;
+    planCandidates.addPlan(plan);
+
+    PlanCache cache(2);
+    PlanCandidates cached;
+    BOOST_REQUIRE(!cache.lookup("a", cached));
+    cache.store("a", planCandidates);
+    cache.store("b", planCandidates);
+    BOOST_REQUIRE(cache.lookup("a", cached));
+    BOOST_REQUIRE(cached.toString() == planCandidates.toString());
+    // 'b' is the least recently used entry now
+    cache.store("c", planCandidates);
+    BOOST_REQUIRE(cache.size() == 2);
+    BOOST_REQUIRE(!cache.lookup("b", cached));
+    BOOST_REQUIRE(cache.lookup("c", cached));
+    BOOST_REQUIRE(cache.getHits() == 2);
+    BOOST_REQUIRE(cache.getMisses() == 2);
+    BOOST_REQUIRE(cache.contains("c"));
+    BOOST_REQUIRE(!cache.contains("b"));
+    BOOST_REQUIRE(cache.getHits() == 2);
+    BOOST_REQUIRE(cache.getMisses() == 2);
+
+    boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("pddl_planner_cache_test_%%%%%%");
+    {
+        PlanCache persistentCache(1, directory.string());
+        persistentCache.store(request, planCandidates);
+    }
+    {
+        PlanCache persistentCache(1, directory.string());
+        PlanCandidates restored;
+        BOOST_REQUIRE_MESSAGE(persistentCache.lookup(request, restored), "Plan restored from disk");
+        BOOST_REQUIRE_MESSAGE(restored.toString() == planCandidates.toString(), restored.toString());
+
+        // A colliding key of another request is a cache miss
+        std::string otherRequest = PlanCache::createRequest("BFSF", domainDescription, "", problemDescription);
+        std::string otherKey = PlanCache::createKey("BFSF", domainDescription, "", problemDescription);
+        boost::filesystem::copy_file(directory / (key + ".plans"), directory / (otherKey + ".plans"));
+        BOOST_REQUIRE(!persistentCache.lookup(otherRequest, restored));
+
+        persistentCache.clear();
+        BOOST_REQUIRE(!persistentCache.lookup(request, restored));
+    }
+    boost::filesystem::remove_all(directory);
+
+    Planning planning;
+    planning.setDomainDescription("rimres", domainDescription);
+    planning.enablePlanCache();
+    PlanCandidates planned = planning.plan(problemDescription, "GBFS");
+    BOOST_REQUIRE(planning.plan(problemDescription, "GBFS").toString() == planned.toString());
+    BOOST_REQUIRE(planning.getPlanCache()->getHits() == 1);
+
+    // The first-wins scan for a cached solution counts a single miss per planner
+    planning.getPlanCache()->clear();
+    uint64_t misses = planning.getPlanCache()->getMisses();
+    planning.planFirstWins(problemDescription, std::set<std::string>({"GBFS"}));
+    BOOST_REQUIRE_EQUAL(planning.getPlanCache()->getMisses(), misses + 1);
+    PlanResultList planResultList = planning.planFirstWins(problemDescription, std::set<std::string>({"GBFS"}));
+    BOOST_REQUIRE_EQUAL(planning.getPlanCache()->getMisses(), misses + 1);
+    BOOST_REQUIRE_EQUAL(planning.getPlanCache()->getHits(), 2);
+    // A cached solution is reported with the statistics of a cached result
+    const PlannerStatistics& statistics = planResultList.front().second.statistics;
+    BOOST_REQUIRE(statistics.cached && statistics.wallTime == 0 && statistics.planCount == 1);
+}
+
+BOOST_AUTO_TEST_CASE(input_store_test)
+{
+    using namespace pddl_planner;
+    namespace fs = boost::filesystem;
+
+    fs::path workspace = fs::temp_directory_path() / fs::unique_path("pddl_planner_input_test_%%%%%%");
+    fs::create_directories(workspace);
+
+    InputStore store(1);
+    BOOST_REQUIRE(store.provide(domainDescription, (workspace / "domain0.pddl").string()));
+    BOOST_REQUIRE(store.provide(domainDescription, (workspace / "domain1.pddl").string()));
+    BOOST_REQUIRE_EQUAL(store.getWrites(), 1);
+    BOOST_REQUIRE_EQUAL(store.getLinks(), 2);
+    BOOST_REQUIRE(fs::equivalent(workspace / "domain0.pddl", workspace / "domain1.pddl"));
+
+    std::ifstream in((workspace / "domain1.pddl").string().c_str());
+    std::stringstream content;
+    content << in.rdbuf();
+    BOOST_REQUIRE(content.str() == domainDescription);
+
+    // An existing file is replaced and the least recently used content is evicted
+    BOOST_REQUIRE(store.provide(problemDescription, (workspace / "domain1.pddl").string()));
+    BOOST_REQUIRE_EQUAL(fs::file_size(workspace / "domain1.pddl"), problemDescription.size());
+    BOOST_REQUIRE(store.provide(domainDescription, (workspace / "domain2.pddl").string()));
+    BOOST_REQUIRE_EQUAL(store.getWrites(), 3);
+    BOOST_REQUIRE_EQUAL(fs::file_size(workspace / "domain0.pddl"), domainDescription.size());
+    fs::remove_all(workspace);
+}
+
+static bool write_translation(std::atomic<int>* calls, const std::string& filename)
+{
+    ++(*calls);
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
+    std::ofstream out(filename.c_str());
+    out << "begin_version\n3\nend_version\n";
+    return true;
+}
+
+static void provide_translation(pddl_planner::TranslationCache* cache, const std::string& request, const std::string& filename, std::atomic<int>* calls)
+{
+    cache->provide(request, filename, boost::bind(write_translation, calls, _1));
+}
+
+BOOST_AUTO_TEST_CASE(translation_cache_test)
+{
+    using namespace pddl_planner;
+    namespace fs = boost::filesystem;
+
+    fs::path directory = fs::temp_directory_path() / fs::unique_path("pddl_planner_translation_cache_test_%%%%%%");
+    fs::path workspace = fs::temp_directory_path() / fs::unique_path("pddl_planner_translation_test_%%%%%%");
+    fs::create_directories(workspace);
+
+    std::string request = TranslationCache::createRequest(domainDescription, "", problemDescription);
+    std::string otherRequest = TranslationCache::createRequest(domainDescription, "", "(define (problem other))");
+    std::string key = TranslationCache::createKey(domainDescription, "", problemDescription);
+    BOOST_REQUIRE(key == PlanCache::getKey(request));
+    BOOST_REQUIRE(key != PlanCache::createKey("LAMA", domainDescription, "", problemDescription));
+
+    std::atomic<int> calls(0);
+    {
+        TranslationCache cache(directory.string(), 1);
+        // Concurrent requests for the same task share a single translation
+        boost::thread_group threads;
+        for(int i = 0; i < 4; ++i)
+        {
+            std::stringstream ss;
+            ss << (workspace / "output.sas").string() << i;
+            threads.create_thread(boost::bind(provide_translation, &cache, request, ss.str(), &calls));
+        }
+        threads.join_all();
+        BOOST_REQUIRE_MESSAGE(calls == 1, "Translator called " << calls << " times");
+        BOOST_REQUIRE(cache.getMisses() == 1);
+        BOOST_REQUIRE(cache.getHits() == 3);
+        BOOST_REQUIRE(fs::file_size(workspace / "output.sas3") == fs::file_size(workspace / "output.sas0"));
+
+        // Capacity is exceeded, so the first entry is evicted
+        BOOST_REQUIRE(cache.provide(otherRequest, (workspace / "other.sas").string(), boost::bind(write_translation, &calls, _1)));
+        BOOST_REQUIRE(cache.size() == 1);
+        cache.provide(request, (workspace / "output.sas").string(), boost::bind(write_translation, &calls, _1));
+        BOOST_REQUIRE(calls == 3);
+    }
+    {
+        // Stored entries are reused
+        TranslationCache cache(directory.string(), 1);
+        BOOST_REQUIRE(cache.size() == 1);
+        BOOST_REQUIRE(cache.provide(request, (workspace / "restored.sas").string(), boost::bind(write_translation, &calls, _1)));
+        BOOST_REQUIRE(calls == 3);
+        BOOST_REQUIRE(cache.getHits() == 1);
+
+        // An entry which belongs to another request with the same key is a miss
+        {
+            std::ofstream out((directory / (key + ".request")).string().c_str(), std::ios::binary);
+            out << otherRequest;
+        }
+        BOOST_REQUIRE(cache.provide(request, (workspace / "collision.sas").string(), boost::bind(write_translation, &calls, _1)));
+        BOOST_REQUIRE(calls == 4);
+        BOOST_REQUIRE(cache.getMisses() == 1);
+        BOOST_REQUIRE(cache.provide(request, (workspace / "collision.sas").string(), boost::bind(write_translation, &calls, _1)));
+        BOOST_REQUIRE(calls == 4);
+        cache.clear();
+        BOOST_REQUIRE(!fs::exists(directory / (key + ".request")));
+        BOOST_REQUIRE(cache.size() == 0);
+    }
+    fs::remove_all(directory);
+    fs::remove_all(workspace);
+
+    Planning planning;
+    planning.enableTranslationCache(directory.string());
+    BOOST_REQUIRE(planning.getTranslationCache());
+    planning.disableTranslationCache();
+    BOOST_REQUIRE(!planning.getTranslationCache());
+    fs::remove_all(directory);
+}
+
+static bool wait_for_idle_workers(size_t workers)
+{
+    for(int i = 0; i < 500 && pddl_planner::ProcessPool::getDefault().getIdleWorkers() != workers; ++i)
+    {
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+    }
+    return pddl_planner::ProcessPool::getDefault().getIdleWorkers() == workers;
+}
+
+/**
+ * Unique temporary directory, which is removed along with its content when this object is
+ * destroyed, i.e. also when a test fails
+ */
+struct TemporaryDirectory
+{
+    TemporaryDirectory(const std::string& model)
+        : path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path(model))
+    {
+        boost::filesystem::create_directories(path);
+    }
+
+    ~TemporaryDirectory()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(path, ec);
+    }
+
+    boost::filesystem::path path;
+};
+
+BOOST_AUTO_TEST_CASE(process_pool_test)
+{
+    using namespace pddl_planner;
+    namespace fs = boost::filesystem;
+
+    ProcessPool& pool = ProcessPool::getDefault();
+    pool.setSize(2);
+    BOOST_REQUIRE_MESSAGE(wait_for_idle_workers(2), "Workers have been forked");
+
+    TemporaryDirectory temporaryDirectory("pddl_planner_process_pool_test_%%%%%%");
+    const fs::path& workspace = temporaryDirectory.path;
+    {
+        std::vector<std::string> arguments = boost::assign::list_of("/bin/sh")("-c")("pwd > cwd.txt; exit 3");
+        Process process(arguments, workspace.string());
+        process.start();
+        BOOST_REQUIRE(process.waitFor(10.0));
+        BOOST_REQUIRE(WIFEXITED(process.getExitStatus()) && WEXITSTATUS(process.getExitStatus()) == 3);
+
+        std::ifstream in((workspace / "cwd.txt").string().c_str());
+        std::string cwd;
+        std::getline(in, cwd);
+        BOOST_REQUIRE_MESSAGE(fs::equivalent(cwd, workspace), cwd);
+    }
+    {
+        std::vector<std::string> arguments = boost::assign::list_of("/bin/true");
+        Process missingDirectory(arguments, (workspace / "missing").string());
+        BOOST_REQUIRE_THROW(missingDirectory.start(), PlanGenerationException);
+
+        Process missingExecutable(std::vector<std::string>(1, "/non-existing-planner"));
+        BOOST_REQUIRE_THROW(missingExecutable.start(), PlanGenerationException);
+    }
+    BOOST_REQUIRE_MESSAGE(wait_for_idle_workers(2), "Workers have been replaced");
+
+    Planning planning;
+    planning.setDomainDescription("rimres", domainDescription);
+    planning.registerPlanner(new ScriptPlanner());
+    planning.enableWarmWorkers(1);
+    BOOST_REQUIRE(wait_for_idle_workers(1));
+    PlanCandidates planCandidates = planning.plan(problemDescription, "SCRIPT");
+    BOOST_REQUIRE(!planCandidates.plans.empty());
+
+    planning.disableWarmWorkers();
+    BOOST_REQUIRE(wait_for_idle_workers(0));
+}
+
+static void count_running(std::atomic<int>* running, std::atomic<int>* maxRunning)
+{
+    int current = ++(*running);
+    int observed = *maxRunning;
+    while(current > observed && !maxRunning->compare_exchange_weak(observed, current))
+    {}
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(20));
+    --(*running);
+}
+
+static void run_nested(pddl_planner::ThreadPool* pool, std::atomic<int>* running, std::atomic<int>* maxRunning)
+{
+    pddl_planner::TaskGroup group(*pool);
+    group.run(boost::bind(count_running, running, maxRunning));
+    group.wait();
+}
+
+static void throw_error()
+{
+    throw std::runtime_error("task failed");
+}
+
+BOOST_AUTO_TEST_CASE(resource_limits_test)
+{
+    using namespace pddl_planner;
+    namespace fs = boost::filesystem;
+
+    CoreAllocator allocator(1);
+    std::vector<int> cores = allocator.getCores();
+    BOOST_REQUIRE(!cores.empty());
+    {
+        // Allocations are disjoint as long as there are enough cores
+        CoreReservation first(allocator);
+        CoreReservation second(allocator);
+        BOOST_REQUIRE_EQUAL(first.getCores().size(), 1);
+        BOOST_REQUIRE_EQUAL(second.getCores().size(), 1);
+        BOOST_REQUIRE(cores.size() == 1 || first.getCores() != second.getCores());
+    }
+    // Released cores are handed out again
+    BOOST_REQUIRE(allocator.acquire().front() == cores.front());
+    allocator.setCoresPerPlanner(0);
+    BOOST_REQUIRE(allocator.acquire().empty());
+
+    TemporaryDirectory temporaryDirectory("pddl_planner_resource_limits_test_%%%%%%");
+    const fs::path& workspace = temporaryDirectory.path;
+
+    ResourceLimits limits;
+    limits.memory = 512 * 1024 * 1024;
+    limits.cpuTime = 1.5;
+    limits.cpus.push_back(cores.back());
+    std::vector<std::string> arguments = boost::assign::list_of("/bin/sh")("-c")("ulimit -v > limits.txt; ulimit -t >> limits.txt; grep Cpus_allowed_list /proc/self/status | cut -f2 >> limits.txt");
+
+    // Limits apply to forked processes as well as to processes started by a worker
+    for(size_t workers = 0; workers < 2; ++workers)
+    {
+        ProcessPool::getDefault().setSize(workers);
+        BOOST_REQUIRE(wait_for_idle_workers(workers));
+
+        Process process(arguments, workspace.string(), limits);
+        process.start();
+        BOOST_REQUIRE(process.waitFor(10.0));
+        BOOST_REQUIRE_EQUAL(process.getExitStatus(), 0);
+
+        std::ifstream in((workspace / "limits.txt").string().c_str());
+        std::string memory, cpuTime, cpus;
+        std::getline(in, memory);
+        std::getline(in, cpuTime);
+        std::getline(in, cpus);
+        BOOST_REQUIRE_EQUAL(memory, "524288");
+        BOOST_REQUIRE_EQUAL(cpuTime, "2");
+        BOOST_REQUIRE_EQUAL(cpus, std::to_string(cores.back()));
+    }
+    ProcessPool::getDefault().setSize(0);
+    BOOST_REQUIRE(wait_for_idle_workers(0));
+
+    Planning planning;
+    planning.setDomainDescription("rimres", domainDescription);
+    planning.registerPlanner(new ScriptPlanner());
+    ResourceLimits plannerLimits;
+    plannerLimits.memory = 2048l * 1024 * 1024;
+    plannerLimits.cpuTime = TIMEOUT;
+    planning.setResourceLimits("SCRIPT", plannerLimits);
+    planning.enableCorePinning();
+    BOOST_REQUIRE(!planning.plan(problemDescription, "SCRIPT").plans.empty());
+    planning.disableCorePinning();
+    BOOST_REQUIRE_THROW(planning.setResourceLimits("UNKNOWN", plannerLimits), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_test)
+{
+    using namespace pddl_planner;
+
+    std::atomic<int> running(0), maxRunning(0);
+    ThreadPool pool(2);
+    {
+        TaskGroup group(pool);
+        for(int i = 0; i < 8; ++i)
+        {
+            group.run(boost::bind(count_running, &running, &maxRunning));
+        }
+        group.wait();
+    }
+    BOOST_REQUIRE_MESSAGE(maxRunning <= 2, "Concurrency limit respected: " << maxRunning);
+
+    // Waiting inside of a worker must not block the pool
+    pool.setConcurrency(1);
+    BOOST_REQUIRE(pool.getConcurrency() == 1);
+    {
+        TaskGroup group(pool);
+        group.run(boost::bind(run_nested, &pool, &running, &maxRunning));
+        group.wait();
+    }
+
+    TaskGroup group(pool);
+    group.run(throw_error);
+    BOOST_REQUIRE_THROW(group.wait(), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_CASE(expression_test)
 {
     using namespace pddl_planner;
@@ -49,8 +1398,158 @@ BOOST_AUTO_TEST_CASE(expression_test)
     Expression notQuantorExpression("not", quantorExpression);
 
     BOOST_REQUIRE_MESSAGE(notQuantorExpression.toLISP() == "(not (exists (?l - location) (and (at sherpa ?l) (at crex ?l))))", notQuantorExpression.toLISP());
+
+    // Copies share their subtrees, but remain independent values
+    Expression copy = notQuantorExpression;
+    BOOST_REQUIRE(copy.parameters.front() == notQuantorExpression.parameters.front());
+    BOOST_REQUIRE(copy == notQuantorExpression);
+    copy.addParameter(andExpr);
+    copy.label = "or";
+    BOOST_REQUIRE_MESSAGE(notQuantorExpression.toLISP() == "(not (exists (?l - location) (and (at sherpa ?l) (at crex ?l))))", notQuantorExpression.toLISP());
+    BOOST_REQUIRE(!(copy == notQuantorExpression));
+    BOOST_REQUIRE(Expression("at","sherpa","?l") == Expression("at","sherpa","?l"));
+    BOOST_REQUIRE(!(Expression("at","sherpa","?l") == Expression("on","sherpa","?l")));
+    BOOST_REQUIRE(!(Expression("at","a","b") == Expression("at","b","a")));
+    BOOST_REQUIRE(!(Expression("at","a","a") == Expression("at","a","b")));
+
+    Expression conjunction("and");
+    conjunction.addParameter(copy.parameters.front());
+    BOOST_REQUIRE_MESSAGE(conjunction.toLISP() == "(and (exists (?l - location) (and (at sherpa ?l) (at crex ?l))))", conjunction.toLISP());
+}
+
+
+BOOST_AUTO_TEST_CASE(domain_index_test)
+{
+    using namespace pddl_planner::representation;
+
+    Domain domain("index");
+    domain.addType("location");
+    for(int i = 0; i < 1000; ++i)
+    {
+        std::stringstream ss;
+        ss << "l" << i;
+        domain.addConstant(Constant(ss.str(), "location"));
+    }
+    domain.addPredicate(Predicate("at", TypedItem("?l","location")));
+
+    BOOST_REQUIRE(domain.isType("location"));
+    BOOST_REQUIRE(domain.isConstant("l0") && domain.isConstant("l999"));
+    BOOST_REQUIRE(!domain.isConstant("l1000"));
+    BOOST_REQUIRE(domain.getPredicate("at").arguments.size() == 1);
+
+    domain.removeConstant("l500");
+    BOOST_REQUIRE(!domain.isConstant("l500"));
+    BOOST_REQUIRE(domain.isConstant("l501"));
+    BOOST_REQUIRE_THROW(domain.addConstant(Constant("l501", "location")), std::invalid_argument);
+
+    // Direct modifications of the lists are picked up as well
+    domain.constants.push_back(Constant("l500", "location"));
+    BOOST_REQUIRE(domain.isConstant("l500"));
+    domain.constants.erase(domain.constants.begin());
+    BOOST_REQUIRE(!domain.isConstant("l0"));
+    domain.constants[1].label = "renamed";
+    BOOST_REQUIRE(domain.isConstant("renamed"));
+    BOOST_REQUIRE(!domain.isConstant("l2"));
+
+    Domain copy = domain;
+    BOOST_REQUIRE(copy.isConstant("l1"));
+    BOOST_REQUIRE_THROW(copy.getPredicate("unknown"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(problem_serialization_test)
+{
+    using namespace pddl_planner::representation;
+
+    Domain domain("rimres");
+    domain.addType("location");
+    domain.addPredicate( Predicate("at", TypedItem("?x","location"),TypedItem("?l","location")) );
+    domain.addPredicate( Predicate("on", TypedItem("?x","location"),TypedItem("?l","location")) );
+
+    Problem problem("incremental", domain);
+    for(size_t i = 0; i < 50; ++i)
+    {
+        std::stringstream ss;
+        ss << "l" << i;
+        problem.addObject(TypedItem(ss.str(), "location"));
+        problem.addInitialStatus(Expression("at", ss.str(), "l0"));
+    }
+    problem.setGoal(Expression("at", "l1", "l2"));
+    std::string initial = problem.toLISP();
+
+    // Facts which differ only by predicate do not count as duplicates
+    problem.addInitialStatus(Expression("on", "l1", "l0"));
+    BOOST_REQUIRE_THROW(problem.addInitialStatus(Expression("on", "l1", "l0")), std::invalid_argument);
+    BOOST_REQUIRE(problem.removeInitialStatus(Expression("at", "l3", "l0")));
+    BOOST_REQUIRE(!problem.removeInitialStatus(Expression("at", "l3", "l0")));
+    BOOST_REQUIRE(initial != problem.toLISP());
+
+    // The incremental result has to match a complete serialization
+    Problem rebuilt("incremental", domain);
+    rebuilt.objects = problem.objects;
+    rebuilt.status = problem.status;
+    rebuilt.goal = problem.goal;
+    BOOST_REQUIRE_EQUAL(problem.toLISP(), rebuilt.toLISP());
+
+    problem.removeInitialStatus(Expression("on", "l1", "l0"));
+    problem.addInitialStatus(Expression("at", "l3", "l0"));
+    BOOST_REQUIRE(problem.toLISP() != initial);
+
+    // Direct modifications are picked up
+    problem.status.pop_back();
+    problem.status.insert(problem.status.begin() + 3, Expression("at", "l3", "l0"));
+    BOOST_REQUIRE_EQUAL(problem.toLISP(), initial);
+
+    // including modifications in place
+    problem.status[0] = Expression("on", "l0", "l1");
+    problem.objects[1].label = "renamed";
+    std::string modified = problem.toLISP();
+    BOOST_REQUIRE(modified.find("(on l0 l1)") != std::string::npos);
+    BOOST_REQUIRE(modified.find("(at l0 l0)") == std::string::npos);
+    BOOST_REQUIRE(modified.find("renamed - location") != std::string::npos);
+    BOOST_REQUIRE(modified.find("l1 - location") == std::string::npos);
+    BOOST_REQUIRE_THROW(problem.addInitialStatus(Expression("on", "l0", "l1")), std::invalid_argument);
+    BOOST_REQUIRE_NO_THROW(problem.addInitialStatus(Expression("at", "l0", "l0")));
+    BOOST_REQUIRE(problem.removeInitialStatus(Expression("on", "l0", "l1")));
+    problem.objects[1].label = "l1";
+    rebuilt.objects = problem.objects;
+    rebuilt.status = problem.status;
+    BOOST_REQUIRE_EQUAL(problem.toLISP(), rebuilt.toLISP());
 }
 
+BOOST_AUTO_TEST_CASE(parser_test)
+{
+    using namespace pddl_planner::representation;
+
+    Domain domain = Parser::parseDomain(domainDescription);
+    BOOST_REQUIRE_EQUAL(domain.name, "rimres");
+    BOOST_REQUIRE(domain.isRequirement("conditional-effects"));
+    BOOST_REQUIRE(domain.isConstant("crex"));
+    BOOST_REQUIRE_EQUAL(domain.getPredicate("connected").arguments.size(), 2);
+    BOOST_REQUIRE_EQUAL(domain.getAction("move").arguments.size(), 3);
+    BOOST_REQUIRE_NO_THROW(domain.validate());
+    // The serialized domain can be parsed again
+    BOOST_REQUIRE_EQUAL(Parser::parseDomain(domain.toLISP()).toLISP(), domain.toLISP());
+
+    Problem problem = Parser::parseProblem(problemDescription, domain);
+    BOOST_REQUIRE_EQUAL(problem.objects.size(), 7);
+    BOOST_REQUIRE_EQUAL(problem.status.size(), 7);
+    BOOST_REQUIRE_EQUAL(problem.goal.toLISP(), "(and (connected sherpa_0 crex_0) (connected sherpa_0 pl_0) (at sherpa_0 mission1))");
+    BOOST_REQUIRE_NO_THROW(problem.validate());
+    BOOST_REQUIRE_EQUAL(Parser::parseProblem(problem.toLISP(), domain).toLISP(), problem.toLISP());
+
+    BOOST_REQUIRE_EQUAL(Expression::fromString("(forall (?x ?y - location) (at ?x ?y))").toLISP(), "(forall (?x - location) (forall (?y - location) (at ?x ?y)))");
+    BOOST_REQUIRE_THROW(Expression::fromString("(at ?x"), std::invalid_argument);
+
+    try {
+        Parser::parseProblem("(define (problem p)\n  (:domain other))", domain);
+        BOOST_FAIL("Domain mismatch not detected");
+    } catch(const ParseError& e)
+    {
+        BOOST_REQUIRE_EQUAL(e.getLine(), 2);
+        BOOST_REQUIRE_EQUAL(e.getColumn(), 12);
+    }
+    BOOST_REQUIRE_THROW(Parser::parseDomain("(define (domain d) (:derived (p) (q)))"), ParseError);
+}
 
 BOOST_AUTO_TEST_CASE(domain_test)
 {